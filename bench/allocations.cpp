@@ -0,0 +1,30 @@
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include "bench.hpp"
+
+// operator new を置き換えて、ベンチマーク中の動的メモリ確保の回数を数える
+
+namespace {
+  std::atomic<std::size_t> count{0};
+} // namespace
+
+std::size_t bench::allocation_count() noexcept {
+  return count.load(std::memory_order_relaxed);
+}
+
+void* operator new(std::size_t n) {
+  count.fetch_add(1, std::memory_order_relaxed);
+  if (void* p = std::malloc(n == 0 ? 1 : n))
+    return p;
+  throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+  std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+  std::free(p);
+}
@@ -0,0 +1,112 @@
+#include <ns/argsort.hpp>
+#include <ns/enumerate_view.hpp>
+#include <ns/permutation.hpp>
+#include <ns/random.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include "bench.hpp"
+
+namespace {
+  constexpr std::uint64_t seed = 0x01234567DEADC0DE;
+
+  std::vector<float> make_keys(std::size_t n) {
+    ns::random::xoshiro256ss gen(seed);
+    std::vector<float> v(n);
+    for (auto& x : v)
+      x = static_cast<float>(ns::random::uniform_below(gen, 1 << 20)) - 1e5f;
+    return v;
+  }
+
+  // begin 添字の整列
+
+  /// @brief enumerate_view の組を std::vector に集めて整列する (従来の方法)
+  void enumerate_pairs(bench::state& st) {
+    const auto v = make_keys(st.arg());
+    for (auto _ : st) {
+      std::vector<std::pair<std::size_t, float>> pairs;
+      pairs.reserve(v.size());
+      for (auto [i, x] : ns::enumerate_view(v))
+        pairs.emplace_back(i, x);
+      std::ranges::sort(pairs, {}, &std::pair<std::size_t, float>::second);
+      std::vector<std::size_t> idx(v.size());
+      for (std::size_t i = 0; i < idx.size(); ++i)
+        idx[i] = pairs[i].first;
+      bench::do_not_optimize(idx.data());
+    }
+    st.set_items_processed(st.iterations() * st.arg());
+  }
+
+  template <class Index>
+  void radix_argsort(bench::state& st) {
+    const auto v = make_keys(st.arg());
+    for (auto _ : st) {
+      auto idx = ns::argsort<Index>(v);
+      bench::do_not_optimize(idx.data());
+    }
+    st.set_items_processed(st.iterations() * st.arg());
+  }
+
+  /// @brief 基数ソートに置き換えられない比較関数 (比較ソートの経路)
+  void comparison_argsort(bench::state& st) {
+    const auto v = make_keys(st.arg());
+    for (auto _ : st) {
+      auto idx = ns::argsort<std::uint32_t>(
+        v, [](float a, float b) { return a < b; });
+      bench::do_not_optimize(idx.data());
+    }
+    st.set_items_processed(st.iterations() * st.arg());
+  }
+
+  void argpartition(bench::state& st) {
+    const auto v = make_keys(st.arg());
+    for (auto _ : st) {
+      auto idx = ns::argpartition<std::uint32_t>(v, v.size() / 100);
+      bench::do_not_optimize(idx.data());
+    }
+    st.set_items_processed(st.iterations() * st.arg());
+  }
+
+  const std::vector<std::size_t> sizes{1 << 12, 1 << 20};
+
+  BENCHMARK("argsort/enumerate_pairs", enumerate_pairs, sizes);
+  BENCHMARK("argsort/radix/size_t", radix_argsort<std::size_t>, sizes);
+  BENCHMARK("argsort/radix/uint32_t", radix_argsort<std::uint32_t>, sizes);
+  BENCHMARK("argsort/comparison/uint32_t", comparison_argsort, sizes);
+  BENCHMARK("argsort/argpartition/uint32_t", argpartition, sizes);
+
+  // end 添字の整列
+
+  // begin 置換の適用
+
+  /// @brief 添字の列で新しい配列に集める
+  void gather_copy(bench::state& st) {
+    auto v = make_keys(st.arg());
+    const auto perm = ns::make_permutation<std::uint32_t>(v.size(), seed, 1);
+    for (auto _ : st) {
+      std::vector<float> w(v.size());
+      for (std::size_t i = 0; i < w.size(); ++i)
+        w[i] = v[perm[i]];
+      v.swap(w);
+      bench::do_not_optimize(v.data());
+    }
+    st.set_items_processed(st.iterations() * st.arg());
+  }
+
+  void apply_permutation(bench::state& st) {
+    auto v = make_keys(st.arg());
+    const auto perm = ns::make_permutation<std::uint32_t>(v.size(), seed, 1);
+    for (auto _ : st) {
+      ns::apply_permutation(perm, v);
+      bench::do_not_optimize(v.data());
+    }
+    st.set_items_processed(st.iterations() * st.arg());
+  }
+
+  BENCHMARK("argsort/apply/gather_copy", gather_copy, sizes);
+  BENCHMARK("argsort/apply/apply_permutation", apply_permutation, sizes);
+
+  // end 置換の適用
+} // namespace
@@ -0,0 +1,147 @@
+/// @file bench.hpp
+/// @brief 外部ライブラリに依存しない小さなマイクロベンチマークハーネス
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace bench {
+  /// @brief プログラム開始からの operator new の呼び出し回数
+  /// @details allocations.cpp で置き換えた operator new が数える。
+  std::size_t allocation_count() noexcept;
+
+  /// @brief value の計算がコンパイラの最適化で取り除かれないようにする
+  template <class T>
+  inline void do_not_optimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+  }
+
+  /// @brief メモリへの書き込みがコンパイラの最適化で取り除かれないようにする
+  inline void clobber_memory() {
+    asm volatile("" : : : "memory");
+  }
+
+  /// @brief 1 回の計測の状態
+  /// @details `for (auto _ : st)` のループ本体のみが計測される。
+  struct state {
+  private:
+    using clock = std::chrono::steady_clock;
+
+    std::size_t iterations_ = 0;
+    std::size_t arg_ = 0;
+    std::size_t items_ = 0;
+    std::map<std::string, double> counters_{};
+    clock::time_point start_{};
+    clock::duration elapsed_{};
+    std::size_t allocations_start_ = 0;
+    std::size_t allocations_ = 0;
+
+  public:
+    struct [[maybe_unused]] value {};
+    struct sentinel {};
+    struct iterator {
+      state* st_ = nullptr;
+      std::size_t remaining_ = 0;
+
+      constexpr value operator*() const noexcept {
+        return {};
+      }
+      constexpr iterator& operator++() noexcept {
+        --remaining_;
+        return *this;
+      }
+      bool operator!=(sentinel) const {
+        if (remaining_ != 0)
+          return true;
+        st_->elapsed_ = clock::now() - st_->start_;
+        st_->allocations_ = allocation_count() - st_->allocations_start_;
+        return false;
+      }
+    };
+
+    state(std::size_t iterations, std::size_t arg)
+      : iterations_(iterations), arg_(arg) {}
+
+    iterator begin() {
+      allocations_start_ = allocation_count();
+      start_ = clock::now();
+      return {this, iterations_};
+    }
+    sentinel end() const noexcept {
+      return {};
+    }
+
+    //! 繰り返し回数
+    std::size_t iterations() const noexcept {
+      return iterations_;
+    }
+    //! ベンチマークの引数 (要素数など)
+    std::size_t arg() const noexcept {
+      return arg_;
+    }
+    //! 計測されたループの経過時間 [s]
+    double elapsed() const noexcept {
+      return std::chrono::duration<double>(elapsed_).count();
+    }
+
+    //! 計測されたループでの operator new の呼び出し回数
+    std::size_t allocations() const noexcept {
+      return allocations_;
+    }
+
+    //! 処理した要素数の合計 (items_per_second の計算に用いる)
+    void set_items_processed(std::size_t n) noexcept {
+      items_ = n;
+    }
+    std::size_t items_processed() const noexcept {
+      return items_;
+    }
+
+    //! 結果に追加で出力する値
+    std::map<std::string, double>& counters() noexcept {
+      return counters_;
+    }
+    const std::map<std::string, double>& counters() const noexcept {
+      return counters_;
+    }
+  };
+
+  struct benchmark {
+    std::string name;
+    std::function<void(state&)> fn;
+    std::size_t arg = 0;
+  };
+
+  inline std::vector<benchmark>& registry() {
+    static std::vector<benchmark> r;
+    return r;
+  }
+
+  /// @brief 静的初期化時にベンチマークを登録する
+  /// @details args が空でなければ、引数ごとに `name/arg` という名前で登録する。
+  struct registrar {
+    registrar(
+      std::string name,
+      std::function<void(state&)> fn,
+      std::vector<std::size_t> args = {}) {
+      if (args.empty()) {
+        registry().push_back({std::move(name), std::move(fn)});
+        return;
+      }
+      for (auto arg : args)
+        registry().push_back({name + "/" + std::to_string(arg), fn, arg});
+    }
+  };
+} // namespace bench
+
+#define BENCH_CAT_IMPL(a, b) a##b
+#define BENCH_CAT(a, b) BENCH_CAT_IMPL(a, b)
+/// @brief BENCHMARK(name, fn[, args]) でベンチマークを登録する
+#define BENCHMARK(...)                                                  \
+  static const ::bench::registrar BENCH_CAT(bench_registrar_, __LINE__) { \
+    __VA_ARGS__                                                         \
+  }
@@ -0,0 +1,97 @@
+#include <ns/concurrent_enumerate.hpp>
+#include <ns/random.hpp>
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <ranges>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "bench.hpp"
+
+namespace {
+  constexpr std::uint64_t seed = 0x01234567DEADC0DE;
+
+  /// @brief 空白区切りの n 個の整数
+  std::string make_input(std::size_t n) {
+    ns::random::xoshiro256ss gen(seed);
+    std::string s;
+    for (std::size_t i = 0; i < n; ++i)
+      s += std::to_string(ns::random::uniform_below(gen, 1 << 30)) + ' ';
+    return s;
+  }
+
+  /// @brief 字句の解析と、それに続く要素ごとの仕事
+  std::uint64_t parse(std::size_t i, const std::string& token) {
+    std::uint64_t x = 0;
+    std::from_chars(token.data(), token.data() + token.size(), x);
+    for (int r = 0; r < 16; ++r)
+      x = x * 0x9E3779B97F4A7C15 + i;
+    return x;
+  }
+
+  // begin 入力範囲の並列な消費
+
+  /// @brief 1 本のスレッドで読み出しと解析を行う (比較対象)
+  void serial(bench::state& st) {
+    const auto input = make_input(st.arg());
+    for (auto _ : st) {
+      std::istringstream is(input);
+      std::uint64_t acc = 0;
+      std::size_t i = 0;
+      for (const auto& token : std::views::istream<std::string>(is))
+        acc += parse(i++, token);
+      bench::do_not_optimize(acc);
+    }
+    st.set_items_processed(st.iterations() * st.arg());
+  }
+
+  /// @brief 字句の読み出しのみをロックの下で行い、解析は各スレッドで行う
+  void concurrent(bench::state& st, unsigned threads) {
+    const auto input = make_input(st.arg());
+    for (auto _ : st) {
+      std::istringstream is(input);
+      ns::concurrent_enumerate source(std::views::istream<std::string>(is));
+      std::atomic<std::uint64_t> acc = 0;
+      auto work = [&] {
+        std::uint64_t local = 0;
+        source.for_each(
+          [&](std::size_t i, const std::string& token) {
+            local += parse(i, token);
+          },
+          256);
+        acc.fetch_add(local);
+      };
+      std::vector<std::thread> workers;
+      for (unsigned t = 1; t < threads; ++t)
+        workers.emplace_back(work);
+      work();
+      for (auto& w : workers)
+        w.join();
+      bench::do_not_optimize(acc.load());
+    }
+    st.set_items_processed(st.iterations() * st.arg());
+    st.counters()["threads"] = threads;
+  }
+
+  const bool registered = [] {
+    const std::vector<std::size_t> sizes{1 << 16, 1 << 20};
+    bench::registrar("concurrent_enumerate/serial", serial, sizes);
+    // 1 スレッドから hardware_concurrency まで倍々に増やす
+    const unsigned hc = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned t = 1;; t = std::min(2 * t, hc)) {
+      bench::registrar(
+        "concurrent_enumerate/concurrent/threads:" + std::to_string(t),
+        [t](bench::state& st) { concurrent(st, t); },
+        sizes);
+      if (t == hc)
+        break;
+    }
+    return true;
+  }();
+
+  // end 入力範囲の並列な消費
+} // namespace
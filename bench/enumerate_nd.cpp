@@ -0,0 +1,118 @@
+#include <ns/enumerate_nd.hpp>
+#include <ns/random.hpp>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "bench.hpp"
+
+namespace {
+  constexpr std::uint64_t seed = 0x01234567DEADC0DE;
+
+  using index2 = std::array<std::size_t, 2>;
+
+  /// @brief n × n の格子 (行優先)
+  std::vector<std::uint32_t> make_grid(std::size_t n) {
+    ns::random::xoshiro256ss gen(seed);
+    std::vector<std::uint32_t> v(n * n);
+    for (auto& x : v)
+      x = static_cast<std::uint32_t>(ns::random::uniform_below(gen, 1 << 16));
+    return v;
+  }
+
+  // begin 添字を用いる走査
+
+  std::uint64_t weight(std::size_t i, std::size_t j, std::uint32_t x) {
+    return (i ^ j) * x;
+  }
+
+  /// @brief 通し番号を除算で添字に戻す
+  void weighted_divmod(bench::state& st) {
+    const auto n = st.arg();
+    const auto v = make_grid(n);
+    for (auto _ : st) {
+      std::uint64_t acc = 0;
+      for (std::size_t k = 0; k < v.size(); ++k)
+        acc += weight(k / n, k % n, v[k]);
+      bench::do_not_optimize(acc);
+    }
+    st.set_items_processed(st.iterations() * n * n);
+  }
+
+  void weighted_nested(bench::state& st) {
+    const auto n = st.arg();
+    const auto v = make_grid(n);
+    for (auto _ : st) {
+      std::uint64_t acc = 0;
+      for (std::size_t i = 0; i < n; ++i)
+        for (std::size_t j = 0; j < n; ++j)
+          acc += weight(i, j, v[i * n + j]);
+      bench::do_not_optimize(acc);
+    }
+    st.set_items_processed(st.iterations() * n * n);
+  }
+
+  void weighted_enumerate_nd(bench::state& st) {
+    const auto n = st.arg();
+    const auto v = make_grid(n);
+    for (auto _ : st) {
+      std::uint64_t acc = 0;
+      for (auto [index, x] : ns::enumerate_nd(v, index2{n, n}))
+        acc += weight(index[0], index[1], x);
+      bench::do_not_optimize(acc);
+    }
+    st.set_items_processed(st.iterations() * n * n);
+  }
+
+  // end 添字を用いる走査
+
+  // begin 転置 (書き込みが列方向に進む)
+
+  void transpose_nested(bench::state& st) {
+    const auto n = st.arg();
+    const auto v = make_grid(n);
+    std::vector<std::uint32_t> out(n * n);
+    for (auto _ : st) {
+      for (std::size_t i = 0; i < n; ++i)
+        for (std::size_t j = 0; j < n; ++j)
+          out[j * n + i] = v[i * n + j];
+      bench::clobber_memory();
+    }
+    st.set_items_processed(st.iterations() * n * n);
+  }
+
+  template <class Order>
+  void transpose(bench::state& st, Order order) {
+    const auto n = st.arg();
+    const auto v = make_grid(n);
+    std::vector<std::uint32_t> out(n * n);
+    for (auto _ : st) {
+      for (auto [index, x] : ns::enumerate_nd(v, index2{n, n}, order))
+        out[index[1] * n + index[0]] = x;
+      bench::clobber_memory();
+    }
+    st.set_items_processed(st.iterations() * n * n);
+  }
+
+  void transpose_row_major(bench::state& st) {
+    transpose(st, ns::nd_row_major{});
+  }
+  void transpose_tiled(bench::state& st) {
+    transpose(st, ns::nd_tiled{16, 16});
+  }
+  void transpose_morton(bench::state& st) {
+    transpose(st, ns::nd_morton{16, 16});
+  }
+
+  // end 転置 (書き込みが列方向に進む)
+
+  const std::vector<std::size_t> sizes{1 << 8, 1 << 12};
+
+  BENCHMARK("enumerate_nd/weighted/divmod", weighted_divmod, sizes);
+  BENCHMARK("enumerate_nd/weighted/nested", weighted_nested, sizes);
+  BENCHMARK("enumerate_nd/weighted/enumerate_nd", weighted_enumerate_nd, sizes);
+  BENCHMARK("enumerate_nd/transpose/nested", transpose_nested, sizes);
+  BENCHMARK("enumerate_nd/transpose/row_major", transpose_row_major, sizes);
+  BENCHMARK("enumerate_nd/transpose/tiled", transpose_tiled, sizes);
+  BENCHMARK("enumerate_nd/transpose/morton", transpose_morton, sizes);
+} // namespace
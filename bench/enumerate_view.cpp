@@ -0,0 +1,419 @@
+#include <ns/enumerate_view.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <forward_list>
+#include <list>
+#include <ranges>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+#include "bench.hpp"
+
+namespace {
+  // begin 入力専用の view (draft/enumerate_view/assertions.cpp と同じイテレータ)
+
+  template <class T>
+  struct test_cpp20_input_iterator {
+  private:
+    T* ptr_ = nullptr;
+
+  public:
+    using difference_type = std::ptrdiff_t;
+    using value_type = std::remove_cv_t<T>;
+    using iterator_concept = std::input_iterator_tag;
+    test_cpp20_input_iterator() = default;
+    constexpr explicit test_cpp20_input_iterator(T* ptr)
+      : ptr_(std::move(ptr)) {}
+    constexpr decltype(auto) operator*() const {
+      return *ptr_;
+    }
+    constexpr test_cpp20_input_iterator& operator++() {
+      ++ptr_;
+      return *this;
+    }
+    constexpr void operator++(int) {
+      ++ptr_;
+    }
+    constexpr bool operator==(const test_cpp20_input_iterator& other) const {
+      return ptr_ == other.ptr_;
+    }
+  };
+
+  template <class T>
+  struct input_view : std::ranges::view_base {
+  private:
+    T* first_ = nullptr;
+    T* last_ = nullptr;
+
+  public:
+    input_view() = default;
+    constexpr input_view(T* first, T* last) : first_(first), last_(last) {}
+    constexpr auto begin() const {
+      return test_cpp20_input_iterator<T>(first_);
+    }
+    constexpr auto end() const {
+      return test_cpp20_input_iterator<T>(last_);
+    }
+  };
+
+  static_assert(std::ranges::input_range<input_view<int>>);
+  static_assert(not std::ranges::forward_range<input_view<int>>);
+
+  // end 入力専用の view
+
+  // begin 計測するループ
+
+  // 各ループは sum(i * x) を計算する
+
+  struct raw_loop {
+    template <class R>
+    std::size_t operator()(R&& r) const {
+      std::size_t acc = 0;
+      if constexpr (
+        std::ranges::random_access_range<R> and std::ranges::sized_range<R>) {
+        const auto n = std::ranges::size(r);
+        for (std::size_t i = 0; i < n; ++i)
+          acc += i * static_cast<std::size_t>(r[i]);
+      } else {
+        std::size_t i = 0;
+        for (auto&& x : r)
+          acc += i++ * static_cast<std::size_t>(x);
+      }
+      return acc;
+    }
+  };
+
+  struct ns_enumerate {
+    template <class R>
+    std::size_t operator()(R&& r) const {
+      std::size_t acc = 0;
+      for (auto [i, x] : ns::enumerate_view(r))
+        acc += i * static_cast<std::size_t>(x);
+      return acc;
+    }
+  };
+
+#if defined(__cpp_lib_ranges_zip)
+  struct std_zip_iota {
+    template <class R>
+    std::size_t operator()(R&& r) const {
+      std::size_t acc = 0;
+      for (auto [i, x] : std::views::zip(std::views::iota(std::size_t(0)), r))
+        acc += i * static_cast<std::size_t>(x);
+      return acc;
+    }
+  };
+#endif
+
+#if defined(__cpp_lib_ranges_enumerate)
+  struct std_enumerate {
+    template <class R>
+    std::size_t operator()(R&& r) const {
+      std::size_t acc = 0;
+      for (auto [i, x] : std::views::enumerate(r))
+        acc += static_cast<std::size_t>(i) * static_cast<std::size_t>(x);
+      return acc;
+    }
+  };
+#endif
+
+  // end 計測するループ
+
+  // begin 元となる範囲
+
+  template <class Container>
+  Container make_container(std::size_t n) {
+    std::vector<int> values(n);
+    for (std::size_t i = 0; i < n; ++i)
+      values[i] = static_cast<int>(i % 7);
+    return Container(values.begin(), values.end());
+  }
+
+  constexpr auto is_even = [](int x) { return x % 2 == 0; };
+
+  /// @brief 元となる範囲を make(n) で作り、その上で loop を計測する
+  template <class Make, class Loop>
+  void register_case(
+    std::string base_name,
+    std::string loop_name,
+    Make make,
+    Loop loop,
+    std::vector<std::size_t> sizes) {
+    bench::registrar(
+      "enumerate_view/" + base_name + "/" + loop_name,
+      [make, loop](bench::state& st) {
+        auto storage = make(st.arg());
+        auto&& r = storage.range();
+        for (auto _ : st)
+          bench::do_not_optimize(loop(r));
+        st.set_items_processed(st.iterations() * st.arg());
+      },
+      std::move(sizes));
+  }
+
+  template <class Container>
+  struct container_storage {
+    Container c;
+    Container& range() {
+      return c;
+    }
+  };
+
+  struct filter_storage {
+    std::vector<int> v;
+    auto range() {
+      return v | std::views::filter(is_even);
+    }
+  };
+
+  struct input_storage {
+    std::vector<int> v;
+    auto range() {
+      return input_view<int>(v.data(), v.data() + v.size());
+    }
+  };
+
+  template <class Make>
+  void register_base(
+    std::string base_name,
+    Make make,
+    std::vector<std::size_t> sizes) {
+    register_case(base_name, "raw", make, raw_loop{}, sizes);
+    register_case(base_name, "ns_enumerate", make, ns_enumerate{}, sizes);
+#if defined(__cpp_lib_ranges_zip)
+    register_case(base_name, "std_zip_iota", make, std_zip_iota{}, sizes);
+#endif
+#if defined(__cpp_lib_ranges_enumerate)
+    register_case(base_name, "std_enumerate", make, std_enumerate{}, sizes);
+#endif
+  }
+
+  // end 元となる範囲
+
+  const bool registered = [] {
+    const std::vector<std::size_t> sizes{1 << 10, 1 << 20};
+    register_base(
+      "vector",
+      [](std::size_t n) {
+        return container_storage<std::vector<int>>{
+          make_container<std::vector<int>>(n)};
+      },
+      sizes);
+    register_base(
+      "list",
+      [](std::size_t n) {
+        return container_storage<std::list<int>>{
+          make_container<std::list<int>>(n)};
+      },
+      sizes);
+    register_base(
+      "forward_list",
+      [](std::size_t n) {
+        return container_storage<std::forward_list<int>>{
+          make_container<std::forward_list<int>>(n)};
+      },
+      sizes);
+    register_base(
+      "filter_view",
+      [](std::size_t n) {
+        return filter_storage{make_container<std::vector<int>>(n)};
+      },
+      sizes);
+    register_base(
+      "input_range",
+      [](std::size_t n) {
+        return input_storage{make_container<std::vector<int>>(n)};
+      },
+      sizes);
+    return true;
+  }();
+
+  // begin 添字の型によるメモリ使用量
+
+  /// @brief (index, float) の組を std::vector に集めたときの時間と大きさ
+  template <class Index>
+  void collect_pairs(bench::state& st) {
+    std::vector<float> v(st.arg(), 1.0f);
+    ns::enumerate_view ev(v, Index{0});
+    using pair_type = std::ranges::range_value_t<decltype(ev)>;
+    for (auto _ : st) {
+      std::vector<pair_type> pairs(ev.begin(), ev.end());
+      bench::do_not_optimize(pairs.data());
+      bench::clobber_memory();
+    }
+    st.set_items_processed(st.iterations() * st.arg());
+    st.counters()["bytes"] = static_cast<double>(sizeof(pair_type) * st.arg());
+  }
+
+  BENCHMARK(
+    "enumerate_view/collect/uint32_t",
+    collect_pairs<std::uint32_t>,
+    {1 << 20});
+  BENCHMARK(
+    "enumerate_view/collect/size_t",
+    collect_pairs<std::size_t>,
+    {1 << 20});
+
+  // end 添字の型によるメモリ使用量
+
+  // begin 位置による重み付け
+
+  /// @brief 要素ごとの組を走査する
+  void weight_pairs(bench::state& st) {
+    std::vector<float> v(st.arg(), 1.0f);
+    for (auto _ : st) {
+      for (auto [i, x] : ns::enumerate_view(v))
+        x *= static_cast<float>(i) * 0.5f;
+      bench::do_not_optimize(v.data());
+      bench::clobber_memory();
+    }
+    st.set_items_processed(st.iterations() * st.arg());
+  }
+
+  void weight_batches(bench::state& st) {
+    std::vector<float> v(st.arg(), 1.0f);
+    for (auto _ : st) {
+      for (auto [first, s] : ns::enumerate_view(v).batches(256)) {
+        const float base = static_cast<float>(first);
+        const int len = static_cast<int>(s.size());
+        for (int k = 0; k < len; ++k)
+          s[static_cast<std::size_t>(k)] *=
+            (base + static_cast<float>(k)) * 0.5f;
+      }
+      bench::do_not_optimize(v.data());
+      bench::clobber_memory();
+    }
+    st.set_items_processed(st.iterations() * st.arg());
+  }
+
+  template <class Container, std::size_t N>
+  void weight_for_each_batch(bench::state& st) {
+    Container v(st.arg(), 1.0f);
+    for (auto _ : st) {
+      ns::for_each_batch<N>(
+        ns::enumerate_view(v),
+        [](std::size_t first, std::span<float, N> s) {
+          // 64 ビット整数から float への変換はベクトル化できないため、
+          // インデックスの変換はブロックごとに 1 回とし、ブロック内は int で
+          // 数える
+          const float base = static_cast<float>(first);
+          for (int k = 0; k < int(N); ++k)
+            s[static_cast<std::size_t>(k)] *=
+            (base + static_cast<float>(k)) * 0.5f;
+        },
+        [](std::size_t i, float& x) { x *= static_cast<float>(i) * 0.5f; });
+      bench::do_not_optimize(&*v.begin());
+      bench::clobber_memory();
+    }
+    st.set_items_processed(st.iterations() * st.arg());
+  }
+
+  /// @brief 連続していない範囲の要素ごとの組 (作業領域を介す場合との比較)
+  /// @details 作業領域を介す場合は、ブロックを小さくした方が速い。
+  void weight_pairs_deque(bench::state& st) {
+    std::deque<float> v(st.arg(), 1.0f);
+    for (auto _ : st) {
+      for (auto [i, x] : ns::enumerate_view(v))
+        x *= static_cast<float>(i) * 0.5f;
+      bench::do_not_optimize(&v.front());
+      bench::clobber_memory();
+    }
+    st.set_items_processed(st.iterations() * st.arg());
+  }
+
+  const std::vector<std::size_t> weight_sizes{1 << 10, 1 << 20};
+
+  BENCHMARK("enumerate_view/weight/pairs", weight_pairs, weight_sizes);
+  BENCHMARK("enumerate_view/weight/batches", weight_batches, weight_sizes);
+  BENCHMARK(
+    "enumerate_view/weight/for_each_batch",
+    weight_for_each_batch<std::vector<float>, 64>,
+    weight_sizes);
+  BENCHMARK(
+    "enumerate_view/weight/pairs/deque", weight_pairs_deque, weight_sizes);
+  BENCHMARK(
+    "enumerate_view/weight/for_each_batch/deque",
+    weight_for_each_batch<std::deque<float>, 16>,
+    weight_sizes);
+
+  // end 位置による重み付け
+
+  // begin 手書きの添字ループとの比較
+
+  // 連続した範囲の上のループが、手書きの添字による for と同じ機械語に
+  // なるかを比べる。イテレータは元となるイテレータと親の view へのポインタ
+  // のみをもち、進めるときは元となるイテレータのみを更新する。
+
+  void codegen_raw(bench::state& st) {
+    std::vector<std::uint32_t> v(st.arg(), 1);
+    for (auto _ : st) {
+      const auto n = static_cast<std::uint32_t>(v.size());
+      for (std::uint32_t i = 0; i < n; ++i)
+        v[i] += i;
+      bench::do_not_optimize(v.data());
+      bench::clobber_memory();
+    }
+    st.set_items_processed(st.iterations() * st.arg());
+  }
+
+  void codegen_ns_enumerate(bench::state& st) {
+    std::vector<std::uint32_t> v(st.arg(), 1);
+    for (auto _ : st) {
+      for (auto [i, x] : ns::enumerate_view(v, std::uint32_t{0}))
+        x += i;
+      bench::do_not_optimize(v.data());
+      bench::clobber_memory();
+    }
+    st.set_items_processed(st.iterations() * st.arg());
+  }
+
+  /// @brief イテレータを値で受け渡すアルゴリズム (二分探索) での比較
+  void codegen_lower_bound_raw(bench::state& st) {
+    std::vector<std::uint32_t> v(st.arg());
+    for (std::size_t i = 0; i < v.size(); ++i)
+      v[i] = static_cast<std::uint32_t>(2 * i);
+    std::uint32_t key = 0;
+    for (auto _ : st) {
+      const auto it = std::ranges::lower_bound(v, key);
+      bench::do_not_optimize(it - v.begin());
+      key = (key + 7919) % static_cast<std::uint32_t>(2 * v.size());
+    }
+    st.set_items_processed(st.iterations());
+  }
+
+  void codegen_lower_bound_ns_enumerate(bench::state& st) {
+    std::vector<std::uint32_t> v(st.arg());
+    for (std::size_t i = 0; i < v.size(); ++i)
+      v[i] = static_cast<std::uint32_t>(2 * i);
+    ns::enumerate_view ev(v);
+    std::uint32_t key = 0;
+    for (auto _ : st) {
+      const auto it = std::ranges::lower_bound(
+        ev, key, {}, [](const auto& p) { return p.second; });
+      bench::do_not_optimize(it == ev.end() ? 0 : std::get<0>(*it));
+      key = (key + 7919) % static_cast<std::uint32_t>(2 * v.size());
+    }
+    st.set_items_processed(st.iterations());
+  }
+
+  const std::vector<std::size_t> codegen_sizes{1 << 10, 1 << 20};
+
+  BENCHMARK("enumerate_view/codegen/raw", codegen_raw, codegen_sizes);
+  BENCHMARK(
+    "enumerate_view/codegen/ns_enumerate",
+    codegen_ns_enumerate,
+    codegen_sizes);
+  BENCHMARK(
+    "enumerate_view/codegen/lower_bound/raw",
+    codegen_lower_bound_raw,
+    codegen_sizes);
+  BENCHMARK(
+    "enumerate_view/codegen/lower_bound/ns_enumerate",
+    codegen_lower_bound_ns_enumerate,
+    codegen_sizes);
+
+  // end 手書きの添字ループとの比較
+} // namespace
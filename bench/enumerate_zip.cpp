@@ -0,0 +1,106 @@
+#include <ns/enumerate_view.hpp>
+#include <ns/enumerate_zip.hpp>
+#include <ns/random.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <ranges>
+#include <tuple>
+#include <vector>
+#include "bench.hpp"
+
+namespace {
+  constexpr std::uint64_t seed = 0x01234567DEADC0DE;
+
+  /// @brief 同じ長さの 3 つの列
+  struct columns {
+    std::vector<float> price;
+    std::vector<float> quantity;
+    std::vector<std::int32_t> category;
+
+    explicit columns(std::size_t n) : price(n), quantity(n), category(n) {
+      ns::random::xoshiro256ss gen(seed);
+      for (std::size_t i = 0; i < n; ++i) {
+        price[i] = static_cast<float>(ns::random::uniform_below(gen, 1000));
+        quantity[i] = static_cast<float>(ns::random::uniform_below(gen, 10));
+        category[i] =
+          static_cast<std::int32_t>(ns::random::uniform_below(gen, 4));
+      }
+    }
+  };
+
+  // begin 列と行番号の同時走査
+
+  /// @brief category が 0 の行の、行番号で割り引いた売上の和
+  float discounted(std::size_t i, float price, float quantity) {
+    return price * quantity / static_cast<float>(i + 1);
+  }
+
+  /// @brief 1 つの列を enumerate_view で走査し、他の列は行番号で参照する
+  void revenue_enumerate_view(bench::state& st) {
+    columns c(st.arg());
+    for (auto _ : st) {
+      float acc = 0;
+      for (auto [i, category] : ns::enumerate_view(c.category))
+        if (category == 0)
+          acc += discounted(i, c.price[i], c.quantity[i]);
+      bench::do_not_optimize(acc);
+    }
+    st.set_items_processed(st.iterations() * st.arg());
+  }
+
+#if defined(__cpp_lib_ranges_zip)
+  void revenue_zip_enumerate(bench::state& st) {
+    columns c(st.arg());
+    for (auto _ : st) {
+      float acc = 0;
+      for (auto [i, row] : ns::enumerate_view(
+             std::views::zip(c.price, c.quantity, c.category))) {
+        auto [price, quantity, category] = row;
+        if (category == 0)
+          acc += discounted(i, price, quantity);
+      }
+      bench::do_not_optimize(acc);
+    }
+    st.set_items_processed(st.iterations() * st.arg());
+  }
+#endif
+
+  void revenue_enumerate_zip(bench::state& st) {
+    columns c(st.arg());
+    for (auto _ : st) {
+      float acc = 0;
+      for (auto [i, price, quantity, category] :
+           ns::enumerate_zip(c.price, c.quantity, c.category))
+        if (category == 0)
+          acc += discounted(i, price, quantity);
+      bench::do_not_optimize(acc);
+    }
+    st.set_items_processed(st.iterations() * st.arg());
+  }
+
+  void revenue_loop(bench::state& st) {
+    columns c(st.arg());
+    for (auto _ : st) {
+      float acc = 0;
+      for (std::size_t i = 0; i < c.price.size(); ++i)
+        if (c.category[i] == 0)
+          acc += discounted(i, c.price[i], c.quantity[i]);
+      bench::do_not_optimize(acc);
+    }
+    st.set_items_processed(st.iterations() * st.arg());
+  }
+
+  // end 列と行番号の同時走査
+
+  const std::vector<std::size_t> sizes{1 << 10, 1 << 20};
+
+  BENCHMARK(
+    "enumerate_zip/revenue/enumerate_view", revenue_enumerate_view, sizes);
+#if defined(__cpp_lib_ranges_zip)
+  BENCHMARK(
+    "enumerate_zip/revenue/zip_enumerate", revenue_zip_enumerate, sizes);
+#endif
+  BENCHMARK(
+    "enumerate_zip/revenue/enumerate_zip", revenue_enumerate_zip, sizes);
+  BENCHMARK("enumerate_zip/revenue/loop", revenue_loop, sizes);
+} // namespace
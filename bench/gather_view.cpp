@@ -0,0 +1,115 @@
+#include <ns/gather_view.hpp>
+#include <ns/index_search.hpp>
+#include <ns/random.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "bench.hpp"
+
+namespace {
+  constexpr std::uint64_t seed = 0x01234567DEADC0DE;
+
+  //! 読み出す要素数
+  constexpr std::size_t count = 1 << 20;
+
+  /// @brief n 個の要素と、それを無作為な順に指す count 個の添字
+  struct gather_input {
+    std::vector<float> data;
+    std::vector<std::uint32_t> indices;
+
+    explicit gather_input(std::size_t n) : data(n), indices(count) {
+      ns::random::xoshiro256ss gen(seed);
+      for (auto& x : data)
+        x = static_cast<float>(ns::random::uniform_below(gen, 1000));
+      for (auto& i : indices)
+        i = static_cast<std::uint32_t>(ns::random::uniform_below(gen, n));
+    }
+  };
+
+  // begin 書き出し
+
+  void copy_loop(bench::state& st) {
+    const gather_input in(st.arg());
+    std::vector<float> out(count);
+    for (auto _ : st) {
+      for (std::size_t i = 0; i < count; ++i)
+        out[i] = in.data[in.indices[i]];
+      bench::do_not_optimize(out.data());
+      bench::clobber_memory();
+    }
+    st.set_items_processed(st.iterations() * count);
+  }
+
+  void copy_view(bench::state& st, std::size_t distance) {
+    const gather_input in(st.arg());
+    std::vector<float> out(count);
+    for (auto _ : st) {
+      std::ranges::copy(
+        ns::gather_view(in.data, in.indices, distance), out.begin());
+      bench::do_not_optimize(out.data());
+      bench::clobber_memory();
+    }
+    st.set_items_processed(st.iterations() * count);
+  }
+  void copy_view_no_prefetch(bench::state& st) {
+    copy_view(st, 0);
+  }
+  void copy_view_prefetch(bench::state& st) {
+    copy_view(st, ns::simd::gather_distance);
+  }
+
+  void gather_into(bench::state& st, ns::simd::level l) {
+    const gather_input in(st.arg());
+    std::vector<float> out(count);
+    for (auto _ : st) {
+      ns::simd::gather(
+        l, in.data.data(), in.indices.data(), count, out.data());
+      bench::do_not_optimize(out.data());
+      bench::clobber_memory();
+    }
+    st.set_items_processed(st.iterations() * count);
+  }
+  void gather_into_scalar(bench::state& st) {
+    gather_into(st, ns::simd::level::scalar);
+  }
+  void gather_into_detected(bench::state& st) {
+    gather_into(st, ns::simd::detected_level());
+  }
+
+  // end 書き出し
+
+  // begin 読み出しながらの計算
+
+  /// @brief 要素ごとの計算が読み出しと重なるよう、値に依存する分岐を含む
+  void sum_view(bench::state& st, std::size_t distance) {
+    const gather_input in(st.arg());
+    for (auto _ : st) {
+      float acc = 0;
+      for (float x : ns::gather_view(in.data, in.indices, distance))
+        acc += x < 500.0f ? x : 0.5f * x;
+      bench::do_not_optimize(acc);
+    }
+    st.set_items_processed(st.iterations() * count);
+  }
+  void sum_view_no_prefetch(bench::state& st) {
+    sum_view(st, 0);
+  }
+  void sum_view_prefetch(bench::state& st) {
+    sum_view(st, ns::simd::gather_distance);
+  }
+
+  // end 読み出しながらの計算
+
+  //! L2 に収まる大きさと、収まらない大きさ
+  const std::vector<std::size_t> sizes{1 << 16, 1 << 24};
+
+  BENCHMARK("gather_view/copy/loop", copy_loop, sizes);
+  BENCHMARK("gather_view/copy/view_no_prefetch", copy_view_no_prefetch, sizes);
+  BENCHMARK("gather_view/copy/view_prefetch", copy_view_prefetch, sizes);
+  BENCHMARK("gather_view/copy/gather_into_scalar", gather_into_scalar, sizes);
+  BENCHMARK(
+    "gather_view/copy/gather_into_detected", gather_into_detected, sizes);
+  BENCHMARK("gather_view/sum/view_no_prefetch", sum_view_no_prefetch, sizes);
+  BENCHMARK("gather_view/sum/view_prefetch", sum_view_prefetch, sizes);
+} // namespace
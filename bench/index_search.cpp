@@ -0,0 +1,125 @@
+#include <ns/enumerate_view.hpp>
+#include <ns/index_search.hpp>
+#include <ns/random.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "bench.hpp"
+
+namespace {
+  constexpr std::uint64_t seed = 0x01234567DEADC0DE;
+
+  template <class T>
+  std::vector<T> make_values(std::size_t n) {
+    ns::random::xoshiro256ss gen(seed);
+    std::vector<T> v(n);
+    for (auto& x : v)
+      x = static_cast<T>(ns::random::uniform_below(gen, 1 << 20));
+    return v;
+  }
+
+  // begin 添字を返す探索
+
+  /// @brief enumerate_view の組を 1 つずつ std::max_element で比べる
+  template <class T>
+  void max_element_pairs(bench::state& st) {
+    const auto v = make_values<T>(st.arg());
+    for (auto _ : st) {
+      auto e = ns::enumerate_view(v);
+      const auto it =
+        std::max_element(e.begin(), e.end(), [](const auto& a, const auto& b) {
+          return a.second < b.second;
+        });
+      bench::do_not_optimize((*it).first);
+    }
+    st.set_items_processed(st.iterations() * st.arg());
+  }
+
+  template <class T>
+  void argmax(bench::state& st) {
+    const auto v = make_values<T>(st.arg());
+    for (auto _ : st)
+      bench::do_not_optimize(*ns::argmax(ns::enumerate_view(v)));
+    st.set_items_processed(st.iterations() * st.arg());
+  }
+
+  /// @brief 一致する要素のない探索 (全体を走査する)
+  template <class T>
+  void find_if_pairs(bench::state& st) {
+    const auto v = make_values<T>(st.arg());
+    for (auto _ : st) {
+      auto e = ns::enumerate_view(v);
+      std::size_t found = v.size();
+      for (auto [i, x] : e) {
+        if (x < T(0)) {
+          found = i;
+          break;
+        }
+      }
+      bench::do_not_optimize(found);
+    }
+    st.set_items_processed(st.iterations() * st.arg());
+  }
+
+  template <class T>
+  void find_index(bench::state& st) {
+    const auto v = make_values<T>(st.arg());
+    for (auto _ : st)
+      bench::do_not_optimize(
+        ns::find_index(ns::enumerate_view(v), ns::less_than(T(0)))
+          .has_value());
+    st.set_items_processed(st.iterations() * st.arg());
+  }
+
+  template <class T>
+  void count_if_pairs(bench::state& st) {
+    const auto v = make_values<T>(st.arg());
+    const T threshold = T(1 << 19);
+    for (auto _ : st) {
+      std::size_t count = 0;
+      for (auto [i, x] : ns::enumerate_view(v))
+        count += x < threshold ? 1 : 0;
+      bench::do_not_optimize(count);
+    }
+    st.set_items_processed(st.iterations() * st.arg());
+  }
+
+  template <class T>
+  void count_if(bench::state& st) {
+    const auto v = make_values<T>(st.arg());
+    const T threshold = T(1 << 19);
+    for (auto _ : st)
+      bench::do_not_optimize(
+        ns::count_if(ns::enumerate_view(v), ns::less_than(threshold)));
+    st.set_items_processed(st.iterations() * st.arg());
+  }
+
+  const std::vector<std::size_t> sizes{1 << 12, 1 << 20};
+
+  BENCHMARK("index_search/argmax/pairs/float", max_element_pairs<float>, sizes);
+  BENCHMARK("index_search/argmax/simd/float", argmax<float>, sizes);
+  BENCHMARK(
+    "index_search/argmax/pairs/double", max_element_pairs<double>, sizes);
+  BENCHMARK("index_search/argmax/simd/double", argmax<double>, sizes);
+  BENCHMARK(
+    "index_search/argmax/pairs/int32_t",
+    max_element_pairs<std::int32_t>,
+    sizes);
+  BENCHMARK("index_search/argmax/simd/int32_t", argmax<std::int32_t>, sizes);
+
+  BENCHMARK("index_search/find_index/pairs/float", find_if_pairs<float>, sizes);
+  BENCHMARK("index_search/find_index/simd/float", find_index<float>, sizes);
+  BENCHMARK(
+    "index_search/find_index/pairs/int32_t",
+    find_if_pairs<std::int32_t>,
+    sizes);
+  BENCHMARK(
+    "index_search/find_index/simd/int32_t", find_index<std::int32_t>, sizes);
+
+  BENCHMARK(
+    "index_search/count_if/pairs/double", count_if_pairs<double>, sizes);
+  BENCHMARK("index_search/count_if/simd/double", count_if<double>, sizes);
+
+  // end 添字を返す探索
+} // namespace
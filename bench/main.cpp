@@ -0,0 +1,197 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "bench.hpp"
+
+namespace {
+  struct options {
+    std::string filter{};
+    std::string out{};
+    double min_time = 0.2;
+    bool list = false;
+  };
+
+  struct result {
+    std::string name;
+    std::size_t iterations;
+    double ns_per_iteration;
+    double items_per_second;
+    double allocations_per_iteration;
+    std::map<std::string, double> counters;
+  };
+
+  void print_usage(const char* argv0) {
+    std::cerr
+      << "usage: " << argv0
+      << " [--filter=SUBSTR] [--out=FILE] [--min-time=SEC] [--list]\n"
+         "  Runs the registered benchmarks and writes the results as JSON to\n"
+         "  FILE (or stdout). A summary table is written to stderr.\n";
+  }
+
+  bool parse_options(int argc, char** argv, options& opts) {
+    for (int i = 1; i < argc; ++i) {
+      std::string_view arg = argv[i];
+      auto value = [&](std::string_view key) -> std::string_view {
+        return arg.starts_with(key) ? arg.substr(key.size()) : "";
+      };
+      if (arg.starts_with("--filter="))
+        opts.filter = value("--filter=");
+      else if (arg.starts_with("--out="))
+        opts.out = value("--out=");
+      else if (arg.starts_with("--min-time="))
+        opts.min_time = std::stod(std::string(value("--min-time=")));
+      else if (arg == "--list")
+        opts.list = true;
+      else
+        return false;
+    }
+    return true;
+  }
+
+  /// @brief 経過時間が min_time を超えるまで繰り返し回数を増やして計測する
+  result run(const bench::benchmark& b, double min_time) {
+    std::size_t n = 1;
+    while (true) {
+      bench::state st(n, b.arg);
+      b.fn(st);
+      const double elapsed = st.elapsed();
+      if (elapsed >= min_time or n >= (std::size_t(1) << 40)) {
+        return {
+          b.name,
+          n,
+          elapsed * 1e9 / static_cast<double>(n),
+          st.items_processed() != 0
+            ? static_cast<double>(st.items_processed()) / elapsed
+            : 0.0,
+          static_cast<double>(st.allocations()) / static_cast<double>(n),
+          st.counters()};
+      }
+      // 目標時間の 1.4 倍を目安に、1 回あたり最大 10 倍まで増やす
+      const double scale = elapsed > 0.0 ? 1.4 * min_time / elapsed : 10.0;
+      n = std::max(
+        n + 1,
+        static_cast<std::size_t>(
+          static_cast<double>(n) * std::clamp(scale, 1.0, 10.0)));
+    }
+  }
+
+  std::string json_escape(std::string_view s) {
+    std::string r;
+    for (char c : s) {
+      switch (c) {
+        case '"':
+          r += "\\\"";
+          break;
+        case '\\':
+          r += "\\\\";
+          break;
+        case '\n':
+          r += "\\n";
+          break;
+        default:
+          r += c;
+      }
+    }
+    return r;
+  }
+
+  std::string json_number(double x) {
+    if (not std::isfinite(x))
+      return "null";
+    std::ostringstream os;
+    os.precision(17);
+    os << x;
+    return os.str();
+  }
+
+  void write_json(std::ostream& os, const std::vector<result>& results) {
+    char date[64] = {};
+    const std::time_t now = std::time(nullptr);
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+
+    os << "{\n";
+    os << "  \"context\": {\n";
+    os << "    \"date\": \"" << date << "\",\n";
+#if defined(__VERSION__)
+    os << "    \"compiler\": \"" << json_escape(__VERSION__) << "\",\n";
+#endif
+#if defined(NDEBUG)
+    os << "    \"assertions\": false\n";
+#else
+    os << "    \"assertions\": true\n";
+#endif
+    os << "  },\n";
+    os << "  \"benchmarks\": [";
+    for (std::size_t i = 0; i < results.size(); ++i) {
+      const auto& r = results[i];
+      os << (i == 0 ? "\n" : ",\n");
+      os << "    {\"name\": \"" << json_escape(r.name) << "\"";
+      os << ", \"iterations\": " << r.iterations;
+      os << ", \"real_time_ns\": " << json_number(r.ns_per_iteration);
+      if (r.items_per_second != 0.0)
+        os << ", \"items_per_second\": " << json_number(r.items_per_second);
+      os << ", \"allocations_per_iteration\": "
+         << json_number(r.allocations_per_iteration);
+      for (const auto& [key, value] : r.counters)
+        os << ", \"" << json_escape(key) << "\": " << json_number(value);
+      os << "}";
+    }
+    os << "\n  ]\n}\n";
+  }
+
+  void print_row(const result& r) {
+    std::fprintf(
+      stderr,
+      "%-56s %14.2f ns %12zu",
+      r.name.c_str(),
+      r.ns_per_iteration,
+      r.iterations);
+    if (r.items_per_second != 0.0)
+      std::fprintf(stderr, " %10.3g items/s", r.items_per_second);
+    if (r.allocations_per_iteration != 0.0)
+      std::fprintf(stderr, " %g allocs/iter", r.allocations_per_iteration);
+    for (const auto& [key, value] : r.counters)
+      std::fprintf(stderr, " %s=%g", key.c_str(), value);
+    std::fprintf(stderr, "\n");
+  }
+} // namespace
+
+int main(int argc, char** argv) {
+  options opts;
+  if (not parse_options(argc, argv, opts)) {
+    print_usage(argv[0]);
+    return 1;
+  }
+
+  std::vector<result> results;
+  for (const auto& b : bench::registry()) {
+    if (b.name.find(opts.filter) == std::string::npos)
+      continue;
+    if (opts.list) {
+      std::cout << b.name << '\n';
+      continue;
+    }
+    results.push_back(run(b, opts.min_time));
+    print_row(results.back());
+  }
+  if (opts.list)
+    return 0;
+
+  if (opts.out.empty()) {
+    write_json(std::cout, results);
+  } else {
+    std::ofstream ofs(opts.out);
+    if (not ofs) {
+      std::cerr << "cannot open " << opts.out << '\n';
+      return 1;
+    }
+    write_json(ofs, results);
+  }
+}
@@ -0,0 +1,76 @@
+#include <ns/packed_tuple.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <vector>
+#include "bench.hpp"
+
+namespace {
+  // 宣言順のままでは char の後ろにパディングが入るキー
+  using plain_key = std::tuple<char, double, char, int, char>;
+  using packed_key = ns::packed_tuple<char, double, char, int, char>;
+
+  template <class Key>
+  std::vector<Key> make_keys(std::size_t n) {
+    std::vector<Key> keys;
+    keys.reserve(n);
+    for (std::size_t i = 0; i < n; ++i) {
+      const auto c = static_cast<char>(i % 128);
+      keys.emplace_back(c, static_cast<double>(i), c, static_cast<int>(i), c);
+    }
+    return keys;
+  }
+
+  /// @brief 0 以上 n 未満の添字の乱数列
+  std::vector<std::size_t> make_random_indices(std::size_t n) {
+    std::vector<std::size_t> indices(n);
+    std::uint64_t state = 88172645463325252ull;
+    for (auto& i : indices)
+      std::tie(i, state) = ns::xorshift64(n - 1, state);
+    return indices;
+  }
+
+  // begin 順に走査する
+
+  template <class Key>
+  void sequential(bench::state& st) {
+    const auto keys = make_keys<Key>(st.arg());
+    for (auto _ : st) {
+      std::int64_t acc = 0;
+      for (const auto& key : keys)
+        acc += get<3>(key) + get<0>(key);
+      bench::do_not_optimize(acc);
+    }
+    st.set_items_processed(st.iterations() * st.arg());
+    st.counters()["bytes"] = static_cast<double>(sizeof(Key) * st.arg());
+  }
+
+  // end 順に走査する
+
+  // begin ランダムに参照する
+
+  // 配列がキャッシュに収まらないとき、1 要素が小さいほどキャッシュミスが減る
+
+  template <class Key>
+  void random(bench::state& st) {
+    const auto keys = make_keys<Key>(st.arg());
+    const auto indices = make_random_indices(st.arg());
+    for (auto _ : st) {
+      double acc = 0.0;
+      for (auto i : indices)
+        acc += get<1>(keys[i]);
+      bench::do_not_optimize(acc);
+    }
+    st.set_items_processed(st.iterations() * st.arg());
+    st.counters()["bytes"] = static_cast<double>(sizeof(Key) * st.arg());
+  }
+
+  // end ランダムに参照する
+
+  const std::vector<std::size_t> sizes{1 << 12, 1 << 22};
+
+  BENCHMARK("packed_tuple/sequential/std_tuple", sequential<plain_key>, sizes);
+  BENCHMARK("packed_tuple/sequential/packed", sequential<packed_key>, sizes);
+  BENCHMARK("packed_tuple/random/std_tuple", random<plain_key>, sizes);
+  BENCHMARK("packed_tuple/random/packed", random<packed_key>, sizes);
+} // namespace
@@ -0,0 +1,54 @@
+#include <ns/permutation.hpp>
+#include <ns/random.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <vector>
+#include "bench.hpp"
+
+namespace {
+  constexpr std::uint64_t seed = 0x01234567DEADC0DE;
+
+  /// @brief 1 本の乱数列による Fisher-Yates (比較対象)
+  void serial_fisher_yates(bench::state& st) {
+    std::vector<std::uint32_t> perm(st.arg());
+    for (auto _ : st) {
+      std::iota(perm.begin(), perm.end(), std::uint32_t(0));
+      ns::random::xoshiro256ss gen(seed);
+      for (std::size_t i = perm.size(); i > 1; --i)
+        std::swap(perm[i - 1], perm[ns::random::uniform_below(gen, i)]);
+      bench::do_not_optimize(perm.data());
+      bench::clobber_memory();
+    }
+    st.set_items_processed(st.iterations() * st.arg());
+  }
+
+  void make_permutation(bench::state& st, unsigned threads) {
+    for (auto _ : st) {
+      auto perm = ns::make_permutation<std::uint32_t>(st.arg(), seed, threads);
+      bench::do_not_optimize(perm.data());
+    }
+    st.set_items_processed(st.iterations() * st.arg());
+    st.counters()["threads"] = threads;
+  }
+
+  const bool registered = [] {
+    const std::vector<std::size_t> sizes{1 << 16, 1 << 24};
+    bench::registrar(
+      "permutation/serial_fisher_yates", serial_fisher_yates, sizes);
+    // 1 スレッドから hardware_concurrency まで倍々に増やす
+    const unsigned hc = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned t = 1;; t = std::min(2 * t, hc)) {
+      bench::registrar(
+        "permutation/make_permutation/threads:" + std::to_string(t),
+        [t](bench::state& st) { make_permutation(st, t); },
+        sizes);
+      if (t == hc)
+        break;
+    }
+    return true;
+  }();
+} // namespace
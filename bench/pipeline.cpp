@@ -0,0 +1,159 @@
+#include <ns/enumerate_view.hpp>
+#include <ns/pipeline.hpp>
+#include <ns/random.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <ranges>
+#include <vector>
+#include "bench.hpp"
+
+namespace {
+  constexpr std::uint64_t seed = 0x01234567DEADC0DE;
+
+  std::vector<float> make_values(std::size_t n) {
+    ns::random::xoshiro256ss gen(seed);
+    std::vector<float> v(n);
+    for (auto& x : v)
+      x = static_cast<float>(ns::random::uniform_below(gen, 100)) / 100.0f;
+    return v;
+  }
+
+  // begin iota | filter | transform | take
+
+  constexpr auto is_even = [](std::int64_t x) { return x % 2 == 0; };
+  constexpr auto square = [](std::int64_t x) { return x * x; };
+
+  void even_squares_views(bench::state& st) {
+    const auto n = st.arg();
+    for (auto _ : st) {
+      std::int64_t acc = 0;
+      for (auto x : std::views::iota(std::int64_t(0))
+                      | std::views::filter(is_even)
+                      | std::views::transform(square) | std::views::take(n))
+        acc += x;
+      bench::do_not_optimize(acc);
+    }
+    st.set_items_processed(st.iterations() * n);
+  }
+
+  void even_squares_pipeline(bench::state& st) {
+    const auto n = st.arg();
+    for (auto _ : st) {
+      std::int64_t acc = 0;
+      (ns::pipeline(std::views::iota(std::int64_t(0)))
+       | ns::pipe::filter(is_even) | ns::pipe::transform(square)
+       | ns::pipe::take(n))
+        .for_each([&](std::int64_t x) { acc += x; });
+      bench::do_not_optimize(acc);
+    }
+    st.set_items_processed(st.iterations() * n);
+  }
+
+  void even_squares_loop(bench::state& st) {
+    const auto n = st.arg();
+    for (auto _ : st) {
+      std::int64_t acc = 0;
+      std::size_t taken = 0;
+      for (std::int64_t x = 0; taken < n; ++x) {
+        if (not is_even(x))
+          continue;
+        acc += square(x);
+        ++taken;
+      }
+      bench::do_not_optimize(acc);
+    }
+    st.set_items_processed(st.iterations() * n);
+  }
+
+  // end iota | filter | transform | take
+
+  // begin enumerate | filter | transform
+
+  /// @brief 閾値を超える要素の、位置で重み付けした和
+  void weighted_views(bench::state& st) {
+    // const な範囲の enumerate_view は input_range とならず、filter_view に
+    // 渡せない
+    auto v = make_values(st.arg());
+    for (auto _ : st) {
+      float acc = 0;
+      auto e = ns::enumerate_view(v);
+      for (float x : e | std::views::filter([](const auto& p) {
+                       return p.second > 0.5f;
+                     }) | std::views::transform([](const auto& p) {
+                       return static_cast<float>(p.first) * p.second;
+                     }))
+        acc += x;
+      bench::do_not_optimize(acc);
+    }
+    st.set_items_processed(st.iterations() * st.arg());
+  }
+
+  void weighted_pipeline(bench::state& st) {
+    const auto v = make_values(st.arg());
+    for (auto _ : st) {
+      float acc = 0;
+      (ns::pipeline(v) | ns::pipe::enumerate()
+       | ns::pipe::filter([](const auto& p) { return p.second > 0.5f; })
+       | ns::pipe::transform([](const auto& p) {
+           return static_cast<float>(p.first) * p.second;
+         }))
+        .for_each([&](float x) { acc += x; });
+      bench::do_not_optimize(acc);
+    }
+    st.set_items_processed(st.iterations() * st.arg());
+  }
+
+  void weighted_loop(bench::state& st) {
+    const auto v = make_values(st.arg());
+    for (auto _ : st) {
+      float acc = 0;
+      for (std::size_t i = 0; i < v.size(); ++i)
+        if (v[i] > 0.5f)
+          acc += static_cast<float>(i) * v[i];
+      bench::do_not_optimize(acc);
+    }
+    st.set_items_processed(st.iterations() * st.arg());
+  }
+
+  // end enumerate | filter | transform
+
+  // begin stride | transform | take
+
+  void strided_pipeline(bench::state& st) {
+    const auto v = make_values(st.arg());
+    for (auto _ : st) {
+      float acc = 0;
+      (ns::pipeline(v) | ns::pipe::stride(4)
+       | ns::pipe::transform([](float x) { return x * 3.0f; })
+       | ns::pipe::take(v.size() / 8))
+        .for_each([&](float x) { acc += x; });
+      bench::do_not_optimize(acc);
+    }
+    st.set_items_processed(st.iterations() * st.arg() / 8);
+  }
+
+  void strided_loop(bench::state& st) {
+    const auto v = make_values(st.arg());
+    for (auto _ : st) {
+      float acc = 0;
+      const std::size_t count = v.size() / 8;
+      for (std::size_t k = 0; k < count; ++k)
+        acc += v[4 * k] * 3.0f;
+      bench::do_not_optimize(acc);
+    }
+    st.set_items_processed(st.iterations() * st.arg() / 8);
+  }
+
+  // end stride | transform | take
+
+  const std::vector<std::size_t> sizes{1 << 10, 1 << 20};
+
+  BENCHMARK("pipeline/even_squares/views", even_squares_views, sizes);
+  BENCHMARK("pipeline/even_squares/pipeline", even_squares_pipeline, sizes);
+  BENCHMARK("pipeline/even_squares/loop", even_squares_loop, sizes);
+  BENCHMARK("pipeline/weighted/views", weighted_views, sizes);
+  BENCHMARK("pipeline/weighted/pipeline", weighted_pipeline, sizes);
+  BENCHMARK("pipeline/weighted/loop", weighted_loop, sizes);
+  BENCHMARK("pipeline/strided/pipeline", strided_pipeline, sizes);
+  BENCHMARK("pipeline/strided/loop", strided_loop, sizes);
+} // namespace
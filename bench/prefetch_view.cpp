@@ -0,0 +1,163 @@
+#include <ns/enumerate_view.hpp>
+#include <ns/prefetch_view.hpp>
+#include <ns/random.hpp>
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <string>
+#include <vector>
+#include "bench.hpp"
+
+namespace {
+  constexpr std::uint64_t seed = 0x01234567DEADC0DE;
+
+  /// @brief ノードがメモリ上で無作為な順に並ぶ、要素が 0, 1, ..., n - 1 の
+  /// std::list
+  std::list<std::uint64_t> make_scattered_list(std::size_t n) {
+    std::list<std::uint64_t> pool;
+    for (std::size_t i = 0; i < n; ++i)
+      pool.push_back(i);
+    std::vector<std::list<std::uint64_t>::iterator> order;
+    for (auto it = pool.begin(); it != pool.end(); ++it)
+      order.push_back(it);
+    ns::random::xoshiro256ss gen(seed);
+    std::shuffle(order.begin(), order.end(), gen);
+    // ノードを付け替えるのみで、確保し直さない
+    std::list<std::uint64_t> l;
+    for (auto it : order)
+      l.splice(l.end(), pool, it);
+    std::uint64_t i = 0;
+    for (auto& x : l)
+      x = i++;
+    return l;
+  }
+
+  // begin std::list の走査
+
+  void list_sum(bench::state& st) {
+    const auto l = make_scattered_list(st.arg());
+    for (auto _ : st) {
+      std::uint64_t acc = 0;
+      for (auto x : l)
+        acc += x;
+      bench::do_not_optimize(acc);
+    }
+    st.set_items_processed(st.iterations() * st.arg());
+  }
+
+  void list_sum_prefetch(bench::state& st, std::size_t distance) {
+    const auto l = make_scattered_list(st.arg());
+    for (auto _ : st) {
+      std::uint64_t acc = 0;
+      for (auto x : ns::prefetch_view(l, distance))
+        acc += x;
+      bench::do_not_optimize(acc);
+    }
+    st.set_items_processed(st.iterations() * st.arg());
+  }
+
+  // end std::list の走査
+
+  // begin std::list の enumerate
+
+  void enumerate_list(bench::state& st) {
+    auto l = make_scattered_list(st.arg());
+    for (auto _ : st) {
+      std::uint64_t acc = 0;
+      for (auto [i, x] : ns::enumerate_view(l))
+        acc += i ^ x;
+      bench::do_not_optimize(acc);
+    }
+    st.set_items_processed(st.iterations() * st.arg());
+  }
+
+  void enumerate_list_prefetch(bench::state& st, std::size_t distance) {
+    auto l = make_scattered_list(st.arg());
+    for (auto _ : st) {
+      std::uint64_t acc = 0;
+      for (auto [i, x] : ns::enumerate_view(ns::prefetch_view(l, distance)))
+        acc += i ^ x;
+      bench::do_not_optimize(acc);
+    }
+    st.set_items_processed(st.iterations() * st.arg());
+  }
+
+  // end std::list の enumerate
+
+  // begin 要素が指す先の読み出し
+
+  /// @brief キャッシュライン 1 本分の大きさのデータ
+  struct alignas(64) record {
+    std::array<std::uint64_t, 8> fields;
+  };
+
+  /// @brief 無作為な順に並ぶ record を指すポインタの std::list
+  struct scattered_records {
+    std::vector<std::unique_ptr<record>> owners;
+    std::list<const record*> l;
+
+    explicit scattered_records(std::size_t n) {
+      for (std::size_t i = 0; i < n; ++i)
+        owners.push_back(std::make_unique<record>(record{{i, i, i, i}}));
+      std::vector<const record*> order;
+      for (const auto& p : owners)
+        order.push_back(p.get());
+      ns::random::xoshiro256ss gen(seed);
+      std::shuffle(order.begin(), order.end(), gen);
+      l.assign(order.begin(), order.end());
+    }
+  };
+
+  void records_sum(bench::state& st) {
+    const scattered_records r(st.arg());
+    for (auto _ : st) {
+      std::uint64_t acc = 0;
+      for (const record* p : r.l)
+        acc += p->fields[0] + p->fields[3];
+      bench::do_not_optimize(acc);
+    }
+    st.set_items_processed(st.iterations() * st.arg());
+  }
+
+  void records_sum_prefetch(bench::state& st, std::size_t distance) {
+    const scattered_records r(st.arg());
+    // ノードではなく、ノードが指す record をプリフェッチする
+    constexpr auto pointee = [](const record* p) -> const void* { return p; };
+    for (auto _ : st) {
+      std::uint64_t acc = 0;
+      for (const record* p : ns::prefetch_view(r.l, distance, pointee))
+        acc += p->fields[0] + p->fields[3];
+      bench::do_not_optimize(acc);
+    }
+    st.set_items_processed(st.iterations() * st.arg());
+  }
+
+  // end 要素が指す先の読み出し
+
+  const bool registered = [] {
+    const std::vector<std::size_t> sizes{1 << 12, 1 << 20};
+    bench::registrar("prefetch_view/list_sum/plain", list_sum, sizes);
+    bench::registrar(
+      "prefetch_view/enumerate_list/plain", enumerate_list, sizes);
+    bench::registrar("prefetch_view/records_sum/plain", records_sum, sizes);
+    for (std::size_t d : {4u, 16u, 64u}) {
+      const auto suffix = "/distance:" + std::to_string(d);
+      bench::registrar(
+        "prefetch_view/list_sum/prefetch" + suffix,
+        [d](bench::state& st) { list_sum_prefetch(st, d); },
+        sizes);
+      bench::registrar(
+        "prefetch_view/enumerate_list/prefetch" + suffix,
+        [d](bench::state& st) { enumerate_list_prefetch(st, d); },
+        sizes);
+      bench::registrar(
+        "prefetch_view/records_sum/prefetch" + suffix,
+        [d](bench::state& st) { records_sum_prefetch(st, d); },
+        sizes);
+    }
+    return true;
+  }();
+} // namespace
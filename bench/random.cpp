@@ -0,0 +1,101 @@
+#include <ns/random.hpp>
+#include <ns/tuple_arrange.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <tuple>
+#include <vector>
+#include "bench.hpp"
+
+namespace {
+  constexpr std::uint64_t seed = 0x01234567DEADC0DE;
+  // 2 のべきから遠い上限 (剰余と棄却の両方が効く)
+  constexpr std::uint64_t bound = 1'000'003;
+
+  /// @brief 1 回の計測で st.arg() 個の乱数を out に書き込む
+  template <class Draw>
+  void draws(bench::state& st, Draw draw) {
+    std::vector<std::uint64_t> out(st.arg());
+    for (auto _ : st) {
+      for (auto& x : out)
+        x = draw();
+      bench::do_not_optimize(out.data());
+      bench::clobber_memory();
+    }
+    st.set_items_processed(st.iterations() * st.arg());
+  }
+
+  // begin 64 ビットの乱数
+
+  BENCHMARK(
+    "random/bits/xorshift64",
+    [](bench::state& st) {
+      std::uint64_t state = seed;
+      draws(st, [&] {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return state;
+      });
+    },
+    {1 << 16});
+  BENCHMARK(
+    "random/bits/mt19937_64",
+    [](bench::state& st) {
+      std::mt19937_64 g(seed);
+      draws(st, [&] { return g(); });
+    },
+    {1 << 16});
+  BENCHMARK(
+    "random/bits/xoshiro256ss",
+    [](bench::state& st) {
+      ns::random::xoshiro256ss g(seed);
+      draws(st, [&] { return g(); });
+    },
+    {1 << 16});
+  BENCHMARK(
+    "random/bits/xoshiro256ss_batch",
+    [](bench::state& st) {
+      ns::random::xoshiro256ss_batch<> g(seed);
+      std::vector<std::uint64_t> out(st.arg());
+      for (auto _ : st) {
+        g.fill(out);
+        bench::do_not_optimize(out.data());
+        bench::clobber_memory();
+      }
+      st.set_items_processed(st.iterations() * st.arg());
+    },
+    {1 << 16});
+
+  // end 64 ビットの乱数
+
+  // begin [0, bound) の乱数
+
+  BENCHMARK(
+    "random/bounded/xorshift64_modulo",
+    [](bench::state& st) {
+      std::uint64_t state = seed, x = 0;
+      draws(st, [&] {
+        std::tie(x, state) = ns::xorshift64(bound - 1, state);
+        return x;
+      });
+    },
+    {1 << 16});
+  BENCHMARK(
+    "random/bounded/xoshiro256ss_lemire",
+    [](bench::state& st) {
+      ns::random::xoshiro256ss g(seed);
+      draws(st, [&] { return ns::random::uniform_below(g, bound); });
+    },
+    {1 << 16});
+  BENCHMARK(
+    "random/bounded/uniform_int_distribution",
+    [](bench::state& st) {
+      ns::random::xoshiro256ss g(seed);
+      std::uniform_int_distribution<std::uint64_t> dist(0, bound - 1);
+      draws(st, [&] { return dist(g); });
+    },
+    {1 << 16});
+
+  // end [0, bound) の乱数
+} // namespace
@@ -0,0 +1,93 @@
+#include <ns/enumerate_view.hpp>
+#include <ns/random.hpp>
+#include <ns/selection_view.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "bench.hpp"
+
+namespace {
+  constexpr std::uint64_t seed = 0x01234567DEADC0DE;
+
+  /// @brief [0, 100) の一様な値 (閾値がそのまま選ばれる割合 [%] となる)
+  std::vector<float> make_values(std::size_t n) {
+    ns::random::xoshiro256ss gen(seed);
+    std::vector<float> v(n);
+    for (auto& x : v)
+      x = static_cast<float>(ns::random::uniform_below(gen, 100));
+    return v;
+  }
+
+  // begin 選択ベクトルの作成
+
+  /// @brief enumerate_view を走査し、条件を満たす添字を分岐して追記する
+  template <int Percent>
+  void branchy(bench::state& st) {
+    const auto v = make_values(st.arg());
+    for (auto _ : st) {
+      std::vector<std::uint32_t> sel;
+      for (auto [i, x] : ns::enumerate_view(v, std::uint32_t(0)))
+        if (x < float(Percent))
+          sel.push_back(i);
+      bench::do_not_optimize(sel.data());
+    }
+    st.set_items_processed(st.iterations() * st.arg());
+  }
+
+  /// @brief 任意の述語 (分岐を用いないスカラーの経路)
+  template <int Percent>
+  void indices_where_scalar(bench::state& st) {
+    const auto v = make_values(st.arg());
+    for (auto _ : st) {
+      auto sel = ns::indices_where(
+        ns::enumerate_view(v, std::uint32_t(0)),
+        [](float x) { return x < float(Percent); });
+      bench::do_not_optimize(sel.data());
+    }
+    st.set_items_processed(st.iterations() * st.arg());
+  }
+
+  template <int Percent>
+  void indices_where_simd(bench::state& st) {
+    const auto v = make_values(st.arg());
+    for (auto _ : st) {
+      auto sel = ns::indices_where(
+        ns::enumerate_view(v, std::uint32_t(0)),
+        ns::less_than(float(Percent)));
+      bench::do_not_optimize(sel.data());
+    }
+    st.set_items_processed(st.iterations() * st.arg());
+  }
+
+  const std::vector<std::size_t> sizes{1 << 12, 1 << 20};
+
+  BENCHMARK("selection_view/branchy/1%", branchy<1>, sizes);
+  BENCHMARK("selection_view/branchy/50%", branchy<50>, sizes);
+  BENCHMARK("selection_view/branchy/99%", branchy<99>, sizes);
+  BENCHMARK("selection_view/scalar/1%", indices_where_scalar<1>, sizes);
+  BENCHMARK("selection_view/scalar/50%", indices_where_scalar<50>, sizes);
+  BENCHMARK("selection_view/scalar/99%", indices_where_scalar<99>, sizes);
+  BENCHMARK("selection_view/simd/1%", indices_where_simd<1>, sizes);
+  BENCHMARK("selection_view/simd/50%", indices_where_simd<50>, sizes);
+  BENCHMARK("selection_view/simd/99%", indices_where_simd<99>, sizes);
+
+  // end 選択ベクトルの作成
+
+  // begin 選択ベクトルによる走査
+
+  void selection_sum(bench::state& st) {
+    auto v = make_values(st.arg());
+    const auto sel = ns::indices_where(v, ns::less_than(50.0f));
+    for (auto _ : st) {
+      float acc = 0;
+      for (float x : ns::selection_view(v, sel))
+        acc += x;
+      bench::do_not_optimize(acc);
+    }
+    st.set_items_processed(st.iterations() * sel.size());
+  }
+
+  BENCHMARK("selection_view/selection_sum/50%", selection_sum, sizes);
+
+  // end 選択ベクトルによる走査
+} // namespace
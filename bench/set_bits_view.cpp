@@ -0,0 +1,60 @@
+#include <ns/random.hpp>
+#include <ns/set_bits_view.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "bench.hpp"
+
+namespace {
+  constexpr std::uint64_t seed = 0x01234567DEADC0DE;
+
+  /// @brief 各ビットが per_mille / 1000 の確率で立つ n ビットのビット列
+  std::vector<std::uint64_t>
+  make_words(std::size_t n, std::uint64_t per_mille) {
+    ns::random::xoshiro256ss gen(seed);
+    std::vector<std::uint64_t> words((n + 63) / 64);
+    for (std::size_t i = 0; i < n; ++i)
+      if (ns::random::uniform_below(gen, 1000) < per_mille)
+        words[i / 64] |= std::uint64_t(1) << (i % 64);
+    return words;
+  }
+
+  // begin 立っているビットの走査
+
+  /// @brief 1 ビットずつ調べる
+  template <std::uint64_t PerMille>
+  void naive(bench::state& st) {
+    const auto words = make_words(st.arg(), PerMille);
+    for (auto _ : st) {
+      std::size_t acc = 0;
+      for (std::size_t i = 0; i < words.size() * 64; ++i)
+        if ((words[i / 64] >> (i % 64)) & 1)
+          acc += i;
+      bench::do_not_optimize(acc);
+    }
+    st.set_items_processed(st.iterations() * st.arg());
+  }
+
+  template <std::uint64_t PerMille>
+  void set_bits(bench::state& st) {
+    const auto words = make_words(st.arg(), PerMille);
+    for (auto _ : st) {
+      std::size_t acc = 0;
+      for (std::size_t i : ns::set_bits_view(words))
+        acc += i;
+      bench::do_not_optimize(acc);
+    }
+    st.set_items_processed(st.iterations() * st.arg());
+  }
+
+  const std::vector<std::size_t> sizes{1 << 16, 1 << 24};
+
+  BENCHMARK("set_bits_view/naive/0.1%", naive<1>, sizes);
+  BENCHMARK("set_bits_view/naive/1%", naive<10>, sizes);
+  BENCHMARK("set_bits_view/naive/50%", naive<500>, sizes);
+  BENCHMARK("set_bits_view/set_bits/0.1%", set_bits<1>, sizes);
+  BENCHMARK("set_bits_view/set_bits/1%", set_bits<10>, sizes);
+  BENCHMARK("set_bits_view/set_bits/50%", set_bits<500>, sizes);
+
+  // end 立っているビットの走査
+} // namespace
@@ -0,0 +1,60 @@
+#include <ns/permutation.hpp>
+#include <ns/shuffle_view.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "bench.hpp"
+
+namespace {
+  constexpr std::uint64_t seed = 0x01234567DEADC0DE;
+
+  // 各ベンチマークは元の範囲を擬似ランダムな順に 1 周して総和を取る
+
+  /// @brief make_permutation で添字の配列を作ってから走査する
+  void materialized(bench::state& st) {
+    const std::vector<std::uint32_t> v(st.arg(), 1);
+    for (auto _ : st) {
+      const auto perm = ns::make_permutation<std::uint32_t>(v.size(), seed, 1);
+      std::uint64_t acc = 0;
+      for (auto i : perm)
+        acc += v[i];
+      bench::do_not_optimize(acc);
+    }
+    st.set_items_processed(st.iterations() * st.arg());
+    st.counters()["extra_bytes"] =
+      static_cast<double>(sizeof(std::uint32_t) * st.arg());
+  }
+
+  /// @brief 作成済みの添字の配列で走査する (作成の費用を含めない)
+  void materialized_reuse(bench::state& st) {
+    const std::vector<std::uint32_t> v(st.arg(), 1);
+    const auto perm = ns::make_permutation<std::uint32_t>(v.size(), seed, 1);
+    for (auto _ : st) {
+      std::uint64_t acc = 0;
+      for (auto i : perm)
+        acc += v[i];
+      bench::do_not_optimize(acc);
+    }
+    st.set_items_processed(st.iterations() * st.arg());
+    st.counters()["extra_bytes"] =
+      static_cast<double>(sizeof(std::uint32_t) * st.arg());
+  }
+
+  void shuffle_view(bench::state& st) {
+    const std::vector<std::uint32_t> v(st.arg(), 1);
+    for (auto _ : st) {
+      std::uint64_t acc = 0;
+      for (auto x : ns::shuffle_view(v, seed))
+        acc += x;
+      bench::do_not_optimize(acc);
+    }
+    st.set_items_processed(st.iterations() * st.arg());
+    st.counters()["extra_bytes"] = 0;
+  }
+
+  const std::vector<std::size_t> sizes{1 << 16, 1 << 24};
+
+  BENCHMARK("shuffle_view/materialized", materialized, sizes);
+  BENCHMARK("shuffle_view/materialized_reuse", materialized_reuse, sizes);
+  BENCHMARK("shuffle_view/shuffle_view", shuffle_view, sizes);
+} // namespace
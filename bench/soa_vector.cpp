@@ -0,0 +1,114 @@
+#include <ns/soa_vector.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <vector>
+#include "bench.hpp"
+
+namespace {
+  // 1 行 = (id, x, y, z, weight) の 32 バイトのレコード
+  using record = std::tuple<std::uint64_t, float, float, float, double>;
+  using aos = std::vector<record>;
+  using soa = ns::soa_vector<std::uint64_t, float, float, float, double>;
+
+  template <class Container>
+  Container make_records(std::size_t n) {
+    Container c;
+    c.reserve(n);
+    for (std::size_t i = 0; i < n; ++i) {
+      const auto f = static_cast<float>(i % 13);
+      c.push_back(record{i, f, f + 1.0f, f + 2.0f, 0.5});
+    }
+    return c;
+  }
+
+  // begin 1 列だけを走査する
+
+  // 浮動小数点数の総和は -ffast-math なしではベクトル化されないため、整数の
+  // 列を足し合わせる
+
+  void aos_column(bench::state& st) {
+    const auto v = make_records<aos>(st.arg());
+    for (auto _ : st) {
+      std::uint64_t acc = 0;
+      for (const auto& row : v)
+        acc += std::get<0>(row);
+      bench::do_not_optimize(acc);
+    }
+    st.set_items_processed(st.iterations() * st.arg());
+  }
+
+  void soa_column(bench::state& st) {
+    const auto v = make_records<soa>(st.arg());
+    for (auto _ : st) {
+      std::uint64_t acc = 0;
+      for (std::uint64_t id : v.column<0>())
+        acc += id;
+      bench::do_not_optimize(acc);
+    }
+    st.set_items_processed(st.iterations() * st.arg());
+  }
+
+  void soa_select(bench::state& st) {
+    const auto v = make_records<soa>(st.arg());
+    for (auto _ : st) {
+      std::uint64_t acc = 0;
+      for (auto [id] : ns::tuple_select<0>(v))
+        acc += id;
+      bench::do_not_optimize(acc);
+    }
+    st.set_items_processed(st.iterations() * st.arg());
+  }
+
+  // end 1 列だけを走査する
+
+  // begin 行全体を走査する
+
+  template <class Container>
+  void row(bench::state& st) {
+    const auto v = make_records<Container>(st.arg());
+    for (auto _ : st) {
+      double acc = 0.0;
+      for (auto&& [id, x, y, z, w] : v)
+        acc += static_cast<double>(id) + w * static_cast<double>(x + y + z);
+      bench::do_not_optimize(acc);
+    }
+    st.set_items_processed(st.iterations() * st.arg());
+  }
+
+  // end 行全体を走査する
+
+  // begin 1 列を書き換える
+
+  void aos_update(bench::state& st) {
+    auto v = make_records<aos>(st.arg());
+    for (auto _ : st) {
+      for (auto& row : v)
+        std::get<4>(row) *= 1.0000001;
+      bench::clobber_memory();
+    }
+    st.set_items_processed(st.iterations() * st.arg());
+  }
+
+  void soa_update(bench::state& st) {
+    auto v = make_records<soa>(st.arg());
+    for (auto _ : st) {
+      for (double& w : v.column<double>())
+        w *= 1.0000001;
+      bench::clobber_memory();
+    }
+    st.set_items_processed(st.iterations() * st.arg());
+  }
+
+  // end 1 列を書き換える
+
+  const std::vector<std::size_t> sizes{1 << 10, 1 << 20};
+
+  BENCHMARK("soa_vector/column/aos", aos_column, sizes);
+  BENCHMARK("soa_vector/column/soa", soa_column, sizes);
+  BENCHMARK("soa_vector/column/soa_select", soa_select, sizes);
+  BENCHMARK("soa_vector/row/aos", row<aos>, sizes);
+  BENCHMARK("soa_vector/row/soa", row<soa>, sizes);
+  BENCHMARK("soa_vector/update/aos", aos_update, sizes);
+  BENCHMARK("soa_vector/update/soa", soa_update, sizes);
+} // namespace
@@ -0,0 +1,72 @@
+#include <ns/enumerate_view.hpp>
+#include <ns/thread_pool.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "bench.hpp"
+
+namespace {
+  /// @brief 要素ごとの仕事 (数十サイクル程度の計算)
+  inline float work(std::size_t i, float x) {
+    return std::sqrt(x + static_cast<float>(i)) * 0.5f + std::sin(x);
+  }
+
+  // begin parallel_for
+
+  /// @brief 呼び出したスレッドで順に処理する (比較対象)
+  void serial(bench::state& st) {
+    std::vector<float> v(st.arg(), 1.0f);
+    for (auto _ : st) {
+      for (auto [i, x] : ns::enumerate_view(v))
+        x = work(i, x);
+      bench::do_not_optimize(v.data());
+      bench::clobber_memory();
+    }
+    st.set_items_processed(st.iterations() * st.arg());
+  }
+
+  void parallel_for(bench::state& st, unsigned threads) {
+    // プールの生成はベンチマークの対象に含めない
+    static std::vector<std::unique_ptr<ns::thread_pool>> pools;
+    auto it = std::ranges::find_if(
+      pools, [&](const auto& p) { return p->concurrency() == threads; });
+    if (it == pools.end()) {
+      pools.push_back(std::make_unique<ns::thread_pool>(threads));
+      it = pools.end() - 1;
+    }
+    std::vector<float> v(st.arg(), 1.0f);
+    for (auto _ : st) {
+      ns::parallel_for(
+        **it, ns::enumerate_view(v), [](std::size_t i, float& x) {
+          x = work(i, x);
+        });
+      bench::do_not_optimize(v.data());
+      bench::clobber_memory();
+    }
+    st.set_items_processed(st.iterations() * st.arg());
+    st.counters()["threads"] = threads;
+  }
+
+  const bool registered = [] {
+    // 1 << 10 は parallel_for_grain の 2 倍未満で、逐次処理に切り替わる
+    const std::vector<std::size_t> sizes{1 << 10, 1 << 16, 1 << 22};
+    bench::registrar("thread_pool/serial", serial, sizes);
+    // 1 スレッドから hardware_concurrency まで倍々に増やす
+    const unsigned hc = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned t = 1;; t = std::min(2 * t, hc)) {
+      bench::registrar(
+        "thread_pool/parallel_for/threads:" + std::to_string(t),
+        [t](bench::state& st) { parallel_for(st, t); },
+        sizes);
+      if (t == hc)
+        break;
+    }
+    return true;
+  }();
+
+  // end parallel_for
+} // namespace
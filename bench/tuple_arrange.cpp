@@ -0,0 +1,167 @@
+#include <ns/tuple_arrange.hpp>
+#include <cstddef>
+#include <format>
+#include <initializer_list>
+#include <iterator>
+#include <string>
+#include <tuple>
+#include <vector>
+#include "bench.hpp"
+
+namespace {
+  // begin tuple_select と tuple_select_ref
+
+  using record = std::tuple<int, double, std::string>;
+
+  std::vector<record> make_records(std::size_t n) {
+    std::vector<record> records;
+    records.reserve(n);
+    for (std::size_t i = 0; i < n; ++i)
+      records.emplace_back(
+        static_cast<int>(i),
+        0.5,
+        std::string(1024, static_cast<char>('a' + i % 26)));
+    return records;
+  }
+
+  /// @brief 各レコードの (std::string, int) を射影して読み出す
+  template <class Project>
+  void project_records(bench::state& st, Project project) {
+    auto records = make_records(st.arg());
+    for (auto _ : st) {
+      std::size_t acc = 0;
+      for (auto& rec : records) {
+        auto&& [s, i] = project(rec);
+        acc += s.size() + static_cast<std::size_t>(i);
+      }
+      bench::do_not_optimize(acc);
+    }
+    st.set_items_processed(st.iterations() * st.arg());
+  }
+
+  BENCHMARK(
+    "tuple_arrange/tuple_select/string",
+    [](bench::state& st) {
+      project_records(
+        st, [](auto& rec) { return ns::tuple_select<2, 0>(rec); });
+    },
+    {1 << 10});
+  BENCHMARK(
+    "tuple_arrange/tuple_select_ref/string",
+    [](bench::state& st) {
+      project_records(
+        st, [](auto& rec) { return ns::tuple_select_ref<2, 0>(rec); });
+    },
+    {1 << 10});
+  BENCHMARK(
+    "tuple_arrange/tuple_select_by_type/string",
+    [](bench::state& st) {
+      project_records(st, [](auto& rec) {
+        return ns::tuple_select_by_type<std::string, int>(rec);
+      });
+    },
+    {1 << 10});
+  BENCHMARK(
+    "tuple_arrange/tuple_select_ref_by_type/string",
+    [](bench::state& st) {
+      project_records(st, [](auto& rec) {
+        return ns::tuple_select_ref_by_type<std::string, int>(rec);
+      });
+    },
+    {1 << 10});
+
+  // end tuple_select と tuple_select_ref
+
+  // begin unordered_fn
+
+  [[gnu::noinline]] double
+  handler(const std::vector<double>& v, const std::string& s, int k) {
+    return v[static_cast<std::size_t>(k)] + static_cast<double>(s.size());
+  }
+
+  /// @brief 大きな引数を参照で受け取る関数を、直接または unordered_fn 経由で
+  /// 呼び出す
+  template <class Call>
+  void call_handler(bench::state& st, Call call) {
+    const std::vector<double> v(1 << 16, 1.0);
+    const std::string s(1 << 10, 'x');
+    for (auto _ : st) {
+      double acc = 0.0;
+      for (int k = 0; k < 64; ++k)
+        acc += call(v, s, k);
+      bench::do_not_optimize(acc);
+    }
+    st.set_items_processed(st.iterations() * 64);
+  }
+
+  BENCHMARK("tuple_arrange/unordered_fn/direct", [](bench::state& st) {
+    call_handler(st, [](const auto& v, const auto& s, int k) {
+      return handler(v, s, k);
+    });
+  });
+  BENCHMARK("tuple_arrange/unordered_fn/reordered", [](bench::state& st) {
+    constexpr auto unordered_handler = ns::unordered_fn(&handler);
+    call_handler(st, [=](const auto& v, const auto& s, int k) {
+      return unordered_handler(k, s, v);
+    });
+  });
+
+  // end unordered_fn
+
+  // begin tuple_format
+
+  /// @brief 要素ごとに文字列全体を作り直す、以前の tuple_format の実装
+  template <class Tuple, std::size_t... Is>
+  auto legacy_tuple_format(const Tuple& tpl, std::index_sequence<Is...>)
+    -> std::string {
+    std::string str{};
+    const char* dlm = "";
+    using swallow = std::initializer_list<int>;
+    (void)swallow{
+      (void(
+         str = std::format(
+           "{}{}{}", str, std::exchange(dlm, ", "), std::get<Is>(tpl))),
+       0)...};
+    return std::format("({})", str);
+  }
+
+  const auto wide_tuple = std::tuple{
+    1, 2.5, std::string("alpha"), 'x', 42u, -7L, 3.25f, std::string("omega")};
+
+  BENCHMARK("tuple_arrange/tuple_format/legacy", [](bench::state& st) {
+    for (auto _ : st)
+      bench::do_not_optimize(legacy_tuple_format(
+        wide_tuple,
+        std::make_index_sequence<std::tuple_size_v<
+          std::remove_cvref_t<decltype(wide_tuple)>>>{}));
+    st.set_items_processed(st.iterations());
+  });
+  BENCHMARK("tuple_arrange/tuple_format/string", [](bench::state& st) {
+    for (auto _ : st)
+      bench::do_not_optimize(ns::tuple_format(wide_tuple));
+    st.set_items_processed(st.iterations());
+  });
+  BENCHMARK("tuple_arrange/tuple_format_to/buffer", [](bench::state& st) {
+    std::string buf;
+    buf.reserve(1 << 10);
+    for (auto _ : st) {
+      buf.clear();
+      ns::tuple_format_to(std::back_inserter(buf), wide_tuple);
+      bench::do_not_optimize(buf.data());
+    }
+    st.set_items_processed(st.iterations());
+  });
+  BENCHMARK("tuple_arrange/tuple_fmt/format_to", [](bench::state& st) {
+    std::string buf;
+    buf.reserve(1 << 10);
+    for (auto _ : st) {
+      buf.clear();
+      std::format_to(
+        std::back_inserter(buf), "row {}: {}\n", 1, ns::tuple_fmt(wide_tuple));
+      bench::do_not_optimize(buf.data());
+    }
+    st.set_items_processed(st.iterations());
+  });
+
+  // end tuple_format
+} // namespace
@@ -0,0 +1,310 @@
+/// @file argsort.hpp
+#pragma once
+#include <ns/enumerate_view.hpp>
+#include <ns/permutation.hpp>
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <numeric>
+#include <ranges>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace ns {
+  // parallel_sort, parallel_stable_sort
+
+  /// @brief [first, last) を threads 個に分けて並列に整列し、併合する
+  /// @details Stable が真のとき各部分を std::stable_sort で整列する。併合は
+  /// std::merge (等しい要素は前半を優先する) で行うため安定性を保つ。
+  template <bool Stable, std::random_access_iterator It, class Less>
+    requires std::default_initializable<std::iter_value_t<It>>
+  void parallel_sort_impl(It first, It last, Less less, unsigned threads) {
+    const auto n = static_cast<std::size_t>(last - first);
+    if (n < 2)
+      return;
+    const std::size_t chunks = std::clamp<std::size_t>(threads, 1, n);
+    auto sort = [&](It f, It l) {
+      if constexpr (Stable)
+        std::stable_sort(f, l, less);
+      else
+        std::sort(f, l, less);
+    };
+    if (chunks <= 1) {
+      sort(first, last);
+      return;
+    }
+
+    std::vector<std::size_t> bounds(chunks + 1);
+    for (std::size_t k = 0; k <= chunks; ++k)
+      bounds[k] = n * k / chunks;
+    using diff_t = std::iter_difference_t<It>;
+    auto at = [](auto it, std::size_t i) {
+      return it + static_cast<diff_t>(i);
+    };
+
+    parallel_invoke_indexed(chunks, threads, [&](std::size_t k) {
+      sort(at(first, bounds[k]), at(first, bounds[k + 1]));
+    });
+
+    // 隣り合う整列済みの部分を 2 つずつ併合する
+    std::vector<std::iter_value_t<It>> buffer(n);
+    bool in_buffer = false;
+    for (std::size_t width = 1; width < chunks; width *= 2) {
+      const std::size_t pairs = (chunks + 2 * width - 1) / (2 * width);
+      parallel_invoke_indexed(pairs, threads, [&](std::size_t p) {
+        // 併合する前半の先頭の部分の番号
+        const std::size_t c = 2 * p * width;
+        const std::size_t lo = bounds[c];
+        const std::size_t mid = bounds[std::min(c + width, chunks)];
+        const std::size_t hi = bounds[std::min(c + 2 * width, chunks)];
+        auto move_merge = [&](auto src, auto dst) {
+          std::merge(
+            std::make_move_iterator(at(src, lo)),
+            std::make_move_iterator(at(src, mid)),
+            std::make_move_iterator(at(src, mid)),
+            std::make_move_iterator(at(src, hi)),
+            at(dst, lo),
+            less);
+        };
+        if (in_buffer)
+          move_merge(buffer.begin(), first);
+        else
+          move_merge(first, buffer.begin());
+      });
+      in_buffer = not in_buffer;
+    }
+    if (in_buffer)
+      std::move(buffer.begin(), buffer.end(), first);
+  }
+
+  template <std::random_access_iterator It, class Less = std::ranges::less>
+    requires std::default_initializable<std::iter_value_t<It>>
+  void
+  parallel_sort(It first, It last, Less less = {}, unsigned threads = 1) {
+    parallel_sort_impl<false>(first, last, std::move(less), threads);
+  }
+
+  template <std::random_access_iterator It, class Less = std::ranges::less>
+    requires std::default_initializable<std::iter_value_t<It>>
+  void parallel_stable_sort(
+    It first,
+    It last,
+    Less less = {},
+    unsigned threads = 1) {
+    parallel_sort_impl<true>(first, last, std::move(less), threads);
+  }
+
+  // radix_key
+
+  /// @brief 基数ソートで扱える算術型
+  template <class T>
+  concept radix_sortable =
+    std::is_arithmetic_v<T> and (not std::is_same_v<T, bool>) and
+    (std::is_integral_v<T> or std::is_same_v<T, float> or
+     std::is_same_v<T, double>);
+
+  /// @brief x を、大小関係を保つ符号なし整数に写す
+  /// @details 浮動小数点数の -0.0 は +0.0 と同じ値に写す。
+  template <radix_sortable T>
+  constexpr auto radix_key(T x) noexcept {
+    if constexpr (std::is_floating_point_v<T>) {
+      using U =
+        std::conditional_t<sizeof(T) == 4, std::uint32_t, std::uint64_t>;
+      constexpr U sign = U(1) << (std::numeric_limits<U>::digits - 1);
+      const U u = std::bit_cast<U>(x == T(0) ? T(0) : x);
+      return static_cast<U>(u & sign ? ~u : u | sign);
+    } else if constexpr (std::is_signed_v<T>) {
+      using U = std::make_unsigned_t<T>;
+      constexpr U sign = U(1) << (std::numeric_limits<U>::digits - 1);
+      return static_cast<U>(static_cast<U>(x) ^ sign);
+    } else {
+      return x;
+    }
+  }
+
+  // argsort, stable_argsort, argpartition
+
+  /// @brief 要素を比較する関数オブジェクトから、添字を比較する関数オブジェクト
+  /// を作る
+  template <
+    class Index,
+    std::random_access_iterator It,
+    class Comp,
+    class Proj>
+  constexpr auto index_comparator(It first, Comp& comp, Proj& proj) {
+    return [first, &comp, &proj](Index a, Index b) -> bool {
+      using diff_t = std::iter_difference_t<It>;
+      return std::invoke(
+        comp,
+        std::invoke(proj, first[static_cast<diff_t>(a)]),
+        std::invoke(proj, first[static_cast<diff_t>(b)]));
+    };
+  }
+
+  /// @brief 基数ソートを用いる要素数の下限
+  inline constexpr std::size_t argsort_radix_threshold = 1 << 10;
+  /// @brief 比較ソートを並列に行う要素数の下限
+  inline constexpr std::size_t argsort_parallel_threshold = 1 << 16;
+
+  /// @brief Comp と射影後の型 Key の組が基数ソートに置き換えられるか
+  /// @return 昇順なら 1、降順なら -1、置き換えられなければ 0
+  template <class Comp, class Key>
+  constexpr int radix_order() {
+    if constexpr (not radix_sortable<Key>)
+      return 0;
+    else if constexpr (
+      std::is_same_v<Comp, std::ranges::less> or
+      std::is_same_v<Comp, std::less<>> or
+      std::is_same_v<Comp, std::less<Key>>)
+      return 1;
+    else if constexpr (
+      std::is_same_v<Comp, std::ranges::greater> or
+      std::is_same_v<Comp, std::greater<>> or
+      std::is_same_v<Comp, std::greater<Key>>)
+      return -1;
+    else
+      return 0;
+  }
+
+  /// @brief 算術型のキーを LSD 基数ソート (8 ビットずつ) で安定に整列し、
+  /// 添字の列を返す
+  template <class Index, int Order, class R, class Proj>
+  auto radix_argsort(R& r, Proj& proj) -> std::vector<Index> {
+    using Key = std::remove_cvref_t<
+      std::invoke_result_t<Proj&, std::ranges::range_reference_t<R>>>;
+    using U = decltype(radix_key(std::declval<Key>()));
+    constexpr std::size_t digits = sizeof(U);
+
+    const auto n = static_cast<std::size_t>(std::ranges::size(r));
+    std::vector<U> keys(n), keys_tmp(n);
+    std::vector<Index> idx(n), idx_tmp(n);
+    // すべての桁の度数を 1 回の走査で数える
+    std::array<std::array<std::size_t, 256>, digits> counts{};
+    for (auto [i, x] : enumerate_view(r)) {
+      U k = radix_key(static_cast<Key>(std::invoke(proj, x)));
+      if constexpr (Order < 0)
+        k = static_cast<U>(~k);
+      keys[i] = k;
+      idx[i] = static_cast<Index>(i);
+      for (std::size_t d = 0; d < digits; ++d)
+        ++counts[d][(k >> (8 * d)) & 0xff];
+    }
+
+    for (std::size_t d = 0; d < digits; ++d) {
+      auto& count = counts[d];
+      // すべてのキーでこの桁が等しければ並べ替えは不要
+      if (std::ranges::find(count, n) != count.end())
+        continue;
+      std::size_t sum = 0;
+      for (auto& c : count) {
+        const std::size_t m = c;
+        c = sum;
+        sum += m;
+      }
+      for (std::size_t i = 0; i < n; ++i) {
+        const std::size_t pos = count[(keys[i] >> (8 * d)) & 0xff]++;
+        keys_tmp[pos] = keys[i];
+        idx_tmp[pos] = idx[i];
+      }
+      keys.swap(keys_tmp);
+      idx.swap(idx_tmp);
+    }
+    return idx;
+  }
+
+  template <bool Stable, class Index, class R, class Comp, class Proj>
+  auto argsort_impl(R& r, Comp& comp, Proj& proj) -> std::vector<Index> {
+    const auto n = static_cast<std::size_t>(std::ranges::size(r));
+    assert(n == 0 or n - 1 <= std::numeric_limits<Index>::max());
+
+    using Key = std::remove_cvref_t<
+      std::invoke_result_t<Proj&, std::ranges::range_reference_t<R>>>;
+    if constexpr (constexpr int order = radix_order<Comp, Key>(); order != 0) {
+      if (n >= argsort_radix_threshold)
+        return radix_argsort<Index, order>(r, proj);
+    }
+
+    std::vector<Index> idx(n);
+    std::iota(idx.begin(), idx.end(), Index(0));
+    const unsigned threads = n >= argsort_parallel_threshold
+                               ? std::thread::hardware_concurrency()
+                               : 1;
+    parallel_sort_impl<Stable>(
+      idx.begin(),
+      idx.end(),
+      index_comparator<Index>(std::ranges::begin(r), comp, proj),
+      threads);
+    return idx;
+  }
+
+  /// @brief r を comp で整列したときの添字の列を返す
+  /// @details r[idx[0]], r[idx[1]], ... が整列された順になる。算術型のキーを
+  /// std::ranges::less や std::ranges::greater で比較するときは基数ソートを、
+  /// 要素数が多いときは並列の比較ソートを用いる。
+  /// @tparam Index 添字の型 (std::uint32_t とすると添字の列が半分になる)
+  template <
+    std::unsigned_integral Index = std::size_t,
+    std::ranges::random_access_range R,
+    class Comp = std::ranges::less,
+    class Proj = std::identity>
+    requires std::ranges::sized_range<R> and
+             std::indirect_strict_weak_order<
+               Comp,
+               std::projected<std::ranges::iterator_t<R>, Proj>>
+  auto argsort(R&& r, Comp comp = {}, Proj proj = {}) -> std::vector<Index> {
+    return argsort_impl<false, Index>(r, comp, proj);
+  }
+
+  /// @brief argsort と同じだが、等しい要素の添字は昇順に並ぶ
+  template <
+    std::unsigned_integral Index = std::size_t,
+    std::ranges::random_access_range R,
+    class Comp = std::ranges::less,
+    class Proj = std::identity>
+    requires std::ranges::sized_range<R> and
+             std::indirect_strict_weak_order<
+               Comp,
+               std::projected<std::ranges::iterator_t<R>, Proj>>
+  auto stable_argsort(R&& r, Comp comp = {}, Proj proj = {})
+    -> std::vector<Index> {
+    return argsort_impl<true, Index>(r, comp, proj);
+  }
+
+  /// @brief 整列したときに k 番目となる要素の添字を idx[k] に置いた添字の列を
+  /// 返す
+  /// @details idx[0, k) の要素は r[idx[k]] 以下、idx(k, n) の要素は以上である
+  /// (std::nth_element と同じ)。
+  /// @pre k <= size(r)
+  template <
+    std::unsigned_integral Index = std::size_t,
+    std::ranges::random_access_range R,
+    class Comp = std::ranges::less,
+    class Proj = std::identity>
+    requires std::ranges::sized_range<R> and
+             std::indirect_strict_weak_order<
+               Comp,
+               std::projected<std::ranges::iterator_t<R>, Proj>>
+  auto argpartition(R&& r, std::size_t k, Comp comp = {}, Proj proj = {})
+    -> std::vector<Index> {
+    const auto n = static_cast<std::size_t>(std::ranges::size(r));
+    assert(k <= n);
+    assert(n == 0 or n - 1 <= std::numeric_limits<Index>::max());
+    std::vector<Index> idx(n);
+    std::iota(idx.begin(), idx.end(), Index(0));
+    std::nth_element(
+      idx.begin(),
+      idx.begin() + static_cast<std::ptrdiff_t>(k),
+      idx.end(),
+      index_comparator<Index>(std::ranges::begin(r), comp, proj));
+    return idx;
+  }
+} // namespace ns
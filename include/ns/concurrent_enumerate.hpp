@@ -0,0 +1,111 @@
+/// @file concurrent_enumerate.hpp
+#pragma once
+#include <ns/enumerate_view.hpp>
+#include <atomic>
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <mutex>
+#include <optional>
+#include <ranges>
+#include <utility>
+#include <vector>
+
+namespace ns {
+  // concurrent_enumerate
+
+  /// @brief 入力範囲の要素を複数のスレッドが (インデックス, 要素) のバッチ
+  /// 単位で取り出すための共有の供給元
+  /// @details 入力イテレータは複数のスレッドから同時に進められないため、
+  /// pull は mutex の下で最大 count 個の要素を呼び出し側のバッチへムーブし、
+  /// 連続するインデックスの区間をまとめて割り当てる。ロックを保持するのは
+  /// 要素を読み出す間だけで、バッチの処理はロックの外で並列に行える。
+  /// インデックスは全体で一意で、バッチの中では連続し、先に取り出された
+  /// バッチほど小さい。
+  /// @tparam View 元となる view の型 (入力範囲でよい)
+  /// @tparam Index インデックスの型
+  template <std::ranges::input_range View, std::integral Index = std::size_t>
+    requires std::ranges::view<View> and
+             std::movable<std::ranges::range_value_t<View>>
+  struct concurrent_enumerate {
+    using value_type = std::ranges::range_value_t<View>;
+
+    /// @brief pull で取り出した要素の列
+    /// @details 繰り返し pull に渡せば、values の領域を使い回す。
+    struct batch {
+      //! 先頭の要素のインデックス
+      Index start = 0;
+      //! 取り出した要素
+      std::vector<value_type> values;
+
+      /// @brief (インデックス, 要素) の組を走査する view
+      auto pairs() & {
+        return enumerate_view(values, start);
+      }
+      std::size_t size() const noexcept {
+        return values.size();
+      }
+      bool empty() const noexcept {
+        return values.empty();
+      }
+    };
+
+  private:
+    //! 元となる view
+    View base_;
+    //! 次に読み出す要素 (最初の pull で begin を呼ぶ)
+    std::optional<std::ranges::iterator_t<View>> current_;
+    //! 次に割り当てるインデックス
+    Index next_;
+    std::mutex mutex_;
+    //! 末尾に達したか (ロックを取らずに pull を終えるため)
+    std::atomic<bool> exhausted_ = false;
+
+  public:
+    explicit concurrent_enumerate(View base, Index start = 0)
+      : base_(std::move(base)), next_(start) {}
+    concurrent_enumerate(const concurrent_enumerate&) = delete;
+    concurrent_enumerate& operator=(const concurrent_enumerate&) = delete;
+
+    /// @brief 最大 count 個の要素を b に取り出す
+    /// @details b の以前の内容は破棄する。複数のスレッドから同時に呼んでよい。
+    /// @return 1 個以上取り出したか (false のとき b は空)
+    bool pull(batch& b, std::size_t count) {
+      b.values.clear();
+      if (count == 0 or exhausted_.load(std::memory_order_acquire))
+        return false;
+      std::lock_guard lock(mutex_);
+      if (not current_)
+        current_.emplace(std::ranges::begin(base_));
+      auto& it = *current_;
+      const auto last = std::ranges::end(base_);
+      for (; b.values.size() < count and it != last; ++it)
+        b.values.push_back(std::ranges::iter_move(it));
+      if (it == last)
+        exhausted_.store(true, std::memory_order_release);
+      b.start = next_;
+      next_ = advance_index(next_, b.values.size());
+      return not b.values.empty();
+    }
+
+    /// @brief 要素がなくなるまで count 個ずつ取り出し、各 (インデックス, 要素)
+    /// について f を呼ぶ
+    /// @details 各ワーカースレッドから呼ぶ。
+    template <class F>
+      requires std::invocable<F&, Index, value_type&>
+    void for_each(F f, std::size_t count) {
+      batch b;
+      while (pull(b, count))
+        for (std::size_t k = 0; k < b.size(); ++k)
+          std::invoke(f, advance_index(b.start, k), b.values[k]);
+    }
+  };
+
+  template <class Range>
+  concurrent_enumerate(Range&&)
+    -> concurrent_enumerate<std::views::all_t<Range>>;
+  template <class Range, std::integral Index>
+  concurrent_enumerate(Range&&, Index)
+    -> concurrent_enumerate<std::views::all_t<Range>, Index>;
+} // namespace ns
@@ -0,0 +1,386 @@
+/// @file enumerate_nd.hpp
+#pragma once
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <numeric>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+#if __has_include(<mdspan>)
+#include <mdspan>
+#include <span>
+#endif
+
+namespace ns {
+  // 走査の順序
+
+  /// @brief 行優先 (最後の添字が最も速く変わる) の順に走査する
+  struct nd_row_major {};
+
+  /// @brief 格子をタイルに分け、タイルを行優先の順に、タイルの中を行優先の順に
+  /// 走査する
+  /// @details タイルの大きさを L1 キャッシュに収まる程度にすると、記憶域の
+  /// 配置と異なる順に読み書きする処理 (転置など) の局所性がよくなる。
+  template <std::size_t R>
+  struct nd_tiled {
+    std::array<std::size_t, R> tile;
+  };
+
+  /// @brief 格子をタイルに分け、タイルを Morton 順 (Z 順) に、タイルの中を
+  /// 行優先の順に走査する
+  /// @details 各次元のタイルの座標のビットを交互に並べた値 (Morton 符号) の
+  /// 順にタイルを辿るため、近いタイルが時間的にも近くに訪れられ、あらゆる
+  /// 大きさのキャッシュで局所性がよくなる。タイルの大きさを 1 とすると要素
+  /// ごとの Morton 順となる。各次元のタイル数を 2 の冪に切り上げた範囲の符号を
+  /// 辿り、格子の外の符号は読み飛ばす。
+  template <std::size_t R>
+  struct nd_morton {
+    std::array<std::size_t, R> tile;
+  };
+
+  template <std::integral... S>
+  nd_tiled(S...) -> nd_tiled<sizeof...(S)>;
+  template <std::integral... S>
+  nd_morton(S...) -> nd_morton<sizeof...(S)>;
+
+  template <class Order, std::size_t R>
+  inline constexpr bool is_nd_order_v =
+    std::same_as<Order, nd_row_major> or
+    std::same_as<Order, nd_tiled<R>> or
+    std::same_as<Order, nd_morton<R>>;
+
+  // enumerate_nd_view
+
+  /// @brief 多次元の格子の各要素を (添字の配列, 要素) の組として走査する view
+  /// @details 元となる範囲の添字 idx の要素は、offset = Σ idx[d] * strides[d]
+  /// の位置にある。走査では添字を桁上がりで増やし、offset も加減算のみで
+  /// 更新する (除算を用いない)。乗算はタイルや行の切り替わりでのみ行う。
+  /// @tparam View 元となる view の型
+  /// @tparam R 次元数
+  /// @tparam Order 走査の順序 (nd_row_major, nd_tiled<R>, nd_morton<R>)
+  template <std::ranges::random_access_range View, std::size_t R, class Order>
+    requires std::ranges::view<View> and (R > 0) and is_nd_order_v<Order, R>
+  struct enumerate_nd_view
+    : std::ranges::view_interface<enumerate_nd_view<View, R, Order>> {
+  public:
+    using index_type = std::array<std::size_t, R>;
+
+  private:
+    //! 元となる view
+    View base_ = View();
+    //! 各次元の大きさ
+    index_type extents_{};
+    //! 各次元の添字が 1 増えたときの、元となる範囲の位置の増分
+    index_type strides_{};
+    //! 走査の順序
+    Order order_{};
+
+    template <bool Const>
+    struct iterator;
+
+  public:
+    enumerate_nd_view()
+      requires std::default_initializable<View>
+    = default;
+    constexpr enumerate_nd_view(
+      View base,
+      index_type extents,
+      index_type strides,
+      Order order = {})
+      : base_(std::move(base)),
+        extents_(extents),
+        strides_(strides),
+        order_(order) {}
+
+    constexpr View base() const&
+      requires std::copy_constructible<View>
+    {
+      return base_;
+    }
+    constexpr View base() && {
+      return std::move(base_);
+    }
+
+    constexpr const index_type& extents() const noexcept {
+      return extents_;
+    }
+    constexpr const index_type& strides() const noexcept {
+      return strides_;
+    }
+
+    constexpr iterator<false> begin() {
+      return {std::ranges::begin(base_), extents_, strides_, order_};
+    }
+    constexpr iterator<true> begin() const
+      requires std::ranges::random_access_range<const View>
+    {
+      return {std::ranges::begin(base_), extents_, strides_, order_};
+    }
+    constexpr std::default_sentinel_t end() const noexcept {
+      return std::default_sentinel;
+    }
+
+    constexpr std::size_t size() const noexcept {
+      return std::reduce(
+        extents_.begin(), extents_.end(), std::size_t(1), std::multiplies());
+    }
+  };
+
+  template <std::ranges::random_access_range View, std::size_t R, class Order>
+    requires std::ranges::view<View> and (R > 0) and is_nd_order_v<Order, R>
+  template <bool Const>
+  struct enumerate_nd_view<View, R, Order>::iterator {
+  private:
+    using Base = std::conditional_t<Const, const View, View>;
+    template <bool>
+    friend struct iterator;
+
+    //! 元となる範囲の先頭
+    std::ranges::iterator_t<Base> first_ = std::ranges::iterator_t<Base>();
+    index_type extents_{};
+    index_type strides_{};
+    //! 現在の添字
+    index_type index_{};
+    //! 現在の要素の位置
+    std::size_t offset_ = 0;
+    //! 現在の要素を含めた残りの要素数 (末尾では 0)
+    std::size_t remaining_ = 0;
+    //! 現在のタイルの範囲 [lo_, hi_)
+    index_type lo_{};
+    index_type hi_{};
+    //! タイルの大きさ
+    index_type tile_{};
+    //! 各次元のタイルの数
+    index_type tiles_{};
+    //! 現在のタイルの座標 (nd_tiled)、Morton 符号 (nd_morton)
+    index_type tile_pos_{};
+    std::uint64_t code_ = 0;
+    //! Morton 符号の上限と、各次元の座標のビット数
+    std::uint64_t code_end_ = 0;
+    std::array<unsigned, R> bits_{};
+
+    /// @brief タイルの座標 pos のタイルに移る
+    constexpr void enter_tile(const index_type& pos) {
+      offset_ = 0;
+      for (std::size_t d = 0; d < R; ++d) {
+        lo_[d] = pos[d] * tile_[d];
+        hi_[d] = std::min(lo_[d] + tile_[d], extents_[d]);
+        index_[d] = lo_[d];
+        offset_ += lo_[d] * strides_[d];
+      }
+    }
+
+    /// @brief Morton 符号をタイルの座標に戻す
+    /// @details ビット数の多い次元ほど上位のビットを多くもつ。各桁では、まだ
+    /// ビットの残る次元のみが符号のビットを受け取る。
+    constexpr bool decode(std::uint64_t code, index_type& pos) const {
+      pos.fill(0);
+      const unsigned levels = *std::ranges::max_element(bits_);
+      for (unsigned b = 0; b < levels; ++b)
+        for (std::size_t d = R; d-- > 0;)
+          if (b < bits_[d]) {
+            pos[d] |= static_cast<std::size_t>(code & 1) << b;
+            code >>= 1;
+          }
+      for (std::size_t d = 0; d < R; ++d)
+        if (pos[d] >= tiles_[d])
+          return false;
+      return true;
+    }
+
+    /// @brief 次のタイルに移る
+    constexpr void next_tile() {
+      if constexpr (std::same_as<Order, nd_tiled<R>>) {
+        for (std::size_t d = R; d-- > 0;) {
+          if (++tile_pos_[d] < tiles_[d])
+            break;
+          tile_pos_[d] = 0;
+        }
+        enter_tile(tile_pos_);
+      } else if constexpr (std::same_as<Order, nd_morton<R>>) {
+        index_type pos{};
+        while (++code_ < code_end_)
+          if (decode(code_, pos))
+            break;
+        enter_tile(pos);
+      }
+    }
+
+  public:
+    using difference_type = std::ptrdiff_t;
+    using value_type =
+      std::pair<index_type, std::ranges::range_value_t<Base>>;
+    using iterator_concept = std::forward_iterator_tag;
+    using iterator_category = std::input_iterator_tag;
+
+    iterator()
+      requires std::default_initializable<std::ranges::iterator_t<Base>>
+    = default;
+    constexpr iterator(
+      std::ranges::iterator_t<Base> first,
+      const index_type& extents,
+      const index_type& strides,
+      [[maybe_unused]] Order order)
+      : first_(std::move(first)), extents_(extents), strides_(strides) {
+      remaining_ = std::reduce(
+        extents.begin(), extents.end(), std::size_t(1), std::multiplies());
+      if (remaining_ == 0)
+        return;
+      if constexpr (std::same_as<Order, nd_row_major>) {
+        tile_ = extents_;
+      } else {
+        for (std::size_t d = 0; d < R; ++d) {
+          assert(order.tile[d] > 0);
+          tile_[d] = std::min(order.tile[d], extents_[d]);
+        }
+      }
+      for (std::size_t d = 0; d < R; ++d) {
+        tiles_[d] = (extents_[d] + tile_[d] - 1) / tile_[d];
+        bits_[d] = static_cast<unsigned>(std::bit_width(tiles_[d] - 1));
+      }
+      if constexpr (std::same_as<Order, nd_morton<R>>) {
+        unsigned total = 0;
+        for (unsigned b : bits_)
+          total += b;
+        assert(total < 64);
+        code_end_ = std::uint64_t(1) << total;
+      }
+      enter_tile(tile_pos_);
+    }
+    constexpr /* implicit */ iterator(iterator<not Const> other)
+      requires Const and std::convertible_to<
+                           std::ranges::iterator_t<View>,
+                           std::ranges::iterator_t<Base>>
+      : first_(std::move(other.first_)),
+        extents_(other.extents_),
+        strides_(other.strides_),
+        index_(other.index_),
+        offset_(other.offset_),
+        remaining_(other.remaining_),
+        lo_(other.lo_),
+        hi_(other.hi_),
+        tile_(other.tile_),
+        tiles_(other.tiles_),
+        tile_pos_(other.tile_pos_),
+        code_(other.code_),
+        code_end_(other.code_end_),
+        bits_(other.bits_) {}
+
+    /// @brief 現在の添字
+    constexpr const index_type& index() const noexcept {
+      return index_;
+    }
+    /// @brief 現在の要素の、元となる範囲における位置
+    constexpr std::size_t offset() const noexcept {
+      return offset_;
+    }
+
+    constexpr std::pair<index_type, std::ranges::range_reference_t<Base>>
+    operator*() const {
+      return {
+        index_,
+        first_[static_cast<std::ranges::range_difference_t<Base>>(offset_)]};
+    }
+
+    constexpr iterator& operator++() {
+      if (--remaining_ == 0)
+        return *this;
+      // 最後の次元の添字を増やす (多くの場合はここで終わる)
+      if (++index_[R - 1] < hi_[R - 1]) {
+        offset_ += strides_[R - 1];
+        return *this;
+      }
+      // 桁上がり
+      for (std::size_t d = R - 1; d > 0; --d) {
+        offset_ -= (index_[d] - 1 - lo_[d]) * strides_[d];
+        index_[d] = lo_[d];
+        if (++index_[d - 1] < hi_[d - 1]) {
+          offset_ += strides_[d - 1];
+          return *this;
+        }
+      }
+      next_tile();
+      return *this;
+    }
+    constexpr iterator operator++(int) {
+      auto tmp = *this;
+      ++*this;
+      return tmp;
+    }
+
+    friend constexpr bool operator==(const iterator& x, const iterator& y) {
+      return x.remaining_ == y.remaining_;
+    }
+    friend constexpr bool
+    operator==(const iterator& x, std::default_sentinel_t) noexcept {
+      return x.remaining_ == 0;
+    }
+  };
+
+  // enumerate_nd
+
+  /// @brief 行優先で格納された格子を (添字の配列, 要素) の組として走査する
+  /// @param r 格子の要素 (最後の次元が連続する、大きさ Π extents 以上)
+  /// @param extents 各次元の大きさ
+  /// @param order 走査の順序
+  template <
+    std::ranges::viewable_range Range,
+    std::size_t R,
+    class Order = nd_row_major>
+    requires std::ranges::random_access_range<Range> and
+             is_nd_order_v<Order, R>
+  constexpr auto enumerate_nd(
+    Range&& r,
+    const std::array<std::size_t, R>& extents,
+    Order order = {}) {
+    std::array<std::size_t, R> strides;
+    std::size_t stride = 1;
+    for (std::size_t d = R; d-- > 0;) {
+      strides[d] = stride;
+      stride *= extents[d];
+    }
+    if constexpr (std::ranges::sized_range<Range>)
+      assert(std::cmp_less_equal(stride, std::ranges::size(r)));
+    return enumerate_nd_view<std::views::all_t<Range>, R, Order>(
+      std::views::all(std::forward<Range>(r)), extents, strides, order);
+  }
+
+#if defined(__cpp_lib_mdspan)
+  /// @brief std::mdspan の各要素を (添字の配列, 要素) の組として走査する
+  /// @details 記憶域の配置は mapping の stride に従う (layout_right,
+  /// layout_left, layout_stride)。
+  template <
+    class T,
+    class Extents,
+    class Layout,
+    class Accessor,
+    class Order = nd_row_major>
+    requires std::same_as<
+               typename Accessor::data_handle_type,
+               typename Accessor::element_type*> and
+             Layout::template mapping<Extents>::is_always_strided() and
+             is_nd_order_v<Order, Extents::rank()>
+  constexpr auto
+  enumerate_nd(std::mdspan<T, Extents, Layout, Accessor> m, Order order = {}) {
+    constexpr std::size_t R = Extents::rank();
+    std::array<std::size_t, R> extents;
+    std::array<std::size_t, R> strides;
+    for (std::size_t d = 0; d < R; ++d) {
+      extents[d] = static_cast<std::size_t>(m.extent(d));
+      strides[d] = static_cast<std::size_t>(m.stride(d));
+    }
+    return enumerate_nd_view<std::span<T>, R, Order>(
+      std::span<T>(m.data_handle(), m.mapping().required_span_size()),
+      extents,
+      strides,
+      order);
+  }
+#endif
+} // namespace ns
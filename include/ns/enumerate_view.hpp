@@ -1,45 +1,168 @@
 /// @file enumerate_view.hpp
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cassert>
 #include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <iterator>
+#include <limits>
+#include <memory>
 #include <ranges>
+#include <span>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 namespace ns {
+  /// @brief インデックス start から n だけ進めたインデックスを返す
+  /// @details NDEBUG が定義されていなければ、結果が Index で表せるかを検査する
+  template <std::integral Index, std::integral N>
+  constexpr Index advance_index(Index start, N n) {
+    assert(std::cmp_greater_equal(n, 0));
+    assert(std::cmp_less_equal(n, std::numeric_limits<Index>::max()));
+    assert(start <= std::numeric_limits<Index>::max() - static_cast<Index>(n));
+    return static_cast<Index>(start + static_cast<Index>(n));
+  }
+
   /// @tparam View 元となる view の型
-  template <std::ranges::input_range View>
+  /// @tparam Index インデックスの型
+  template <std::ranges::input_range View, std::integral Index = std::size_t>
     requires std::ranges::view<View>
-  struct enumerate_view : std::ranges::view_interface<enumerate_view<View>> {
+  struct enumerate_view
+    : std::ranges::view_interface<enumerate_view<View, Index>> {
   private:
     //! 元となる view
     View base_ = View();
+    //! 先頭要素のインデックス
+    Index start_ = 0;
 
     template <bool Const>
     struct iterator;
     template <bool Const>
     struct sentinel;
+    //! イテレータが保持しないメンバの型
+    struct no_member {};
+
+    template <class Base>
+    using piece_t = enumerate_view<
+      std::ranges::subrange<std::ranges::iterator_t<Base>>,
+      Index>;
+
+    /// @brief base の [first, first + len) を、インデックス start + offset から
+    /// 始まる部分 view として切り出す
+    template <class Base>
+    static constexpr piece_t<Base> make_piece(
+      Base& base,
+      Index start,
+      std::size_t offset,
+      std::size_t len) {
+      auto first = std::ranges::begin(base) +
+                   static_cast<std::ranges::range_difference_t<Base>>(offset);
+      auto last =
+        first + static_cast<std::ranges::range_difference_t<Base>>(len);
+      return {
+        std::ranges::subrange(first, last), advance_index(start, offset)};
+    }
+
+    template <class Base>
+    static constexpr std::vector<piece_t<Base>>
+    partition_impl(Base& base, Index start, std::size_t k) {
+      assert(k > 0);
+      const auto n = static_cast<std::size_t>(std::ranges::size(base));
+      std::vector<piece_t<Base>> pieces;
+      pieces.reserve(k);
+      for (std::size_t i = 0, offset = 0; i < k; ++i) {
+        const std::size_t len = n / k + (i < n % k ? 1 : 0);
+        pieces.push_back(make_piece(base, start, offset, len));
+        offset += len;
+      }
+      return pieces;
+    }
+
+    template <class Base>
+    static constexpr std::vector<piece_t<Base>>
+    chunk_impl(Base& base, Index start, std::size_t len) {
+      assert(len > 0);
+      const auto n = static_cast<std::size_t>(std::ranges::size(base));
+      std::vector<piece_t<Base>> pieces;
+      pieces.reserve((n + len - 1) / len);
+      for (std::size_t offset = 0; offset < n; offset += len)
+        pieces.push_back(
+          make_piece(base, start, offset, std::min(len, n - offset)));
+      return pieces;
+    }
+
+    template <class Base>
+    static constexpr auto
+    batches_impl(Base& base, Index start, std::size_t len) {
+      assert(len > 0);
+      const auto n = static_cast<std::size_t>(std::ranges::size(base));
+      const auto data = std::ranges::data(base);
+      return std::views::iota(std::size_t(0), (n + len - 1) / len) |
+             std::views::transform([=](std::size_t k) {
+               const std::size_t offset = k * len;
+               return std::pair(
+                 advance_index(start, offset),
+                 std::span(data + offset, std::min(len, n - offset)));
+             });
+    }
 
   public:
     enumerate_view()
       requires std::default_initializable<View>
     = default;
     constexpr enumerate_view(View base) : base_(std::move(base)) {}
+    /// @param start 先頭要素のインデックス
+    constexpr enumerate_view(View base, Index start)
+      : base_(std::move(base)), start_(start) {}
+
+    constexpr View base() const&
+      requires std::copy_constructible<View>
+    {
+      return base_;
+    }
+    constexpr View base() && {
+      return std::move(base_);
+    }
+    /// @brief 元となる view への参照 (View がコピーできなくても使える)
+    constexpr const View& base_ref() const noexcept {
+      return base_;
+    }
+
+    /// @brief 先頭要素のインデックス
+    constexpr Index start() const noexcept {
+      return start_;
+    }
 
     constexpr iterator<false> begin() {
-      return {std::ranges::begin(base_), 0};
+      if constexpr (std::ranges::random_access_range<View>)
+        return {*this, std::ranges::begin(base_)};
+      else
+        return {std::ranges::begin(base_), start_};
     }
     constexpr iterator<true> begin() const
       requires std::ranges::input_range<const View>
     {
-      return {std::ranges::begin(base_), 0};
+      if constexpr (std::ranges::random_access_range<const View>)
+        return {*this, std::ranges::begin(base_)};
+      else
+        return {std::ranges::begin(base_), start_};
     }
 
     constexpr auto end() {
       if constexpr (
+        std::ranges::common_range<View> and //
+        std::ranges::random_access_range<View>)
+        return iterator<false>(*this, std::ranges::end(base_));
+      else if constexpr (
         std::ranges::common_range<View> and //
         std::ranges::sized_range<View>)
         return iterator<false>(
-          std::ranges::end(base_), std::ranges::size(base_));
+          std::ranges::end(base_),
+          advance_index(start_, std::ranges::size(base_)));
       else
         return sentinel<false>(std::ranges::end(base_));
     }
@@ -47,10 +170,15 @@ namespace ns {
       requires std::ranges::input_range<const View>
     {
       if constexpr (
+        std::ranges::common_range<const View> and //
+        std::ranges::random_access_range<const View>)
+        return iterator<true>(*this, std::ranges::end(base_));
+      else if constexpr (
         std::ranges::common_range<const View> and //
         std::ranges::sized_range<const View>)
         return iterator<true>(
-          std::ranges::end(base_), std::ranges::size(base_));
+          std::ranges::end(base_),
+          advance_index(start_, std::ranges::size(base_)));
       else
         return sentinel<true>(std::ranges::end(base_));
     }
@@ -65,37 +193,148 @@ namespace ns {
     {
       return std::ranges::size(base_);
     }
+
+    /// @brief 要素数の差が高々 1 となる k 個の部分 view に分割する
+    /// @details 各部分 view のインデックスは分割前の通し番号を引き継ぐため、
+    /// そのままスレッドプールや std::execution に渡すことができる。
+    /// @pre k > 0
+    constexpr auto partition(std::size_t k)
+      requires std::ranges::random_access_range<View> and
+               std::ranges::sized_range<View>
+    {
+      return partition_impl(base_, start_, k);
+    }
+    constexpr auto partition(std::size_t k) const
+      requires std::ranges::random_access_range<const View> and
+               std::ranges::sized_range<const View>
+    {
+      return partition_impl(base_, start_, k);
+    }
+
+    /// @brief 先頭から len 個ずつの部分 view に分割する (末尾は len 個未満)
+    /// @details 各部分 view のインデックスは分割前の通し番号を引き継ぐ。
+    /// @pre len > 0
+    constexpr auto chunk(std::size_t len)
+      requires std::ranges::random_access_range<View> and
+               std::ranges::sized_range<View>
+    {
+      return chunk_impl(base_, start_, len);
+    }
+    constexpr auto chunk(std::size_t len) const
+      requires std::ranges::random_access_range<const View> and
+               std::ranges::sized_range<const View>
+    {
+      return chunk_impl(base_, start_, len);
+    }
+
+    /// @brief 先頭から len 個ずつの (先頭のインデックス, std::span) の組を
+    /// 走査する view を返す (末尾は len 個未満)
+    /// @details 元となる範囲が連続しているときのみ使える。ブロックの k 番目の
+    /// 要素のインデックスは先頭のインデックス + k であり、ブロックの中のループは
+    /// ベクトル化できる。
+    /// @pre len > 0
+    constexpr auto batches(std::size_t len)
+      requires std::ranges::contiguous_range<View> and
+               std::ranges::sized_range<View>
+    {
+      return batches_impl(base_, start_, len);
+    }
+    constexpr auto batches(std::size_t len) const
+      requires std::ranges::contiguous_range<const View> and
+               std::ranges::sized_range<const View>
+    {
+      return batches_impl(base_, start_, len);
+    }
   };
 
   template <class Range>
   enumerate_view(Range&&) -> enumerate_view<std::views::all_t<Range>>;
+  template <class Range, std::integral Index>
+  enumerate_view(Range&&, Index)
+    -> enumerate_view<std::views::all_t<Range>, Index>;
 
   template <class View>
   struct deduce_iterator_category {};
 
+  /// @brief 元となるイテレータの iterator_category を引き継ぐ
+  /// @details operator* は prvalue の pair (プロキシ参照) を返すため、厳密には
+  /// _Cpp17ForwardIterator_ の要件を満たさない。しかし要素の読み出しと元の範囲
+  /// への書き込みはプロキシ経由で行えるため、std::execution の並列アルゴリズム
+  /// が作業を分割できるよう、元となるイテレータと同じカテゴリを公開する。
   template <class View>
     requires requires {
       typename std::iterator_traits<
         std::ranges::iterator_t<View>>::iterator_category;
     }
   struct deduce_iterator_category<View> {
-    using iterator_category = std::input_iterator_tag;
+  private:
+    using C = typename std::iterator_traits<
+      std::ranges::iterator_t<View>>::iterator_category;
+
+  public:
+    // clang-format off
+    using iterator_category =
+      std::conditional_t<std::ranges::random_access_range<View> and std::derived_from<C, std::random_access_iterator_tag>, std::random_access_iterator_tag,
+      std::conditional_t<std::ranges::bidirectional_range<View> and std::derived_from<C, std::bidirectional_iterator_tag>, std::bidirectional_iterator_tag,
+      std::conditional_t<std::ranges::forward_range<View> and std::derived_from<C, std::forward_iterator_tag>,             std::forward_iterator_tag,
+      /* else */                                                                                                             std::input_iterator_tag>>>;
+    // clang-format on
   };
 
-  template <std::ranges::input_range View>
+  template <std::ranges::input_range View, std::integral Index>
     requires std::ranges::view<View>
   template <bool Const>
-  struct enumerate_view<View>::iterator : deduce_iterator_category<View> {
+  struct enumerate_view<View, Index>::iterator
+    : deduce_iterator_category<std::conditional_t<Const, const View, View>> {
   private:
+    using Parent =
+      std::conditional_t<Const, const enumerate_view, enumerate_view>;
     using Base = std::conditional_t<Const, const View, View>;
+    template <bool>
+    friend struct iterator;
+
+    //! random_access_range のとき、インデックスを親の view の先頭からの距離で
+    //! 求める
+    static constexpr bool index_by_difference =
+      std::ranges::random_access_range<Base>;
+
     //! 元となるイテレータの現在位置
     std::ranges::iterator_t<Base> current_ = std::ranges::iterator_t<Base>();
+    //! 親の view (index_by_difference のときのみ保持する)
+    [[no_unique_address]] std::
+      conditional_t<index_by_difference, Parent*, no_member> parent_ = {};
+    //! 現在のインデックス (index_by_difference のときは保持しない)
+    [[no_unique_address]] std::
+      conditional_t<index_by_difference, no_member, Index> count_ = {};
+
     //! 現在のインデックス
-    std::size_t count_ = 0;
+    constexpr Index index() const {
+      if constexpr (index_by_difference)
+        return advance_index(parent_->start_, offset());
+      else
+        return count_;
+    }
+
+    //! 親の view の先頭からの距離 (index_by_difference のときのみ使う)
+    constexpr auto offset() const {
+      const auto first = std::ranges::begin(parent_->base_);
+      if constexpr (std::contiguous_iterator<std::ranges::iterator_t<Base>>) {
+        // ポインタの差は符号付きの除算となり、GCC はそれを含むループを
+        // ベクトル化しないため、実行時は符号なしのバイト数の差から求める
+        if (not std::is_constant_evaluated()) {
+          using T = std::iter_value_t<std::ranges::iterator_t<Base>>;
+          const auto bytes =
+            reinterpret_cast<std::uintptr_t>(std::to_address(current_)) -
+            reinterpret_cast<std::uintptr_t>(std::to_address(first));
+          return static_cast<std::size_t>(bytes / sizeof(T));
+        }
+      }
+      return static_cast<std::size_t>(current_ - first);
+    }
 
   public:
     using difference_type = std::ranges::range_difference_t<Base>;
-    using value_type = std::pair<std::size_t, std::ranges::range_value_t<Base>>;
+    using value_type = std::pair<Index, std::ranges::range_value_t<Base>>;
     // clang-format off
     using iterator_concept =
       std::conditional_t<std::ranges::random_access_range<Base>, std::random_access_iterator_tag,
@@ -107,14 +346,24 @@ namespace ns {
     iterator()
       requires std::default_initializable<std::ranges::iterator_t<Base>>
     = default;
-    constexpr iterator(std::ranges::iterator_t<Base> current, std::size_t count)
+    constexpr iterator(std::ranges::iterator_t<Base> current, Index count)
+      requires(not index_by_difference)
       : current_(std::move(current)), count_(std::move(count)) {}
+    /// @details イテレータは親の view を指すため、view を移動または破棄すると
+    /// 無効になる。
+    constexpr iterator(Parent& parent, std::ranges::iterator_t<Base> current)
+      requires index_by_difference
+      : current_(std::move(current)), parent_(std::addressof(parent)) {}
     constexpr /* implicit */ iterator(iterator<not Const> other)
       requires Const and
                  std::convertible_to<
                    std::ranges::iterator_t<View>,
-                   std::ranges::iterator_t<Base>>
-      : current_(std::move(other.current_)), count_(std::move(other.count_)) {}
+                   std::ranges::iterator_t<Base>> and
+                 (iterator<not Const>::index_by_difference ==
+                  index_by_difference)
+      : current_(std::move(other.current_)),
+        parent_(other.parent_),
+        count_(std::move(other.count_)) {}
 
     constexpr const std::ranges::iterator_t<Base>& base() const& noexcept {
       return current_;
@@ -123,14 +372,15 @@ namespace ns {
       return std::move(current_);
     }
 
-    constexpr std::pair<std::size_t, std::ranges::range_reference_t<Base>>
+    constexpr std::pair<Index, std::ranges::range_reference_t<Base>>
     operator*() const {
-      return {count_, *current_};
+      return {index(), *current_};
     }
 
     constexpr iterator& operator++() {
       ++current_;
-      ++count_;
+      if constexpr (not index_by_difference)
+        count_ = advance_index(count_, 1);
       return *this;
     }
     constexpr void operator++(int) {
@@ -148,7 +398,10 @@ namespace ns {
       requires std::ranges::bidirectional_range<Base>
     {
       --current_;
-      --count_;
+      if constexpr (not index_by_difference) {
+        assert(count_ != std::numeric_limits<Index>::min());
+        --count_;
+      }
       return *this;
     }
     constexpr iterator operator--(int)
@@ -163,7 +416,6 @@ namespace ns {
       requires std::ranges::random_access_range<Base>
     {
       current_ += n;
-      count_ += n;
       return *this;
     }
     constexpr iterator& operator-=(difference_type n) //
@@ -171,7 +423,7 @@ namespace ns {
     {
       return *this += -n;
     }
-    constexpr std::pair<std::size_t, std::ranges::range_reference_t<Base>>
+    constexpr std::pair<Index, std::ranges::range_reference_t<Base>>
     operator[](difference_type n) const //
       requires std::ranges::random_access_range<Base>
     {
@@ -237,17 +489,17 @@ namespace ns {
     }
 
     friend constexpr std::
-      pair<std::size_t, std::ranges::range_rvalue_reference_t<View>>
+      pair<Index, std::ranges::range_rvalue_reference_t<View>>
       iter_move(const iterator& x) noexcept(
         noexcept(std::ranges::iter_move(x.current_))) {
-      return {x.count_, std::ranges::iter_move(x.current_)};
+      return {x.index(), std::ranges::iter_move(x.current_)};
     }
   };
 
-  template <std::ranges::input_range View>
+  template <std::ranges::input_range View, std::integral Index>
     requires std::ranges::view<View>
   template <bool Const>
-  struct enumerate_view<View>::sentinel {
+  struct enumerate_view<View, Index>::sentinel {
   private:
     using Base = std::conditional_t<Const, const View, View>;
     //! 元となる view の番兵イテレータ
@@ -292,4 +544,91 @@ namespace ns {
       return x.end_ - y.base();
     }
   };
+
+  // for_each_batch
+
+  /// @brief for_each_batch がブロックを渡す std::span の要素の型
+  /// @details 元となる範囲が連続していればその要素の型、そうでなければ作業
+  /// 領域の要素の型 (元の範囲へ書き込めないときは const) となる。
+  template <class View>
+  using batch_element_t = std::conditional_t<
+    std::ranges::contiguous_range<View> and std::ranges::sized_range<View>,
+    std::remove_reference_t<std::ranges::range_reference_t<View>>,
+    std::conditional_t<
+      std::indirectly_writable<
+        std::ranges::iterator_t<View>,
+        std::ranges::range_value_t<View>>,
+      std::ranges::range_value_t<View>,
+      const std::ranges::range_value_t<View>>>;
+
+  /// @brief ev を先頭から N 個ずつのブロックに分け、各ブロックについて
+  /// batch(先頭のインデックス, std::span<T, N>) を呼び、末尾の N 個未満の要素
+  /// について scalar(インデックス, 要素) を呼ぶ
+  /// @details ブロックの k 番目の要素のインデックスは先頭のインデックス + k で
+  /// あり、要素数も定数であるため、batch の中のループはインデックスに依存する
+  /// 計算を含めてベクトル化できる。元となる範囲が連続していれば、その要素を
+  /// 直接指す span を渡す。そうでなければブロックを作業領域に写して渡し、
+  /// 元の範囲へ書き込めるときは batch の後に書き戻す。
+  ///
+  /// SSE2 や AVX2 には 64 ビット整数を浮動小数点数に変換するベクトル命令が
+  /// ないため、batch の中では先頭のインデックスをブロックごとに 1 回だけ変換し、
+  /// k は int で数えるとよい。
+  template <
+    std::size_t N,
+    class View,
+    std::integral Index,
+    class Batch,
+    class Scalar>
+    requires(N > 0) and std::ranges::forward_range<View> and
+            std::invocable<
+              Batch&,
+              Index,
+              std::span<batch_element_t<View>, N>> and
+            std::invocable<
+              Scalar&,
+              Index,
+              std::ranges::range_reference_t<View>>
+  constexpr void for_each_batch(
+    enumerate_view<View, Index> ev,
+    Batch batch,
+    Scalar scalar) {
+    const Index start = ev.start();
+    View base = std::move(ev).base();
+    using T = batch_element_t<View>;
+
+    if constexpr (
+      std::ranges::contiguous_range<View> and std::ranges::sized_range<View>) {
+      T* const data = std::ranges::data(base);
+      const auto n = static_cast<std::size_t>(std::ranges::size(base));
+      std::size_t offset = 0;
+      for (; n - offset >= N; offset += N)
+        std::invoke(
+          batch,
+          advance_index(start, offset),
+          std::span<T, N>(data + offset, N));
+      for (; offset < n; ++offset)
+        std::invoke(scalar, advance_index(start, offset), data[offset]);
+    } else {
+      constexpr bool writable = not std::is_const_v<T>;
+      std::array<std::remove_const_t<T>, N> buffer;
+      auto it = std::ranges::begin(base);
+      const auto last = std::ranges::end(base);
+      for (std::size_t offset = 0;; offset += N) {
+        auto block = it;
+        std::size_t k = 0;
+        for (; k < N and it != last; ++k, ++it)
+          buffer[k] = *it;
+        if (k < N) {
+          for (std::size_t j = 0; j < k; ++j, ++block)
+            std::invoke(scalar, advance_index(start, offset + j), *block);
+          return;
+        }
+        std::invoke(
+          batch, advance_index(start, offset), std::span<T, N>(buffer));
+        if constexpr (writable)
+          for (auto& x : buffer)
+            *block++ = std::move(x);
+      }
+    }
+  }
 } // namespace ns
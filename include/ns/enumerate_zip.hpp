@@ -0,0 +1,248 @@
+/// @file enumerate_zip.hpp
+#pragma once
+#include <algorithm>
+#include <cassert>
+#include <compare>
+#include <concepts>
+#include <cstddef>
+#include <iterator>
+#include <limits>
+#include <ranges>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace ns {
+  /// @brief 複数の列を、行のインデックスとともに同時に走査する view
+  /// @details 各列はランダムアクセスできるため、イテレータは各列の先頭と
+  /// 共通のインデックス 1 つのみを保持し、進める際はインデックスのみを
+  /// 更新する。要素は (インデックス, 各列の要素の参照...) の平坦な std::tuple
+  /// となり、tuple_select や tuple_select_by_type でそのまま射影できる。
+  /// std::views::zip と enumerate_view を重ねたときの
+  /// pair<Index, tuple<...>> のような入れ子のプロキシは作らない。要素数は
+  /// 最も短い列の要素数となる。
+  /// @tparam Index インデックスの型
+  /// @tparam Views 各列の view の型
+  template <
+    std::integral Index,
+    std::ranges::random_access_range... Views>
+    requires(sizeof...(Views) > 0) and
+            (std::ranges::view<Views> and ...) and
+            (std::ranges::sized_range<Views> and ...)
+  struct enumerate_zip_view
+    : std::ranges::view_interface<enumerate_zip_view<Index, Views...>> {
+  private:
+    //! 各列
+    std::tuple<Views...> bases_ = std::tuple<Views...>();
+
+    template <bool Const>
+    struct iterator;
+
+    template <bool Const>
+    static constexpr bool all_random_access =
+      (std::ranges::random_access_range<
+         std::conditional_t<Const, const Views, Views>> and
+       ...);
+
+    template <class Bases>
+    static constexpr Index size_impl(Bases& bases) {
+      return std::apply(
+        [](auto&... base) {
+          const auto n = std::min({static_cast<std::size_t>(
+            std::ranges::size(base))...});
+          assert(std::cmp_less_equal(n, std::numeric_limits<Index>::max()));
+          return static_cast<Index>(n);
+        },
+        bases);
+    }
+
+    template <bool Const, class Bases>
+    static constexpr iterator<Const> iterator_at(Bases& bases, Index index) {
+      return std::apply(
+        [index](auto&... base) {
+          return iterator<Const>(index, std::ranges::begin(base)...);
+        },
+        bases);
+    }
+
+  public:
+    enumerate_zip_view()
+      requires(std::default_initializable<Views> and ...)
+    = default;
+    constexpr explicit enumerate_zip_view(Views... bases)
+      : bases_(std::move(bases)...) {}
+
+    constexpr iterator<false> begin() {
+      return iterator_at<false>(bases_, 0);
+    }
+    constexpr iterator<true> begin() const
+      requires all_random_access<true>
+    {
+      return iterator_at<true>(bases_, 0);
+    }
+    constexpr iterator<false> end() {
+      return iterator_at<false>(bases_, size());
+    }
+    constexpr iterator<true> end() const
+      requires all_random_access<true>
+    {
+      return iterator_at<true>(bases_, size());
+    }
+
+    constexpr Index size() {
+      return size_impl(bases_);
+    }
+    constexpr Index size() const
+      requires(std::ranges::sized_range<const Views> and ...)
+    {
+      return size_impl(bases_);
+    }
+  };
+
+  template <
+    std::integral Index,
+    std::ranges::random_access_range... Views>
+    requires(sizeof...(Views) > 0) and
+            (std::ranges::view<Views> and ...) and
+            (std::ranges::sized_range<Views> and ...)
+  template <bool Const>
+  struct enumerate_zip_view<Index, Views...>::iterator {
+  private:
+    template <class View>
+    using base_t = std::conditional_t<Const, const View, View>;
+    template <bool>
+    friend struct iterator;
+
+    //! 各列の先頭
+    std::tuple<std::ranges::iterator_t<base_t<Views>>...> begins_ =
+      std::tuple<std::ranges::iterator_t<base_t<Views>>...>();
+    //! 現在のインデックス
+    Index index_ = 0;
+
+    template <class View>
+    constexpr auto offset() const {
+      return static_cast<std::ranges::range_difference_t<base_t<View>>>(
+        index_);
+    }
+
+  public:
+    using difference_type = std::ptrdiff_t;
+    using value_type =
+      std::tuple<Index, std::ranges::range_value_t<base_t<Views>>...>;
+    using reference =
+      std::tuple<Index, std::ranges::range_reference_t<base_t<Views>>...>;
+    using iterator_concept = std::random_access_iterator_tag;
+    using iterator_category = std::input_iterator_tag;
+
+    iterator() = default;
+    constexpr iterator(
+      Index index,
+      std::ranges::iterator_t<base_t<Views>>... begins)
+      : begins_(std::move(begins)...), index_(index) {}
+    constexpr /* implicit */ iterator(iterator<not Const> other)
+      requires Const and
+               (std::convertible_to<
+                  std::ranges::iterator_t<Views>,
+                  std::ranges::iterator_t<const Views>> and
+                ...)
+      : begins_(std::move(other.begins_)), index_(other.index_) {}
+
+    /// @brief 現在のインデックス
+    constexpr Index index() const noexcept {
+      return index_;
+    }
+
+    constexpr reference operator*() const {
+      return std::apply(
+        [this](const auto&... begin) {
+          return reference(index_, begin[offset<Views>()]...);
+        },
+        begins_);
+    }
+    constexpr reference operator[](difference_type n) const {
+      return *(*this + n);
+    }
+
+    constexpr iterator& operator++() {
+      ++index_;
+      return *this;
+    }
+    constexpr iterator operator++(int) {
+      auto tmp = *this;
+      ++*this;
+      return tmp;
+    }
+    constexpr iterator& operator--() {
+      assert(index_ != 0);
+      --index_;
+      return *this;
+    }
+    constexpr iterator operator--(int) {
+      auto tmp = *this;
+      --*this;
+      return tmp;
+    }
+    constexpr iterator& operator+=(difference_type n) {
+      index_ = static_cast<Index>(index_ + static_cast<Index>(n));
+      return *this;
+    }
+    constexpr iterator& operator-=(difference_type n) {
+      index_ = static_cast<Index>(index_ - static_cast<Index>(n));
+      return *this;
+    }
+
+    friend constexpr bool operator==(const iterator& x, const iterator& y) {
+      return x.index_ == y.index_;
+    }
+    friend constexpr auto operator<=>(const iterator& x, const iterator& y) {
+      return x.index_ <=> y.index_;
+    }
+
+    friend constexpr iterator operator+(iterator x, difference_type n) {
+      x += n;
+      return x;
+    }
+    friend constexpr iterator operator+(difference_type n, iterator x) {
+      x += n;
+      return x;
+    }
+    friend constexpr iterator operator-(iterator x, difference_type n) {
+      x -= n;
+      return x;
+    }
+    friend constexpr difference_type
+    operator-(const iterator& x, const iterator& y) {
+      return static_cast<difference_type>(x.index_)
+             - static_cast<difference_type>(y.index_);
+    }
+
+    friend constexpr auto iter_move(const iterator& x) {
+      return std::apply(
+        [&x](const auto&... begin) {
+          return std::tuple<
+            Index,
+            std::ranges::range_rvalue_reference_t<base_t<Views>>...>(
+            x.index_,
+            std::ranges::iter_move(begin + x.template offset<Views>())...);
+        },
+        x.begins_);
+    }
+  };
+
+  /// @brief cols... を行のインデックスとともに同時に走査する view を返す
+  /// @details 各列はランダムアクセスできる sized_range でなければならない。
+  /// @code
+  /// for (auto [i, x, y] : ns::enumerate_zip(xs, ys))
+  ///   y = x * static_cast<float>(i);
+  /// @endcode
+  template <
+    std::integral Index = std::size_t,
+    std::ranges::viewable_range... Ranges>
+    requires(sizeof...(Ranges) > 0) and
+            (std::ranges::random_access_range<Ranges> and ...) and
+            (std::ranges::sized_range<Ranges> and ...)
+  constexpr auto enumerate_zip(Ranges&&... cols) {
+    return enumerate_zip_view<Index, std::views::all_t<Ranges>...>(
+      std::views::all(std::forward<Ranges>(cols))...);
+  }
+} // namespace ns
@@ -0,0 +1,477 @@
+/// @file gather_view.hpp
+#pragma once
+#include <ns/index_search.hpp>
+#include <ns/prefetch_view.hpp>
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+
+#if defined(__GNUC__) and defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+namespace ns::simd {
+  // gather
+
+  /// @brief ベクトル命令で読み出せる添字の型 (4 バイトまたは 8 バイトの整数)
+  template <class I>
+  concept gather_index =
+    std::integral<I> and (sizeof(I) == 4 or sizeof(I) == 8);
+
+  //! gather_view が既定で先読みする要素数
+  inline constexpr std::size_t gather_distance = 16;
+
+  /// @brief out[i] = data[idx[i]] (0 <= i < n)
+  /// @details 各読み出しは互いに依存しないため、アウトオブオーダー実行が
+  /// 複数のキャッシュミスを同時に待てる。ソフトウェアプリフェッチを加えても
+  /// 速くならず、キャッシュに収まる大きさでは命令が増えて遅くなるため
+  /// 行わない。
+  template <vectorizable T, gather_index I>
+  void gather_scalar(
+    const T* data,
+    const I* idx,
+    std::size_t n,
+    T* out) noexcept {
+    for (std::size_t i = 0; i < n; ++i)
+      out[i] = data[idx[i]];
+  }
+
+#if defined(__GNUC__) and defined(__x86_64__)
+  /// @brief gather_scalar と同じ結果を AVX2 の gather 命令で書き込む
+  /// @details 4 バイトの添字は符号付きとして扱われるため、呼び出し側は
+  /// 添字が 2^31 未満であることを保証する。
+  /// @pre sizeof(I) == 4 のとき idx[i] < 2^31
+  template <vectorizable T, gather_index I>
+  [[gnu::target("avx2")]] void gather_avx2(
+    const T* data,
+    const I* idx,
+    std::size_t n,
+    T* out) noexcept {
+    constexpr std::size_t lanes = sizeof(T) == 4 and sizeof(I) == 4 ? 8 : 4;
+    constexpr int scale = sizeof(T);
+    std::size_t i = 0;
+    for (; i + lanes <= n; i += lanes) {
+      if constexpr (sizeof(I) == 4 and sizeof(T) == 4) {
+        const __m256i vi =
+          _mm256_loadu_si256(reinterpret_cast<const __m256i*>(idx + i));
+        if constexpr (std::is_same_v<T, float>)
+          _mm256_storeu_ps(out + i, _mm256_i32gather_ps(data, vi, scale));
+        else
+          _mm256_storeu_si256(
+            reinterpret_cast<__m256i*>(out + i),
+            _mm256_i32gather_epi32(
+              reinterpret_cast<const int*>(data), vi, scale));
+      } else if constexpr (sizeof(I) == 4) {
+        const __m128i vi =
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(idx + i));
+        // _mm256_i32gather_pd は未初期化の値を元にするため、GCC が
+        // -Wmaybe-uninitialized を報告する。全レーンを読むマスク付きの
+        // 命令で同じ結果を得る。
+        if constexpr (std::is_same_v<T, double>)
+          _mm256_storeu_pd(
+            out + i,
+            _mm256_mask_i32gather_pd(
+              _mm256_setzero_pd(),
+              data,
+              vi,
+              _mm256_castsi256_pd(_mm256_set1_epi64x(-1)),
+              scale));
+        else
+          _mm256_storeu_si256(
+            reinterpret_cast<__m256i*>(out + i),
+            _mm256_i32gather_epi64(
+              reinterpret_cast<const long long*>(data), vi, scale));
+      } else if constexpr (sizeof(T) == 4) {
+        const __m256i vi =
+          _mm256_loadu_si256(reinterpret_cast<const __m256i*>(idx + i));
+        if constexpr (std::is_same_v<T, float>)
+          _mm_storeu_ps(out + i, _mm256_i64gather_ps(data, vi, scale));
+        else
+          _mm_storeu_si128(
+            reinterpret_cast<__m128i*>(out + i),
+            _mm256_i64gather_epi32(
+              reinterpret_cast<const int*>(data), vi, scale));
+      } else {
+        const __m256i vi =
+          _mm256_loadu_si256(reinterpret_cast<const __m256i*>(idx + i));
+        if constexpr (std::is_same_v<T, double>)
+          _mm256_storeu_pd(out + i, _mm256_i64gather_pd(data, vi, scale));
+        else
+          _mm256_storeu_si256(
+            reinterpret_cast<__m256i*>(out + i),
+            _mm256_i64gather_epi64(
+              reinterpret_cast<const long long*>(data), vi, scale));
+      }
+    }
+    for (; i < n; ++i)
+      out[i] = data[idx[i]];
+  }
+#endif
+
+  /// @brief gather_scalar を l の命令で行う
+  /// @details SSE2 は gather 命令をもたないため、level::sse2 では
+  /// gather_scalar を用いる。
+  /// @pre l <= detected_level()
+  /// @pre sizeof(I) == 4 かつ l == level::avx2 のとき idx[i] < 2^31
+  template <vectorizable T, gather_index I>
+  void gather(
+    level l,
+    const T* data,
+    const I* idx,
+    std::size_t n,
+    T* out) noexcept {
+    switch (l) {
+#if defined(__GNUC__) and defined(__x86_64__)
+    case level::avx2:
+      return gather_avx2(data, idx, n, out);
+#endif
+    default:
+      return gather_scalar(data, idx, n, out);
+    }
+  }
+} // namespace ns::simd
+
+namespace ns {
+  // iterator_address
+
+  /// @brief イテレータが指す要素のアドレスを返す (プリフェッチの対象)
+  /// @details 連続したイテレータであればそのアドレスを、base() をもつ
+  /// イテレータ (enumerate_view など) であれば元となるイテレータのアドレス
+  /// を、要素が左辺値であればそのアドレスを返す。いずれでもなければ nullptr
+  /// を返す。
+  template <std::input_or_output_iterator It>
+  constexpr const void* iterator_address(const It& it) {
+    if constexpr (std::contiguous_iterator<It>)
+      return std::to_address(it);
+    else if constexpr (requires { iterator_address(it.base()); })
+      return iterator_address(it.base());
+    else
+      return element_address()(*it);
+  }
+
+  // gather_view
+
+  /// @brief 要素型が T の連続したイテレータ (gather_into の出力先)
+  template <class O, class T>
+  concept contiguous_output = std::contiguous_iterator<O> and
+                              std::same_as<std::iter_value_t<O>, T> and
+                              std::indirectly_writable<O, T>;
+
+  /// @brief 添字の列が指す要素を順に走査し、先読みした要素をプリフェッチする
+  /// view
+  /// @details i 番目の要素は元の範囲の indices[i] 番目である。並べ替えの結果
+  /// や選択ベクトルのように添字が無作為に並ぶと、各要素の読み出しが
+  /// キャッシュミスとなる。イテレータは進めるたびに distance 個先の添字が
+  /// 指す要素をプリフェッチする。selection_view と異なり、添字は昇順で
+  /// なくてよい。gather_into は、要素型が simd::vectorizable な連続した範囲
+  /// について AVX2 の gather 命令でまとめて書き出す。
+  /// @tparam View 元となる view の型
+  /// @tparam Indices 元の範囲での位置を並べた view の型
+  template <std::ranges::random_access_range View, class Indices>
+    requires std::ranges::view<View> and std::ranges::view<Indices> and
+             std::ranges::random_access_range<Indices> and
+             std::ranges::sized_range<Indices> and
+             std::integral<std::ranges::range_value_t<Indices>>
+  struct gather_view
+    : std::ranges::view_interface<gather_view<View, Indices>> {
+  private:
+    //! 元となる view
+    View base_ = View();
+    //! 元の範囲での位置の列
+    Indices indices_ = Indices();
+    //! 先読みする要素数
+    std::size_t distance_ = simd::gather_distance;
+
+    template <bool Const>
+    struct iterator;
+
+    template <class Base, class Idx, class O>
+    static constexpr O
+    gather_into_impl(Base& base, Idx& indices, std::size_t distance, O out) {
+      using T = std::ranges::range_value_t<Base>;
+      using I = std::ranges::range_value_t<Idx>;
+      const auto n = static_cast<std::size_t>(std::ranges::size(indices));
+      if constexpr (
+        std::ranges::contiguous_range<Base> and
+        std::ranges::sized_range<Base> and
+        std::ranges::contiguous_range<Idx> and simd::vectorizable<T> and
+        simd::gather_index<I> and contiguous_output<O, T>) {
+        if (not std::is_constant_evaluated()) {
+          auto l = simd::detected_level();
+          // 4 バイトの添字は gather 命令で符号付きとして扱われる
+          if (
+            sizeof(I) == 4 and
+            std::cmp_greater(
+              std::ranges::size(base),
+              std::numeric_limits<std::int32_t>::max()))
+            l = simd::level::scalar;
+          simd::gather(
+            l,
+            std::ranges::data(base),
+            std::ranges::data(indices),
+            n,
+            std::to_address(out));
+          return out + static_cast<std::iter_difference_t<O>>(n);
+        }
+      }
+      const auto first = std::ranges::begin(base);
+      const auto idx = std::ranges::begin(indices);
+      auto at = [&](std::size_t i) {
+        using D = std::ranges::range_difference_t<Base>;
+        using E = std::ranges::range_difference_t<Idx>;
+        return first + static_cast<D>(idx[static_cast<E>(i)]);
+      };
+      for (std::size_t i = 0; i < n; ++i) {
+        if (i + distance < n and not std::is_constant_evaluated())
+          prefetch(iterator_address(at(i + distance)));
+        *out = *at(i);
+        ++out;
+      }
+      return out;
+    }
+
+  public:
+    gather_view()
+      requires std::default_initializable<View> and
+               std::default_initializable<Indices>
+    = default;
+    /// @param distance 先読みする要素数 (0 のときはプリフェッチしない)
+    /// @pre indices の各値 s は 0 <= s < size(base) を満たす
+    constexpr gather_view(
+      View base,
+      Indices indices,
+      std::size_t distance = simd::gather_distance)
+      : base_(std::move(base)),
+        indices_(std::move(indices)),
+        distance_(distance) {}
+
+    constexpr View base() const&
+      requires std::copy_constructible<View>
+    {
+      return base_;
+    }
+    constexpr View base() && {
+      return std::move(base_);
+    }
+
+    constexpr const Indices& indices() const noexcept {
+      return indices_;
+    }
+    /// @brief 先読みする要素数
+    constexpr std::size_t distance() const noexcept {
+      return distance_;
+    }
+
+    constexpr iterator<false> begin() {
+      return {
+        std::ranges::begin(base_),
+        std::ranges::begin(indices_),
+        std::ranges::size(indices_),
+        distance_};
+    }
+    constexpr iterator<true> begin() const
+      requires std::ranges::random_access_range<const View> and
+               std::ranges::random_access_range<const Indices> and
+               std::ranges::sized_range<const Indices>
+    {
+      return {
+        std::ranges::begin(base_),
+        std::ranges::begin(indices_),
+        std::ranges::size(indices_),
+        distance_};
+    }
+
+    constexpr iterator<false> end() {
+      return begin() + static_cast<std::ptrdiff_t>(size());
+    }
+    constexpr iterator<true> end() const
+      requires std::ranges::random_access_range<const View> and
+               std::ranges::random_access_range<const Indices> and
+               std::ranges::sized_range<const Indices>
+    {
+      return begin() + static_cast<std::ptrdiff_t>(size());
+    }
+
+    constexpr auto size() const
+      requires std::ranges::sized_range<const Indices>
+    {
+      return std::ranges::size(indices_);
+    }
+    constexpr auto size() {
+      return std::ranges::size(indices_);
+    }
+
+    /// @brief 各要素を out に順に書き込み、書き込んだ末尾を返す
+    /// @details 元となる範囲と添字の列が連続し、要素型が simd::vectorizable、
+    /// out が同じ要素型の連続したイテレータであれば、AVX2 の gather 命令
+    /// (使えなければ先読みしないスカラーのループ simd::gather_scalar) で
+    /// 書き込む。それ以外は distance 個先の要素をプリフェッチしながら 1 つ
+    /// ずつ書き込む。
+    template <std::weakly_incrementable O>
+      requires std::indirectly_copyable<std::ranges::iterator_t<View>, O>
+    constexpr O gather_into(O out) {
+      return gather_into_impl(base_, indices_, distance_, std::move(out));
+    }
+    template <std::weakly_incrementable O>
+      requires std::ranges::random_access_range<const View> and
+               std::ranges::random_access_range<const Indices> and
+               std::indirectly_copyable<std::ranges::iterator_t<const View>, O>
+    constexpr O gather_into(O out) const {
+      return gather_into_impl(base_, indices_, distance_, std::move(out));
+    }
+  };
+
+  template <class Range, class Indices>
+  gather_view(Range&&, Indices&&)
+    -> gather_view<std::views::all_t<Range>, std::views::all_t<Indices>>;
+  template <class Range, class Indices>
+  gather_view(Range&&, Indices&&, std::size_t)
+    -> gather_view<std::views::all_t<Range>, std::views::all_t<Indices>>;
+
+  template <std::ranges::random_access_range View, class Indices>
+    requires std::ranges::view<View> and std::ranges::view<Indices> and
+             std::ranges::random_access_range<Indices> and
+             std::ranges::sized_range<Indices> and
+             std::integral<std::ranges::range_value_t<Indices>>
+  template <bool Const>
+  struct gather_view<View, Indices>::iterator
+    : deduce_iterator_category<std::conditional_t<Const, const View, View>> {
+  private:
+    using Base = std::conditional_t<Const, const View, View>;
+    using Idx = std::conditional_t<Const, const Indices, Indices>;
+    template <bool>
+    friend struct iterator;
+
+    //! 元となる view の先頭
+    std::ranges::iterator_t<Base> begin_ = std::ranges::iterator_t<Base>();
+    //! 添字の列の先頭
+    std::ranges::iterator_t<Idx> first_ = std::ranges::iterator_t<Idx>();
+    //! 添字の列での現在位置
+    std::ptrdiff_t pos_ = 0;
+    //! 添字の列の要素数
+    std::ptrdiff_t size_ = 0;
+    //! 先読みする要素数
+    std::ptrdiff_t distance_ = 0;
+
+    //! 添字の列の k 番目が指す元となるイテレータ
+    constexpr std::ranges::iterator_t<Base> at(std::ptrdiff_t k) const {
+      using D = std::ranges::range_difference_t<Base>;
+      using E = std::ranges::range_difference_t<Idx>;
+      return begin_ + static_cast<D>(first_[static_cast<E>(k)]);
+    }
+
+  public:
+    using difference_type = std::ptrdiff_t;
+    using value_type = std::ranges::range_value_t<Base>;
+    using iterator_concept = std::random_access_iterator_tag;
+
+    iterator()
+      requires std::default_initializable<std::ranges::iterator_t<Base>> and
+                 std::default_initializable<std::ranges::iterator_t<Idx>>
+    = default;
+    constexpr iterator(
+      std::ranges::iterator_t<Base> begin,
+      std::ranges::iterator_t<Idx> first,
+      std::size_t size,
+      std::size_t distance)
+      : begin_(std::move(begin)),
+        first_(std::move(first)),
+        size_(static_cast<std::ptrdiff_t>(size)),
+        distance_(static_cast<std::ptrdiff_t>(distance)) {}
+    constexpr /* implicit */ iterator(iterator<not Const> other)
+      requires Const and
+                 std::convertible_to<
+                   std::ranges::iterator_t<View>,
+                   std::ranges::iterator_t<Base>> and
+                 std::convertible_to<
+                   std::ranges::iterator_t<Indices>,
+                   std::ranges::iterator_t<Idx>>
+      : begin_(std::move(other.begin_)),
+        first_(std::move(other.first_)),
+        pos_(other.pos_),
+        size_(other.size_),
+        distance_(other.distance_) {}
+
+    constexpr std::ranges::range_reference_t<Base> operator*() const {
+      return *at(pos_);
+    }
+    constexpr std::ranges::range_reference_t<Base>
+    operator[](difference_type n) const {
+      return *at(pos_ + n);
+    }
+
+    /// @brief 現在の要素の元の範囲での位置
+    constexpr std::ranges::range_value_t<Idx> index() const {
+      return first_[static_cast<std::ranges::range_difference_t<Idx>>(pos_)];
+    }
+
+    /// @details distance 個先の要素をプリフェッチする
+    constexpr iterator& operator++() {
+      ++pos_;
+      if (
+        distance_ != 0 and pos_ + distance_ < size_ and
+        not std::is_constant_evaluated())
+        prefetch(iterator_address(at(pos_ + distance_)));
+      return *this;
+    }
+    constexpr iterator operator++(int) {
+      auto tmp = *this;
+      ++*this;
+      return tmp;
+    }
+    constexpr iterator& operator--() {
+      --pos_;
+      return *this;
+    }
+    constexpr iterator operator--(int) {
+      auto tmp = *this;
+      --*this;
+      return tmp;
+    }
+    constexpr iterator& operator+=(difference_type n) {
+      pos_ += n;
+      return *this;
+    }
+    constexpr iterator& operator-=(difference_type n) {
+      pos_ -= n;
+      return *this;
+    }
+
+    friend constexpr bool operator==(const iterator& x, const iterator& y) {
+      return x.pos_ == y.pos_;
+    }
+    friend constexpr auto operator<=>(const iterator& x, const iterator& y) {
+      return x.pos_ <=> y.pos_;
+    }
+
+    friend constexpr iterator operator+(iterator x, difference_type n) {
+      x += n;
+      return x;
+    }
+    friend constexpr iterator operator+(difference_type n, iterator x) {
+      x += n;
+      return x;
+    }
+    friend constexpr iterator operator-(iterator x, difference_type n) {
+      x -= n;
+      return x;
+    }
+    friend constexpr difference_type
+    operator-(const iterator& x, const iterator& y) {
+      return x.pos_ - y.pos_;
+    }
+
+    friend constexpr std::ranges::range_rvalue_reference_t<Base>
+    iter_move(const iterator& x) noexcept(
+      noexcept(std::ranges::iter_move(x.at(x.pos_)))) {
+      return std::ranges::iter_move(x.at(x.pos_));
+    }
+  };
+} // namespace ns
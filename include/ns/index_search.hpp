@@ -0,0 +1,669 @@
+/// @file index_search.hpp
+#pragma once
+#include <ns/enumerate_view.hpp>
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <optional>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+
+namespace ns::simd {
+  // level
+
+  /// @brief x86-64 向けのベクトル命令 (SSE2, AVX2) の実装を含むか
+  /// @details 実装を切り替える各ヘッダは、マクロを外に漏らさないよう同じ
+  /// 条件の #if を直接用いる。
+  inline constexpr bool x86_64 =
+#if defined(__GNUC__) and defined(__x86_64__)
+    true;
+#else
+    false;
+#endif
+
+  /// @brief ベクトル命令の水準
+  enum class level { scalar, sse2, avx2 };
+
+  /// @brief 実行中の CPU で使える最も広い水準を返す
+  /// @details x86-64 では SSE2 が常に使えるため、AVX2 の有無のみを調べる。
+  /// それ以外の環境では scalar を返す。
+  inline level detected_level() noexcept {
+#if defined(__GNUC__) and defined(__x86_64__)
+    static const level l = [] {
+      __builtin_cpu_init();
+      return __builtin_cpu_supports("avx2") ? level::avx2 : level::sse2;
+    }();
+    return l;
+#else
+    return level::scalar;
+#endif
+  }
+
+  /// @brief ベクトル化した経路を持つ要素型
+  template <class T>
+  concept vectorizable =
+    std::is_same_v<T, float> or std::is_same_v<T, double> or
+    std::is_same_v<T, std::int32_t> or std::is_same_v<T, std::int64_t>;
+
+  // compare_op
+
+  /// @brief 要素 x と値 v の比較 (x < v, x <= v, ...)
+  enum class compare_op { lt, le, gt, ge, eq, ne };
+
+  /// @brief x と y を Op で比較する
+  template <compare_op Op, class T>
+  [[gnu::always_inline]] constexpr bool compare(const T& x, const T& y) {
+    if constexpr (Op == compare_op::lt)
+      return x < y;
+    else if constexpr (Op == compare_op::le)
+      return x <= y;
+    else if constexpr (Op == compare_op::gt)
+      return x > y;
+    else if constexpr (Op == compare_op::ge)
+      return x >= y;
+    else if constexpr (Op == compare_op::eq)
+      return x == y;
+    else
+      return x != y;
+  }
+
+  /// @brief 最小値 (Max なら最大値) の探索でどの要素にも負けない初期値
+  template <bool Max, vectorizable T>
+  constexpr T worst_value() noexcept {
+    using limits = std::numeric_limits<T>;
+    if constexpr (limits::has_infinity)
+      return Max ? -limits::infinity() : limits::infinity();
+    else
+      return Max ? limits::lowest() : limits::max();
+  }
+
+  // scalar kernels
+
+  /// @brief p[0, n) で worst_value より良い最初の最小値 (Max なら最大値) の
+  /// 位置を返す (なければ n)
+  /// @details NaN はどの値とも比較が偽となるため選ばれない。
+  template <bool Max, vectorizable T>
+  std::size_t extremum_scalar(const T* p, std::size_t n) noexcept {
+    constexpr auto op = Max ? compare_op::gt : compare_op::lt;
+    T best = worst_value<Max, T>();
+    std::size_t best_i = n;
+    for (std::size_t i = 0; i < n; ++i) {
+      if (compare<op>(p[i], best)) {
+        best = p[i];
+        best_i = i;
+      }
+    }
+    return best_i;
+  }
+
+  template <compare_op Op, vectorizable T>
+  std::size_t find_scalar(const T* p, std::size_t n, T value) noexcept {
+    for (std::size_t i = 0; i < n; ++i)
+      if (compare<Op>(p[i], value))
+        return i;
+    return n;
+  }
+
+  template <compare_op Op, vectorizable T>
+  std::size_t count_scalar(const T* p, std::size_t n, T value) noexcept {
+    std::size_t count = 0;
+    for (std::size_t i = 0; i < n; ++i)
+      count += static_cast<std::size_t>(compare<Op>(p[i], value));
+    return count;
+  }
+
+#if defined(__GNUC__) and defined(__x86_64__)
+  // vector kernels
+
+  // 各カーネルは GCC のベクトル拡張で一度だけ書き、Bytes を変えて SSE2 (16)
+  // と AVX2 (32) の関数に展開する。AVX2 の関数は target 属性を付けて別に
+  // コンパイルし、実行時に detected_level で選ぶ。カーネルは呼び出し元の
+  // target でコード生成されるよう always_inline とする。
+
+  template <class T, std::size_t Bytes>
+  struct vector_type {
+    typedef T type __attribute__((vector_size(Bytes)));
+  };
+  template <class T, std::size_t Bytes>
+  using vector_t = typename vector_type<T, Bytes>::type;
+
+  //! T と同じ大きさの符号付き整数 (ベクトルの比較結果の要素型)
+  template <class T>
+  using mask_element_t =
+    std::conditional_t<sizeof(T) == 4, std::int32_t, std::int64_t>;
+
+  //! 依存の連鎖を断つために独立に進めるベクトルの数
+  inline constexpr std::size_t unroll = 4;
+
+  // ベクトルを値で受け渡すと呼び出し規約が target に依存するため、補助関数
+  // は参照を通して結果を書き込む
+
+  template <class V>
+  [[gnu::always_inline]] inline void load(V& x, const void* p) noexcept {
+    std::memcpy(&x, p, sizeof(V));
+  }
+
+  /// @brief 各レーンを Op で比較し、真なら -1、偽なら 0 を m に書き込む
+  template <compare_op Op, class V, class MV>
+  [[gnu::always_inline]] inline void
+  compare_lanes(const V& x, const V& y, MV& m) noexcept {
+    if constexpr (Op == compare_op::lt)
+      m = x < y;
+    else if constexpr (Op == compare_op::le)
+      m = x <= y;
+    else if constexpr (Op == compare_op::gt)
+      m = x > y;
+    else if constexpr (Op == compare_op::ge)
+      m = x >= y;
+    else if constexpr (Op == compare_op::eq)
+      m = x == y;
+    else
+      m = x != y;
+  }
+
+  template <class MV>
+  [[gnu::always_inline]] inline bool any(const MV& m) noexcept {
+    std::uint64_t words[sizeof(MV) / 8];
+    std::memcpy(words, &m, sizeof(MV));
+    std::uint64_t x = 0;
+    for (auto w : words)
+      x |= w;
+    return x != 0;
+  }
+
+  /// @brief extremum_scalar と同じ位置を返す
+  /// @details 各レーンが担当する要素の中の最良値とその位置を持ち、最後に値、
+  /// 位置の順でレーン同士を比べる。各レーンは最初に現れた最良値のみを更新
+  /// するため、等しい値のうち最初の位置が残る。
+  /// @pre n < 2^31 (T が 4 バイトのとき)
+  template <std::size_t Bytes, bool Max, vectorizable T>
+  [[gnu::always_inline]] inline std::size_t
+  extremum_kernel(const T* p, std::size_t n) noexcept {
+    using V = vector_t<T, Bytes>;
+    using M = mask_element_t<T>;
+    using MV = vector_t<M, Bytes>;
+    constexpr std::size_t lanes = Bytes / sizeof(T);
+    constexpr std::size_t step = unroll * lanes;
+    constexpr auto op = Max ? compare_op::gt : compare_op::lt;
+
+    V best[unroll];
+    MV best_i[unroll], cur[unroll];
+    for (std::size_t u = 0; u < unroll; ++u) {
+      best[u] = V{} + worst_value<Max, T>();
+      best_i[u] = MV{} - 1;
+      for (std::size_t k = 0; k < lanes; ++k)
+        cur[u][k] = static_cast<M>(u * lanes + k);
+    }
+    std::size_t i = 0;
+    for (; i + step <= n; i += step) {
+      for (std::size_t u = 0; u < unroll; ++u) {
+        V x;
+        MV better;
+        load(x, p + i + u * lanes);
+        compare_lanes<op>(x, best[u], better);
+        best[u] = better ? x : best[u];
+        best_i[u] = better ? cur[u] : best_i[u];
+        cur[u] += static_cast<M>(step);
+      }
+    }
+
+    T value = worst_value<Max, T>();
+    std::size_t pos = n;
+    for (std::size_t u = 0; u < unroll; ++u) {
+      for (std::size_t k = 0; k < lanes; ++k) {
+        if (best_i[u][k] < 0)
+          continue;
+        const auto j = static_cast<std::size_t>(best_i[u][k]);
+        if (compare<op>(best[u][k], value) or
+            (best[u][k] == value and j < pos)) {
+          value = best[u][k];
+          pos = j;
+        }
+      }
+    }
+    for (; i < n; ++i) {
+      if (compare<op>(p[i], value)) {
+        value = p[i];
+        pos = i;
+      }
+    }
+    return pos;
+  }
+
+  template <std::size_t Bytes, compare_op Op, vectorizable T>
+  [[gnu::always_inline]] inline std::size_t
+  find_kernel(const T* p, std::size_t n, T value) noexcept {
+    using V = vector_t<T, Bytes>;
+    using MV = vector_t<mask_element_t<T>, Bytes>;
+    constexpr std::size_t lanes = Bytes / sizeof(T);
+    constexpr std::size_t step = unroll * lanes;
+
+    const V v = V{} + value;
+    std::size_t i = 0;
+    for (; i + step <= n; i += step) {
+      MV m[unroll];
+      for (std::size_t u = 0; u < unroll; ++u) {
+        V x;
+        load(x, p + i + u * lanes);
+        compare_lanes<Op>(x, v, m[u]);
+      }
+      // 一致がなければ 1 回の判定で次へ進む
+      if (any((m[0] | m[1]) | (m[2] | m[3])))
+        for (std::size_t u = 0; u < unroll; ++u)
+          for (std::size_t k = 0; k < lanes; ++k)
+            if (m[u][k])
+              return i + u * lanes + k;
+    }
+    return i + find_scalar<Op>(p + i, n - i, value);
+  }
+
+  /// @pre n < 2^31 (T が 4 バイトのとき)
+  template <std::size_t Bytes, compare_op Op, vectorizable T>
+  [[gnu::always_inline]] inline std::size_t
+  count_kernel(const T* p, std::size_t n, T value) noexcept {
+    using V = vector_t<T, Bytes>;
+    using MV = vector_t<mask_element_t<T>, Bytes>;
+    constexpr std::size_t lanes = Bytes / sizeof(T);
+    constexpr std::size_t step = unroll * lanes;
+
+    const V v = V{} + value;
+    MV acc[unroll] = {};
+    std::size_t i = 0;
+    for (; i + step <= n; i += step) {
+      for (std::size_t u = 0; u < unroll; ++u) {
+        V x;
+        MV m;
+        load(x, p + i + u * lanes);
+        compare_lanes<Op>(x, v, m);
+        acc[u] -= m;
+      }
+    }
+
+    std::size_t count = 0;
+    for (std::size_t u = 0; u < unroll; ++u)
+      for (std::size_t k = 0; k < lanes; ++k)
+        count += static_cast<std::size_t>(acc[u][k]);
+    return count + count_scalar<Op>(p + i, n - i, value);
+  }
+
+  template <bool Max, vectorizable T>
+  std::size_t extremum_sse2(const T* p, std::size_t n) noexcept {
+    return extremum_kernel<16, Max>(p, n);
+  }
+  template <bool Max, vectorizable T>
+  [[gnu::target("avx2")]] std::size_t
+  extremum_avx2(const T* p, std::size_t n) noexcept {
+    return extremum_kernel<32, Max>(p, n);
+  }
+
+  template <compare_op Op, vectorizable T>
+  std::size_t find_sse2(const T* p, std::size_t n, T value) noexcept {
+    return find_kernel<16, Op>(p, n, value);
+  }
+  template <compare_op Op, vectorizable T>
+  [[gnu::target("avx2")]] std::size_t
+  find_avx2(const T* p, std::size_t n, T value) noexcept {
+    return find_kernel<32, Op>(p, n, value);
+  }
+
+  template <compare_op Op, vectorizable T>
+  std::size_t count_sse2(const T* p, std::size_t n, T value) noexcept {
+    return count_kernel<16, Op>(p, n, value);
+  }
+  template <compare_op Op, vectorizable T>
+  [[gnu::target("avx2")]] std::size_t
+  count_avx2(const T* p, std::size_t n, T value) noexcept {
+    return count_kernel<32, Op>(p, n, value);
+  }
+#endif
+
+  // dispatch
+
+  //! ベクトルのカーネルに一度に渡す要素数の上限 (32 ビットの位置と計数が
+  //! 溢れない大きさ)
+  inline constexpr std::size_t kernel_block = std::size_t(1) << 30;
+
+  /// @brief p[0, n) で最初に最小 (Max なら最大) となる位置を返す
+  /// @details std::min_element (Max なら std::max_element) と同じ位置を返す。
+  /// すなわち NaN は先頭にあるときのみ選ばれ、n == 0 のときは 0 を返す。
+  /// @pre l <= detected_level()
+  template <bool Max, vectorizable T>
+  std::size_t arg_extremum(level l, const T* p, std::size_t n) noexcept {
+    // 先頭が NaN なら、どの要素もそれより良いとは判定されない
+    if (n == 0 or p[0] != p[0])
+      return 0;
+    constexpr auto op = Max ? compare_op::gt : compare_op::lt;
+    std::size_t pos = n;
+    for (std::size_t first = 0; first < n; first += kernel_block) {
+      const std::size_t len = std::min(kernel_block, n - first);
+      std::size_t k = len;
+      switch (l) {
+#if defined(__GNUC__) and defined(__x86_64__)
+      case level::avx2:
+        k = extremum_avx2<Max>(p + first, len);
+        break;
+      case level::sse2:
+        k = extremum_sse2<Max>(p + first, len);
+        break;
+#endif
+      default:
+        k = extremum_scalar<Max>(p + first, len);
+        break;
+      }
+      if (k != len and (pos == n or compare<op>(p[first + k], p[pos])))
+        pos = first + k;
+    }
+    // worst_value より良い要素がなければ、NaN でない要素はすべて先頭と等しい
+    return pos == n ? 0 : pos;
+  }
+
+  /// @brief compare<Op>(p[i], value) が真となる最初の i を返す (なければ n)
+  /// @pre l <= detected_level()
+  template <compare_op Op, vectorizable T>
+  std::size_t find(level l, const T* p, std::size_t n, T value) noexcept {
+    switch (l) {
+#if defined(__GNUC__) and defined(__x86_64__)
+    case level::avx2:
+      return find_avx2<Op>(p, n, value);
+    case level::sse2:
+      return find_sse2<Op>(p, n, value);
+#endif
+    default:
+      return find_scalar<Op>(p, n, value);
+    }
+  }
+
+  /// @brief compare<Op>(p[i], value) が真となる i の数を返す
+  /// @pre l <= detected_level()
+  template <compare_op Op, vectorizable T>
+  std::size_t count(level l, const T* p, std::size_t n, T value) noexcept {
+    std::size_t count = 0;
+    for (std::size_t first = 0; first < n; first += kernel_block) {
+      const std::size_t len = std::min(kernel_block, n - first);
+      switch (l) {
+#if defined(__GNUC__) and defined(__x86_64__)
+      case level::avx2:
+        count += count_avx2<Op>(p + first, len, value);
+        break;
+      case level::sse2:
+        count += count_sse2<Op>(p + first, len, value);
+        break;
+#endif
+      default:
+        count += count_scalar<Op>(p + first, len, value);
+        break;
+      }
+    }
+    return count;
+  }
+} // namespace ns::simd
+
+namespace ns {
+  // compare_to
+
+  /// @brief 要素 x が Op(x, value) を満たすかを判定する述語
+  /// @details find_index や count_if にこの述語を渡すと、要素型が
+  /// simd::vectorizable な連続した範囲ではベクトル命令で判定する。
+  template <class Op, class T>
+  struct compare_to {
+    using op_type = Op;
+
+    T value;
+
+    template <class U>
+    constexpr bool operator()(const U& x) const {
+      return static_cast<bool>(Op{}(x, value));
+    }
+  };
+
+  template <class T>
+  constexpr auto less_than(T value) {
+    return compare_to<std::ranges::less, T>{std::move(value)};
+  }
+  template <class T>
+  constexpr auto less_equal(T value) {
+    return compare_to<std::ranges::less_equal, T>{std::move(value)};
+  }
+  template <class T>
+  constexpr auto greater_than(T value) {
+    return compare_to<std::ranges::greater, T>{std::move(value)};
+  }
+  template <class T>
+  constexpr auto greater_equal(T value) {
+    return compare_to<std::ranges::greater_equal, T>{std::move(value)};
+  }
+  template <class T>
+  constexpr auto equal_to(T value) {
+    return compare_to<std::ranges::equal_to, T>{std::move(value)};
+  }
+  template <class T>
+  constexpr auto not_equal_to(T value) {
+    return compare_to<std::ranges::not_equal_to, T>{std::move(value)};
+  }
+
+  /// @brief 比較の関数オブジェクト Op に対応する simd::compare_op
+  template <class Op>
+  inline constexpr std::optional<simd::compare_op> compare_op_of =
+    std::nullopt;
+  template <>
+  inline constexpr std::optional<simd::compare_op>
+    compare_op_of<std::ranges::less> = simd::compare_op::lt;
+  template <>
+  inline constexpr std::optional<simd::compare_op>
+    compare_op_of<std::ranges::less_equal> = simd::compare_op::le;
+  template <>
+  inline constexpr std::optional<simd::compare_op>
+    compare_op_of<std::ranges::greater> = simd::compare_op::gt;
+  template <>
+  inline constexpr std::optional<simd::compare_op>
+    compare_op_of<std::ranges::greater_equal> = simd::compare_op::ge;
+  template <>
+  inline constexpr std::optional<simd::compare_op>
+    compare_op_of<std::ranges::equal_to> = simd::compare_op::eq;
+  template <>
+  inline constexpr std::optional<simd::compare_op>
+    compare_op_of<std::ranges::not_equal_to> = simd::compare_op::ne;
+
+  // enumerated_base_t
+
+  template <class R>
+  inline constexpr bool is_enumerate_view_v = false;
+  template <class View, class Index>
+  inline constexpr bool is_enumerate_view_v<enumerate_view<View, Index>> =
+    true;
+
+  template <class R>
+  struct enumerated_base {};
+  template <std::ranges::viewable_range R>
+    requires(not is_enumerate_view_v<std::remove_cvref_t<R>>)
+  struct enumerated_base<R> {
+    using type = std::views::all_t<R>;
+    using index_type = std::size_t;
+  };
+  template <class R>
+    requires is_enumerate_view_v<std::remove_cvref_t<R>>
+  struct enumerated_base<R> {
+    using type = std::remove_cvref_t<
+      decltype(std::declval<const std::remove_cvref_t<R>&>().base_ref())>;
+    using index_type =
+      decltype(std::declval<const std::remove_cvref_t<R>&>().start());
+  };
+
+  /// @brief 添字を求める関数が要素を読み出す範囲の型
+  /// @details R が enumerate_view ならその元となる view、そうでなければ R
+  /// そのものである。
+  template <class R>
+  using enumerated_base_t = typename enumerated_base<R>::type;
+  /// @brief 添字を求める関数が返す添字の型
+  template <class R>
+  using enumerated_index_t = typename enumerated_base<R>::index_type;
+
+  /// @brief ベクトル命令で走査できる範囲
+  template <class R>
+  concept simd_searchable =
+    std::ranges::contiguous_range<R> and std::ranges::sized_range<R> and
+    simd::vectorizable<std::remove_cv_t<std::ranges::range_value_t<R>>>;
+
+
+  /// @brief Pred の判定を T の要素のベクトル比較に置き換えられるか
+  /// @details compare_to<Op, U> で、x と value の比較が T 同士の比較と同じ
+  /// 結果となる (通常の算術変換で U が T に揃えられる) ときに真となる。
+  template <class Pred, class T>
+  inline constexpr bool is_simd_predicate_v = false;
+  template <class Op, class U, class T>
+    requires(compare_op_of<Op>.has_value() and std::is_arithmetic_v<U>)
+  inline constexpr bool is_simd_predicate_v<compare_to<Op, U>, T> =
+    std::is_same_v<std::common_type_t<T, U>, T>;
+
+  /// @brief 連続した要素の先頭 p と要素数 n、先頭の添字 start を受け取る
+  /// simd と、enumerate_view を受け取る generic のどちらかに r を渡す
+  template <class R, class Simd, class Generic>
+  auto index_search_impl(R&& r, Simd simd, Generic generic) {
+    using Base = enumerated_base_t<R>;
+    if constexpr (is_enumerate_view_v<std::remove_cvref_t<R>>) {
+      if constexpr (simd_searchable<const Base>) {
+        // 元となる view はコピーできるとは限らないため、参照で読み出す
+        const Base& base = r.base_ref();
+        return simd(
+          std::ranges::data(base),
+          static_cast<std::size_t>(std::ranges::size(base)),
+          r.start());
+      } else {
+        return generic(r);
+      }
+    } else if constexpr (simd_searchable<R>) {
+      return simd(
+        std::ranges::data(r),
+        static_cast<std::size_t>(std::ranges::size(r)),
+        std::size_t(0));
+    } else {
+      auto e = enumerate_view(std::forward<R>(r));
+      return generic(e);
+    }
+  }
+
+  // argmin, argmax
+
+  template <bool Max, class R>
+  auto arg_extremum_impl(R&& r) -> std::optional<enumerated_index_t<R>> {
+    using Index = enumerated_index_t<R>;
+    using Value = std::ranges::range_value_t<enumerated_base_t<R>>;
+    return index_search_impl(
+      std::forward<R>(r),
+      [](const auto* p, std::size_t n, Index start) -> std::optional<Index> {
+        if (n == 0)
+          return std::nullopt;
+        return advance_index(
+          start, simd::arg_extremum<Max>(simd::detected_level(), p, n));
+      },
+      [](auto& e) -> std::optional<Index> {
+        std::optional<Index> pos;
+        std::optional<Value> value;
+        for (auto&& [i, x] : e) {
+          if (not pos or (Max ? *value < x : x < *value)) {
+            pos = i;
+            value = x;
+          }
+        }
+        return pos;
+      });
+  }
+
+  /// @brief 最初の最小の要素の添字を返す (空なら std::nullopt)
+  /// @details r が enumerate_view なら、その添字 (start() からの通し番号) を
+  /// 返す。std::ranges::min_element と同じ要素を選ぶ。要素型が
+  /// simd::vectorizable な連続した範囲では、実行時に選んだベクトル命令で
+  /// 走査する。
+  template <class R>
+    requires std::ranges::input_range<enumerated_base_t<R>> and
+             std::totally_ordered<
+      std::ranges::range_value_t<enumerated_base_t<R>>>
+  auto argmin(R&& r) -> std::optional<enumerated_index_t<R>> {
+    return arg_extremum_impl<false>(std::forward<R>(r));
+  }
+
+  /// @brief 最初の最大の要素の添字を返す (空なら std::nullopt)
+  /// @details std::ranges::max_element と同じ要素を選ぶ。その他は argmin と
+  /// 同じ。
+  template <class R>
+    requires std::ranges::input_range<enumerated_base_t<R>> and
+             std::totally_ordered<
+      std::ranges::range_value_t<enumerated_base_t<R>>>
+  auto argmax(R&& r) -> std::optional<enumerated_index_t<R>> {
+    return arg_extremum_impl<true>(std::forward<R>(r));
+  }
+
+  // find_index, count_if
+
+  /// @brief pred を満たす最初の要素の添字を返す (なければ std::nullopt)
+  /// @details pred には要素 (enumerate_view の場合も添字を除いた要素) を
+  /// 渡す。pred が less_than などの compare_to で、要素型が
+  /// simd::vectorizable な連続した範囲では、ベクトル命令で比較する。
+  template <class R, class Pred>
+    requires std::ranges::input_range<enumerated_base_t<R>> and
+             std::indirect_unary_predicate<
+      const Pred&,
+      std::ranges::iterator_t<enumerated_base_t<R>>>
+  auto find_index(R&& r, Pred pred) -> std::optional<enumerated_index_t<R>> {
+    using Index = enumerated_index_t<R>;
+    return index_search_impl(
+      std::forward<R>(r),
+      [&](const auto* p, std::size_t n, Index start) -> std::optional<Index> {
+        using T = std::remove_cvref_t<decltype(*p)>;
+        std::size_t k = n;
+        if constexpr (is_simd_predicate_v<Pred, T>) {
+          constexpr auto op = *compare_op_of<typename Pred::op_type>;
+          k = simd::find<op>(
+            simd::detected_level(), p, n, static_cast<T>(pred.value));
+        } else {
+          k = static_cast<std::size_t>(
+            std::ranges::find_if(p, p + n, std::cref(pred)) - p);
+        }
+        if (k == n)
+          return std::nullopt;
+        return advance_index(start, k);
+      },
+      [&](auto& e) -> std::optional<Index> {
+        for (auto&& [i, x] : e)
+          if (std::invoke(pred, x))
+            return i;
+        return std::nullopt;
+      });
+  }
+
+  /// @brief pred を満たす要素の数を返す
+  /// @details pred の扱いとベクトル化の条件は find_index と同じ。
+  template <class R, class Pred>
+    requires std::ranges::input_range<enumerated_base_t<R>> and
+             std::indirect_unary_predicate<
+      const Pred&,
+      std::ranges::iterator_t<enumerated_base_t<R>>>
+  auto count_if(R&& r, Pred pred) -> std::size_t {
+    using Index = enumerated_index_t<R>;
+    return index_search_impl(
+      std::forward<R>(r),
+      [&](const auto* p, std::size_t n, Index) -> std::size_t {
+        using T = std::remove_cvref_t<decltype(*p)>;
+        if constexpr (is_simd_predicate_v<Pred, T>) {
+          constexpr auto op = *compare_op_of<typename Pred::op_type>;
+          return simd::count<op>(
+            simd::detected_level(), p, n, static_cast<T>(pred.value));
+        } else {
+          return static_cast<std::size_t>(
+            std::ranges::count_if(p, p + n, std::cref(pred)));
+        }
+      },
+      [&](auto& e) -> std::size_t {
+        std::size_t count = 0;
+        for (auto&& [i, x] : e)
+          count += static_cast<std::size_t>(std::invoke(pred, x));
+        return count;
+      });
+  }
+} // namespace ns
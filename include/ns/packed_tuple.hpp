@@ -0,0 +1,197 @@
+/// @file packed_tuple.hpp
+#pragma once
+#include <ns/tuple_arrange.hpp>
+#include <array>
+#include <compare>
+#include <cstddef>
+#include <numeric>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace ns {
+  // packed_order
+
+  /// @brief パディングが最小になる要素の格納順を返す
+  /// @details アラインメントの降順、次に大きさの降順に並べる。どちらも等しい
+  /// 要素は宣言順を保つ。戻り値の j 番目は、格納位置 j に置く要素の宣言順での
+  /// 添字である。
+  template <class... Ts>
+  constexpr auto packed_order() -> std::array<std::size_t, sizeof...(Ts)> {
+    constexpr std::size_t N = sizeof...(Ts);
+    if constexpr (N == 0) {
+      return {};
+    } else {
+      constexpr std::array<std::size_t, N> aligns{alignof(Ts)...};
+      constexpr std::array<std::size_t, N> sizes{sizeof(Ts)...};
+      auto before = [&](std::size_t i, std::size_t j) {
+        if (aligns[i] != aligns[j])
+          return aligns[i] > aligns[j];
+        return sizes[i] > sizes[j];
+      };
+      std::array<std::size_t, N> order{};
+      std::iota(order.begin(), order.end(), 0);
+      // 安定な挿入ソート
+      for (std::size_t i = 1; i < N; ++i)
+        for (std::size_t j = i; j > 0 and before(order[j], order[j - 1]); --j)
+          std::swap(order[j], order[j - 1]);
+      return order;
+    }
+  }
+
+  /// @brief packed_order の逆置換 (宣言順での添字から格納位置への写像)
+  template <class... Ts>
+  constexpr auto packed_position() -> std::array<std::size_t, sizeof...(Ts)> {
+    constexpr auto order = packed_order<Ts...>();
+    std::array<std::size_t, sizeof...(Ts)> position{};
+    for (std::size_t j = 0; j < order.size(); ++j)
+      position[order[j]] = j;
+    return position;
+  }
+
+  // packed_tuple
+
+  /// @brief 要素をアラインメントの大きい順に格納し、パディングを減らした tuple
+  /// @details get<I> や get<T>、構造化束縛、比較は宣言順の tuple<Ts...> と
+  /// 同じように振る舞う。格納順のみが異なる。
+  /// @tparam Ts 宣言順での要素型
+  template <class... Ts>
+  struct packed_tuple {
+    using tuple_type = std::tuple<Ts...>;
+    //! 格納位置 j に置く要素の宣言順での添字
+    static constexpr auto order = packed_order<Ts...>();
+    //! 宣言順で I 番目の要素の格納位置
+    static constexpr auto position = packed_position<Ts...>();
+
+  private:
+    using storage_type = typename decltype(
+      []<std::size_t... Js>(std::index_sequence<Js...>) {
+        return std::type_identity<
+          std::tuple<std::tuple_element_t<order[Js], tuple_type>...>>{};
+      }(std::index_sequence_for<Ts...>{}))::type;
+
+    //! 格納順に並べた要素
+    storage_type storage_{};
+
+    /// @brief 宣言順の引数の参照を格納順に並べ替える
+    template <class Tuple>
+    static constexpr auto arrange(Tuple&& tpl) noexcept {
+      return [&]<std::size_t... Js>(std::index_sequence<Js...>) {
+        return tuple_select_ref<order[Js]...>(std::forward<Tuple>(tpl));
+      }(std::index_sequence_for<Ts...>{});
+    }
+
+  public:
+    packed_tuple() = default;
+
+    template <class... Us>
+      requires(sizeof...(Us) == sizeof...(Ts)) and (sizeof...(Ts) > 0) and
+      (not(sizeof...(Us) == 1 and
+           (std::is_same_v<std::remove_cvref_t<Us>, packed_tuple> and ...))) and
+      (std::is_constructible_v<Ts, Us&&> and ...)
+    constexpr explicit(not(std::is_convertible_v<Us&&, Ts> and ...))
+      packed_tuple(Us&&... us)
+      : storage_(arrange(std::forward_as_tuple(std::forward<Us>(us)...))) {}
+
+    /// @brief 宣言順の tuple から構築する
+    constexpr explicit packed_tuple(const tuple_type& tpl)
+      : storage_(arrange(tpl)) {}
+    constexpr explicit packed_tuple(tuple_type&& tpl)
+      : storage_(arrange(std::move(tpl))) {}
+
+    /// @brief 宣言順に並べた各要素への参照の tuple を返す
+    constexpr auto tie() & noexcept {
+      return [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+        return std::tuple<Ts&...>(get<Is>(*this)...);
+      }(std::index_sequence_for<Ts...>{});
+    }
+    constexpr auto tie() const& noexcept {
+      return [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+        return std::tuple<const Ts&...>(get<Is>(*this)...);
+      }(std::index_sequence_for<Ts...>{});
+    }
+
+    // get<I>
+
+    template <std::size_t I>
+    friend constexpr decltype(auto) get(packed_tuple& t) noexcept {
+      return std::get<position[I]>(t.storage_);
+    }
+    template <std::size_t I>
+    friend constexpr decltype(auto) get(const packed_tuple& t) noexcept {
+      return std::get<position[I]>(t.storage_);
+    }
+    template <std::size_t I>
+    friend constexpr decltype(auto) get(packed_tuple&& t) noexcept {
+      return std::get<position[I]>(std::move(t.storage_));
+    }
+    template <std::size_t I>
+    friend constexpr decltype(auto) get(const packed_tuple&& t) noexcept {
+      return std::get<position[I]>(std::move(t.storage_));
+    }
+
+    // get<T>
+
+    template <class T>
+    friend constexpr decltype(auto) get(packed_tuple& t) noexcept {
+      return get<tuple_element_index_v<T, tuple_type>>(t);
+    }
+    template <class T>
+    friend constexpr decltype(auto) get(const packed_tuple& t) noexcept {
+      return get<tuple_element_index_v<T, tuple_type>>(t);
+    }
+    template <class T>
+    friend constexpr decltype(auto) get(packed_tuple&& t) noexcept {
+      return get<tuple_element_index_v<T, tuple_type>>(std::move(t));
+    }
+    template <class T>
+    friend constexpr decltype(auto) get(const packed_tuple&& t) noexcept {
+      return get<tuple_element_index_v<T, tuple_type>>(std::move(t));
+    }
+
+    friend constexpr bool
+    operator==(const packed_tuple& x, const packed_tuple& y) {
+      return x.storage_ == y.storage_;
+    }
+    /// @details 格納順ではなく宣言順で辞書式に比較する
+    friend constexpr auto
+    operator<=>(const packed_tuple& x, const packed_tuple& y) {
+      return x.tie() <=> y.tie();
+    }
+  };
+
+  template <class... Ts>
+  packed_tuple(Ts...) -> packed_tuple<Ts...>;
+
+  // tuple_select, tuple_select_by_type
+
+  /// @brief 宣言順で Is... 番目の要素からなる tuple を返す
+  template <std::size_t... Is, class... Ts>
+  constexpr auto tuple_select(const packed_tuple<Ts...>& t)
+    -> std::tuple<std::tuple_element_t<Is, std::tuple<Ts...>>...> {
+    return {get<Is>(t)...};
+  }
+  template <std::size_t... Is, class... Ts>
+  constexpr auto tuple_select(packed_tuple<Ts...>&& t)
+    -> std::tuple<std::tuple_element_t<Is, std::tuple<Ts...>>...> {
+    return {get<Is>(std::move(t))...};
+  }
+
+  template <class... Us, class... Ts>
+  constexpr auto tuple_select_by_type(const packed_tuple<Ts...>& t) {
+    return tuple_select<tuple_element_index_v<Us, std::tuple<Ts...>>...>(t);
+  }
+  template <class... Us, class... Ts>
+  constexpr auto tuple_select_by_type(packed_tuple<Ts...>&& t) {
+    return tuple_select<tuple_element_index_v<Us, std::tuple<Ts...>>...>(
+      std::move(t));
+  }
+} // namespace ns
+
+template <class... Ts>
+struct std::tuple_size<ns::packed_tuple<Ts...>>
+  : std::integral_constant<std::size_t, sizeof...(Ts)> {};
+
+template <std::size_t I, class... Ts>
+struct std::tuple_element<I, ns::packed_tuple<Ts...>>
+  : std::tuple_element<I, std::tuple<Ts...>> {};
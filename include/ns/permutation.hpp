@@ -0,0 +1,204 @@
+/// @file permutation.hpp
+#pragma once
+#include <ns/random.hpp>
+#include <algorithm>
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <numeric>
+#include <ranges>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace ns {
+  // parallel_invoke_indexed
+
+  /// @brief f(0), f(1), ..., f(count - 1) を最大 threads 本のスレッドで呼ぶ
+  /// @details i 番目の呼び出しはスレッド i % threads で行う。呼び出しの結果が
+  /// 呼び出す順に依存しなければ、結果はスレッド数によらない。
+  template <class F>
+  void parallel_invoke_indexed(std::size_t count, unsigned threads, F f) {
+    if (count == 0)
+      return;
+    const std::size_t t = std::clamp<std::size_t>(threads, 1, count);
+    if (t <= 1) {
+      for (std::size_t i = 0; i < count; ++i)
+        f(i);
+      return;
+    }
+    std::vector<std::thread> workers;
+    workers.reserve(t - 1);
+    auto work = [&](std::size_t first) {
+      for (std::size_t i = first; i < count; i += t)
+        f(i);
+    };
+    for (std::size_t k = 1; k < t; ++k)
+      workers.emplace_back(work, k);
+    work(0);
+    for (auto& w : workers)
+      w.join();
+  }
+
+  // make_permutation
+
+  /// @brief 種と処理単位の番号から、独立した乱数列の種を作る
+  constexpr auto stream_seed(std::uint64_t seed, std::uint64_t stream) noexcept
+    -> std::uint64_t {
+    std::uint64_t state = seed ^ (stream * 0xd1342543de82ef95);
+    return random::splitmix64(state);
+  }
+
+  /// @brief [0, n) の一様ランダムな置換を返す
+  /// @details バケットに分けた並列 Fisher-Yates で生成する。
+  /// 1. 添字を固定長のチャンクに分け、各要素を一様ランダムに選んだバケットに
+  ///    割り当てる (チャンクごとに並列)。
+  /// 2. (バケット, チャンク) の順の累積和で出力位置を決めて書き込む。
+  /// 3. 各バケットの中を Fisher-Yates で並べ替える (バケットごとに並列)。
+  ///
+  /// チャンクとバケットの大きさは n のみで決まり、各チャンク・バケットは
+  /// 専用の乱数列を用いるため、結果は seed と n のみで決まり threads に
+  /// よらない。チャンクごとの計数は チャンク数 * バケット数 個となるため、
+  /// バケット数には上限を設け、n が大きいときはバケットを大きくする。
+  /// @tparam Index 添字の型 (n 以下の値を表せること)
+  /// @param threads 用いるスレッド数 (0 のときは 1 とみなす)
+  template <std::unsigned_integral Index = std::size_t>
+  auto make_permutation(
+    std::size_t n,
+    std::uint64_t seed,
+    unsigned threads = std::thread::hardware_concurrency())
+    -> std::vector<Index> {
+    // 1 バケットが L2 キャッシュに収まる程度の大きさ
+    constexpr std::size_t block = std::size_t(1) << 18;
+    // バケット数の上限 (n = 2^32 でも計数は 16384 * 1024 個に収まる)
+    constexpr std::size_t max_buckets = 1024;
+
+    assert(n == 0 or n - 1 <= std::numeric_limits<Index>::max());
+    std::vector<Index> perm(n);
+    if (n <= block) {
+      std::iota(perm.begin(), perm.end(), Index(0));
+      random::xoshiro256ss gen(stream_seed(seed, 0));
+      for (std::size_t i = n; i > 1; --i) {
+        const auto j = static_cast<std::size_t>(random::uniform_below(gen, i));
+        std::swap(perm[i - 1], perm[j]);
+      }
+      return perm;
+    }
+
+    const std::size_t chunks = (n + block - 1) / block;
+    const std::size_t buckets = std::min(chunks, max_buckets);
+    // offsets[c * buckets + b]: チャンク c のうちバケット b に入る要素数
+    std::vector<std::size_t> offsets(chunks * buckets);
+
+    // 2 回目の走査では同じ乱数列を引き直し、同じバケット番号を得る。各要素の
+    // バケット番号を保存するより、メモリの読み書きが少ない。
+    auto bucket_draws = [&](std::size_t c) {
+      return random::xoshiro256ss(stream_seed(seed, 2 * c + 1));
+    };
+
+    parallel_invoke_indexed(chunks, threads, [&](std::size_t c) {
+      auto gen = bucket_draws(c);
+      const std::size_t last = std::min(n, (c + 1) * block);
+      auto* counts = offsets.data() + c * buckets;
+      for (std::size_t i = c * block; i < last; ++i)
+        ++counts[random::uniform_below(gen, buckets)];
+    });
+
+    // バケット優先・チャンク順の排他的累積和
+    std::vector<std::size_t> bucket_first(buckets + 1);
+    {
+      std::size_t sum = 0;
+      for (std::size_t b = 0; b < buckets; ++b) {
+        bucket_first[b] = sum;
+        for (std::size_t c = 0; c < chunks; ++c) {
+          const std::size_t count = offsets[c * buckets + b];
+          offsets[c * buckets + b] = sum;
+          sum += count;
+        }
+      }
+      bucket_first[buckets] = sum;
+    }
+
+    parallel_invoke_indexed(chunks, threads, [&](std::size_t c) {
+      auto gen = bucket_draws(c);
+      const std::size_t last = std::min(n, (c + 1) * block);
+      auto* next = offsets.data() + c * buckets;
+      for (std::size_t i = c * block; i < last; ++i)
+        perm[next[random::uniform_below(gen, buckets)]++] =
+          static_cast<Index>(i);
+    });
+
+    parallel_invoke_indexed(buckets, threads, [&](std::size_t b) {
+      random::xoshiro256ss gen(stream_seed(seed, 2 * b + 2));
+      auto* first = perm.data() + bucket_first[b];
+      for (std::size_t i = bucket_first[b + 1] - bucket_first[b]; i > 1; --i) {
+        const auto j = static_cast<std::size_t>(random::uniform_below(gen, i));
+        std::swap(first[i - 1], first[j]);
+      }
+    });
+    return perm;
+  }
+
+  // apply_permutation
+
+  /// @brief 各 rs を、i 番目の要素が元の perm[i] 番目の要素となるよう並べ替える
+  /// @details 置換の巡回を辿り、各要素を 1 回ずつムーブする。辿り終えた位置の
+  /// 印として要素数ビットの作業領域を用いる。すべての rs を 1 回の巡回で同時に
+  /// 並べ替えるため、apply_permutation(argsort(key), key, values...) で複数の
+  /// 列をキーの順に並べられる。巡回を辿る読み出しは互いに依存するため、
+  /// 作業領域を確保できるなら新しい配列に集めるほうが速い。
+  /// @pre perm は [0, n) の置換であり、rs の要素数はすべて n である
+  template <std::ranges::random_access_range Perm, class... Rs>
+    requires(sizeof...(Rs) > 0) and
+            std::unsigned_integral<std::ranges::range_value_t<Perm>> and
+            (std::ranges::random_access_range<Rs> and ...) and
+            // C++20 の std::tuple によるプロキシ参照 (soa_vector など) は
+            // std::permutable を満たさないため、実際に行う代入のみを要求する
+            (std::is_assignable_v<
+               std::ranges::range_reference_t<Rs>,
+               std::ranges::range_rvalue_reference_t<Rs>> and ...) and
+            (std::is_assignable_v<
+               std::ranges::range_reference_t<Rs>,
+               std::ranges::range_value_t<Rs>&&> and ...)
+  void apply_permutation(const Perm& perm, Rs&&... rs) {
+    const auto n = static_cast<std::size_t>(std::ranges::size(perm));
+    assert(((static_cast<std::size_t>(std::ranges::size(rs)) == n) and ...));
+    const auto p = std::ranges::begin(perm);
+    const auto firsts = std::tuple(std::ranges::begin(rs)...);
+    auto at = [](auto it, std::size_t i) {
+      return it + static_cast<std::iter_difference_t<decltype(it)>>(i);
+    };
+
+    std::vector<bool> done(n);
+    for (std::size_t start = 0; start < n; ++start) {
+      if (done[start])
+        continue;
+      done[start] = true;
+      const auto first_next = static_cast<std::size_t>(*at(p, start));
+      if (first_next == start)
+        continue;
+      std::apply(
+        [&](auto... its) {
+          // 巡回の先頭の要素を退避し、残りを 1 つずつ前に詰める
+          std::tuple<std::iter_value_t<decltype(its)>...> saved(
+            std::ranges::iter_move(at(its, start))...);
+          std::size_t j = start;
+          for (std::size_t k = first_next; k != start;
+               k = static_cast<std::size_t>(*at(p, k))) {
+            ((*at(its, j) = std::ranges::iter_move(at(its, k))), ...);
+            done[k] = true;
+            j = k;
+          }
+          std::apply(
+            [&](auto&... xs) { ((*at(its, j) = std::move(xs)), ...); },
+            saved);
+        },
+        firsts);
+    }
+  }
+} // namespace ns
@@ -0,0 +1,380 @@
+/// @file pipeline.hpp
+#pragma once
+#include <algorithm>
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <ranges>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace ns {
+  namespace pipe {
+    /// @brief sink に x を渡し、走査を続けるかを返す
+    /// @details sink の戻り値が void のときは常に続ける。
+    template <class Sink, class T>
+    constexpr bool push(Sink& sink, T&& x) {
+      if constexpr (std::is_void_v<std::invoke_result_t<Sink&, T>>) {
+        std::invoke(sink, std::forward<T>(x));
+        return true;
+      } else {
+        return static_cast<bool>(std::invoke(sink, std::forward<T>(x)));
+      }
+    }
+
+    /// @brief パイプラインの段の基底
+    /// @details 各段は、入力の型 T から出力の型を求める output_t<T> と、
+    /// 後続の sink を受け取って自身の sink を返す bind(next) をもつ。sink は
+    /// 要素を 1 つ受け取るたびに呼ばれ、走査を続けるかを返す。いずれかの段の
+    /// empty() が true であれば、pipeline は走査を行わない。
+    struct stage_base {
+      /// @brief 要素を 1 つも出力しないことが走査の前にわかるか
+      constexpr bool empty() const noexcept {
+        return false;
+      }
+    };
+
+    template <class S>
+    concept stage = std::derived_from<S, stage_base>;
+
+    // enumerate
+
+    template <std::integral Index>
+    struct enumerate_stage : stage_base {
+      Index start;
+
+      template <class T>
+      using output_t = std::pair<Index, T>;
+
+      template <class Next>
+      struct sink {
+        Index index;
+        Next next;
+
+        template <class T>
+        constexpr bool operator()(T&& x) {
+          return push(next, std::pair<Index, T>(index++, std::forward<T>(x)));
+        }
+      };
+
+      template <class Next>
+      constexpr auto bind(Next next) const {
+        return sink<Next>{start, std::move(next)};
+      }
+    };
+
+    /// @brief 要素を (通し番号, 要素) の組にする
+    /// @details 要素が左辺値であれば、組の要素はその参照となる
+    /// (enumerate_view と同じ)。
+    template <std::integral Index = std::size_t>
+    constexpr enumerate_stage<Index> enumerate(Index start = 0) {
+      return {{}, start};
+    }
+
+    // filter
+
+    template <class Pred>
+    struct filter_stage : stage_base {
+      Pred pred;
+
+      template <class T>
+      using output_t = T;
+
+      template <class Next>
+      struct sink {
+        Pred pred;
+        Next next;
+
+        template <class T>
+        constexpr bool operator()(T&& x) {
+          if (not std::invoke(pred, x))
+            return true;
+          return push(next, std::forward<T>(x));
+        }
+      };
+
+      template <class Next>
+      constexpr auto bind(Next next) const {
+        return sink<Next>{pred, std::move(next)};
+      }
+    };
+
+    /// @brief pred を満たす要素のみを残す
+    template <class Pred>
+    constexpr filter_stage<Pred> filter(Pred pred) {
+      return {{}, std::move(pred)};
+    }
+
+    // transform
+
+    template <class F>
+    struct transform_stage : stage_base {
+      F f;
+
+      template <class T>
+      using output_t = std::invoke_result_t<F&, T>;
+
+      template <class Next>
+      struct sink {
+        F f;
+        Next next;
+
+        template <class T>
+        constexpr bool operator()(T&& x) {
+          return push(next, std::invoke(f, std::forward<T>(x)));
+        }
+      };
+
+      template <class Next>
+      constexpr auto bind(Next next) const {
+        return sink<Next>{f, std::move(next)};
+      }
+    };
+
+    /// @brief 要素を f(要素) に置き換える
+    template <class F>
+    constexpr transform_stage<F> transform(F f) {
+      return {{}, std::move(f)};
+    }
+
+    // take
+
+    struct take_stage : stage_base {
+      std::size_t count;
+
+      template <class T>
+      using output_t = T;
+
+      template <class Next>
+      struct sink {
+        std::size_t remaining;
+        Next next;
+
+        /// @pre remaining > 0 (take(0) は pipeline が走査の前に除く)
+        template <class T>
+        constexpr bool operator()(T&& x) {
+          --remaining;
+          return push(next, std::forward<T>(x)) and remaining != 0;
+        }
+      };
+
+      template <class Next>
+      constexpr auto bind(Next next) const {
+        return sink<Next>{count, std::move(next)};
+      }
+
+      constexpr bool empty() const noexcept {
+        return count == 0;
+      }
+    };
+
+    /// @brief 先頭から count 個の要素のみを残す
+    /// @details count 個目の要素を渡した時点で元となる範囲の走査を終えるため、
+    /// 無限の範囲にも使える。
+    constexpr take_stage take(std::size_t count) {
+      return {{}, count};
+    }
+
+    // stride
+
+    struct stride_stage : stage_base {
+      std::size_t step;
+
+      template <class T>
+      using output_t = T;
+
+      template <class Next>
+      struct sink {
+        std::size_t step;
+        //! 次の要素を渡すまでに読み飛ばす要素の数
+        std::size_t skip = 0;
+        Next next;
+
+        template <class T>
+        constexpr bool operator()(T&& x) {
+          if (skip != 0) {
+            --skip;
+            return true;
+          }
+          skip = step - 1;
+          return push(next, std::forward<T>(x));
+        }
+      };
+
+      template <class Next>
+      constexpr auto bind(Next next) const {
+        return sink<Next>{step, 0, std::move(next)};
+      }
+    };
+
+    /// @brief 先頭から step 個おきの要素のみを残す
+    /// @pre step > 0
+    constexpr stride_stage stride(std::size_t step) {
+      assert(step > 0);
+      return {{}, step};
+    }
+
+    template <class T, class... Stages>
+    struct output {
+      using type = T;
+    };
+    template <class T, class S, class... Rest>
+    struct output<T, S, Rest...>
+      : output<typename S::template output_t<T>, Rest...> {};
+
+    /// @brief 先頭から続く take, stride の段の数
+    /// @details 元となる範囲がランダムアクセスできれば、これらの段は添字の
+    /// 計算に置き換えられる。
+    template <class... Stages>
+    inline constexpr std::size_t index_prefix_size = 0;
+    template <class S, class... Rest>
+    inline constexpr std::size_t index_prefix_size<S, Rest...> =
+      std::same_as<S, take_stage> or std::same_as<S, stride_stage>
+        ? 1 + index_prefix_size<Rest...>
+        : 0;
+
+    /// @brief take, stride を、元となる範囲から step 個おきに count 個を
+    /// 取り出す添字の計算に反映する
+    constexpr void
+    apply_index(const take_stage& s, std::size_t&, std::size_t& count) {
+      count = std::min(count, s.count);
+    }
+    constexpr void
+    apply_index(const stride_stage& s, std::size_t& step, std::size_t& count) {
+      count = (count + s.step - 1) / s.step;
+      step *= s.step;
+    }
+
+    /// @brief 要素の型 (enumerate の組は、参照を外した組とする)
+    template <class T>
+    struct value_of {
+      using type = std::remove_cvref_t<T>;
+    };
+    template <class Index, class T>
+    struct value_of<std::pair<Index, T>> {
+      using type = std::pair<Index, std::remove_cvref_t<T>>;
+    };
+  } // namespace pipe
+
+  // pipeline
+
+  /// @brief enumerate, filter, transform, take, stride の連鎖を、1 重の
+  /// ループ (内部イテレーション) として実行する
+  /// @details 範囲アダプタを重ねると、イテレータが入れ子になり、各層で末尾の
+  /// 判定が繰り返される。pipeline は各段を「要素を受け取って次の段へ渡す
+  /// sink」として合成し、元となる範囲を 1 回走査する for 文の中ですべての段を
+  /// 実行する。take で必要な数の要素を得た時点で走査を終える。元となる範囲が
+  /// ランダムアクセスできれば、先頭から続く take, stride は添字の計算に
+  /// 置き換える。
+  ///
+  /// @code
+  /// ns::pipeline(std::views::iota(0))
+  ///   | ns::pipe::filter([](int x) { return x % 2 == 0; })
+  ///   | ns::pipe::transform([](int x) { return x * x; })
+  ///   | ns::pipe::take(4)
+  /// @endcode
+  /// @tparam Source 元となる view の型
+  /// @tparam Stages 段の型
+  template <std::ranges::input_range Source, pipe::stage... Stages>
+    requires std::ranges::view<Source>
+  struct pipeline {
+  private:
+    //! 元となる view
+    Source source_;
+    //! 各段
+    std::tuple<Stages...> stages_;
+
+    /// @brief [First, I) 番目の段を sink の前に合成する
+    template <std::size_t First, std::size_t I, class Sink>
+    constexpr auto bind(Sink sink) const {
+      if constexpr (I == First)
+        return sink;
+      else
+        return bind<First, I - 1>(
+          std::get<I - 1>(stages_).bind(std::move(sink)));
+    }
+
+  public:
+    //! 最後の段が sink に渡す要素の型
+    using reference = typename pipe::output<
+      std::ranges::range_reference_t<Source>,
+      Stages...>::type;
+    using value_type =
+      typename pipe::value_of<std::remove_cvref_t<reference>>::type;
+
+    constexpr explicit pipeline(Source source, Stages... stages)
+      : source_(std::move(source)), stages_(std::move(stages)...) {}
+
+    /// @brief 段を末尾に加えたパイプラインを返す
+    template <pipe::stage S>
+    constexpr auto operator|(S s) const& {
+      return std::apply(
+        [&](const Stages&... stages) {
+          return pipeline<Source, Stages..., S>(source_, stages..., s);
+        },
+        stages_);
+    }
+    template <pipe::stage S>
+    constexpr auto operator|(S s) && {
+      return std::apply(
+        [&](Stages&... stages) {
+          return pipeline<Source, Stages..., S>(
+            std::move(source_), std::move(stages)..., std::move(s));
+        },
+        stages_);
+    }
+
+    /// @brief 最後の段が出力する各要素について sink を呼ぶ
+    /// @details sink が bool に変換できる値を返すときは、false を返した時点で
+    /// 走査を終える。
+    template <class Sink>
+      requires std::invocable<Sink&, reference>
+    constexpr void for_each(Sink sink) {
+      const bool empty = std::apply(
+        [](const Stages&... stages) { return (stages.empty() or ...); },
+        stages_);
+      if (empty)
+        return;
+      constexpr std::size_t prefix = pipe::index_prefix_size<Stages...>;
+      if constexpr (
+        prefix != 0 and std::ranges::random_access_range<Source> and
+        std::ranges::sized_range<Source>) {
+        // 先頭の take, stride は添字の計算に置き換え、読み飛ばす要素を
+        // 走査しない
+        std::size_t step = 1;
+        auto count = static_cast<std::size_t>(std::ranges::size(source_));
+        [&]<std::size_t... I>(std::index_sequence<I...>) {
+          (pipe::apply_index(std::get<I>(stages_), step, count), ...);
+        }(std::make_index_sequence<prefix>());
+        auto first = bind<prefix, sizeof...(Stages)>(std::move(sink));
+        const auto it = std::ranges::begin(source_);
+        for (std::size_t k = 0; k < count; ++k)
+          if (not pipe::push(
+                first,
+                it[static_cast<std::ranges::range_difference_t<Source>>(
+                  k * step)]))
+            return;
+      } else {
+        auto first = bind<0, sizeof...(Stages)>(std::move(sink));
+        for (auto&& x : source_)
+          if (not pipe::push(first, std::forward<decltype(x)>(x)))
+            return;
+      }
+    }
+
+    /// @brief 最後の段が出力する要素を std::vector に集める
+    constexpr std::vector<value_type> to_vector() {
+      std::vector<value_type> result;
+      for_each([&](reference x) {
+        result.emplace_back(std::forward<reference>(x));
+      });
+      return result;
+    }
+  };
+
+  template <class Range>
+  pipeline(Range&&) -> pipeline<std::views::all_t<Range>>;
+} // namespace ns
@@ -0,0 +1,291 @@
+/// @file prefetch_view.hpp
+#pragma once
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+
+namespace ns {
+  /// @brief p を含むキャッシュラインを、読み出しのためにプリフェッチする
+  /// @details プリフェッチは例外を送出せず、無効なアドレスでもよい。対応する
+  /// 組み込み関数のない環境では何もしない。
+  inline void prefetch(const void* p) noexcept {
+#if defined(__GNUC__)
+    __builtin_prefetch(p);
+#else
+    static_cast<void>(p);
+#endif
+  }
+
+  /// @brief 要素が左辺値であればそのアドレスを返す (prefetch_view の既定)
+  /// @details 要素が prvalue のときはプリフェッチする対象がないため nullptr を
+  /// 返す。
+  struct element_address {
+    template <class T>
+    constexpr const void* operator()(T&& x) const noexcept {
+      if constexpr (std::is_lvalue_reference_v<T>)
+        return std::addressof(x);
+      else
+        return nullptr;
+    }
+  };
+
+  /// @brief 消費する位置より distance 個先の要素をプリフェッチしながら走査する
+  /// view
+  /// @details std::list や std::forward_list のように、要素がヒープ上に散らばる
+  /// 範囲の走査では各ステップがキャッシュミスとなる。prefetch_view の
+  /// イテレータは、現在位置に加えて distance 個先を指す先読みのイテレータを
+  /// もち、先読みが通過する要素について proj(要素) が返すアドレスを
+  /// プリフェッチする。proj に要素が指す先 (std::list<T*> の *p など) を
+  /// 返させると、消費する側が読むデータを先に取り寄せられる。
+  /// 先読みのイテレータ自体はノードを順に辿るため、ノードの next の読み出しが
+  /// 直列であることは変わらない。効果が大きいのは、要素ごとの処理や要素が指す
+  /// 先の読み出しが、ノードを辿る時間に比べて重いときである。
+  /// proj を渡すと、各要素は先読みと消費の 2 回読み出される (transform_view
+  /// なら変換が 2 回呼ばれる)。既定の element_address で要素が prvalue の
+  /// ときは、プリフェッチするアドレスがないため先読みでは読み出さない。
+  /// @tparam View 元となる view の型
+  /// @tparam Proj 要素からプリフェッチするアドレスを求める関数オブジェクトの型
+  template <std::ranges::forward_range View, class Proj = element_address>
+    requires std::ranges::view<View> and std::is_object_v<Proj> and
+             std::regular_invocable<
+               const Proj&,
+               std::ranges::range_reference_t<View>> and
+             std::convertible_to<
+               std::invoke_result_t<
+                 const Proj&,
+                 std::ranges::range_reference_t<View>>,
+               const void*>
+  struct prefetch_view
+    : std::ranges::view_interface<prefetch_view<View, Proj>> {
+  private:
+    //! 元となる view
+    View base_ = View();
+    //! 先読みする要素数
+    std::size_t distance_ = 8;
+    //! プリフェッチするアドレスを求める関数オブジェクト
+    [[no_unique_address]] Proj proj_ = Proj();
+
+    template <bool Const>
+    struct iterator;
+    template <bool Const>
+    struct sentinel;
+
+  public:
+    prefetch_view()
+      requires std::default_initializable<View> and
+               std::default_initializable<Proj>
+    = default;
+    /// @param distance 先読みする要素数 (0 のときはプリフェッチしない)
+    constexpr explicit prefetch_view(
+      View base,
+      std::size_t distance = 8,
+      Proj proj = Proj())
+      : base_(std::move(base)), distance_(distance), proj_(std::move(proj)) {}
+
+    constexpr View base() const&
+      requires std::copy_constructible<View>
+    {
+      return base_;
+    }
+    constexpr View base() && {
+      return std::move(base_);
+    }
+
+    /// @brief 先読みする要素数
+    constexpr std::size_t distance() const noexcept {
+      return distance_;
+    }
+
+    constexpr iterator<false> begin() {
+      return {*this, std::ranges::begin(base_)};
+    }
+    constexpr iterator<true> begin() const
+      requires std::ranges::forward_range<const View> and
+               std::regular_invocable<
+                 const Proj&,
+                 std::ranges::range_reference_t<const View>>
+    {
+      return {*this, std::ranges::begin(base_)};
+    }
+
+    constexpr auto end() {
+      if constexpr (std::ranges::common_range<View>)
+        return iterator<false>(*this, std::ranges::end(base_));
+      else
+        return sentinel<false>(std::ranges::end(base_));
+    }
+    constexpr auto end() const
+      requires std::ranges::forward_range<const View> and
+               std::regular_invocable<
+                 const Proj&,
+                 std::ranges::range_reference_t<const View>>
+    {
+      if constexpr (std::ranges::common_range<const View>)
+        return iterator<true>(*this, std::ranges::end(base_));
+      else
+        return sentinel<true>(std::ranges::end(base_));
+    }
+
+    constexpr auto size()
+      requires std::ranges::sized_range<View>
+    {
+      return std::ranges::size(base_);
+    }
+    constexpr auto size() const
+      requires std::ranges::sized_range<const View>
+    {
+      return std::ranges::size(base_);
+    }
+  };
+
+  template <class Range>
+  prefetch_view(Range&&) -> prefetch_view<std::views::all_t<Range>>;
+  template <class Range>
+  prefetch_view(Range&&, std::size_t)
+    -> prefetch_view<std::views::all_t<Range>>;
+  template <class Range, class Proj>
+  prefetch_view(Range&&, std::size_t, Proj)
+    -> prefetch_view<std::views::all_t<Range>, Proj>;
+
+  template <std::ranges::forward_range View, class Proj>
+    requires std::ranges::view<View> and std::is_object_v<Proj> and
+             std::regular_invocable<
+               const Proj&,
+               std::ranges::range_reference_t<View>> and
+             std::convertible_to<
+               std::invoke_result_t<
+                 const Proj&,
+                 std::ranges::range_reference_t<View>>,
+               const void*>
+  template <bool Const>
+  struct prefetch_view<View, Proj>::iterator {
+  private:
+    using Parent =
+      std::conditional_t<Const, const prefetch_view, prefetch_view>;
+    using Base = std::conditional_t<Const, const View, View>;
+    template <bool>
+    friend struct iterator;
+
+    //! 現在位置
+    std::ranges::iterator_t<Base> current_ = std::ranges::iterator_t<Base>();
+    //! 先読みの位置 (現在位置の distance 個先、または末尾)
+    std::ranges::iterator_t<Base> ahead_ = std::ranges::iterator_t<Base>();
+    Parent* parent_ = nullptr;
+
+    //! 要素を読み出してプリフェッチするか (既定の射影で要素が prvalue の
+    //! ときは、アドレスがないため読み出さない)
+    static constexpr bool reads_ahead =
+      not(std::same_as<Proj, element_address> and
+          not std::is_lvalue_reference_v<std::ranges::range_reference_t<Base>>);
+
+    /// @brief 先読みの位置が末尾でなければ、その要素をプリフェッチして進める
+    constexpr void advance_ahead() {
+      if (ahead_ == std::ranges::end(parent_->base_))
+        return;
+      if constexpr (reads_ahead)
+        if (not std::is_constant_evaluated())
+          prefetch(std::invoke(parent_->proj_, *ahead_));
+      ++ahead_;
+    }
+
+  public:
+    using difference_type = std::ranges::range_difference_t<Base>;
+    using value_type = std::ranges::range_value_t<Base>;
+    using iterator_concept = std::forward_iterator_tag;
+    // 要素が prvalue のときは Cpp17ForwardIterator の要件を満たさない
+    using iterator_category = std::conditional_t<
+      std::is_lvalue_reference_v<std::ranges::range_reference_t<Base>>,
+      std::forward_iterator_tag,
+      std::input_iterator_tag>;
+
+    iterator()
+      requires std::default_initializable<std::ranges::iterator_t<Base>>
+    = default;
+    constexpr iterator(Parent& parent, std::ranges::iterator_t<Base> current)
+      : current_(std::move(current)), ahead_(current_), parent_(&parent) {
+      for (std::size_t k = 0; k < parent.distance_; ++k)
+        advance_ahead();
+    }
+    constexpr /* implicit */ iterator(iterator<not Const> other)
+      requires Const and std::convertible_to<
+                           std::ranges::iterator_t<View>,
+                           std::ranges::iterator_t<Base>>
+      : current_(std::move(other.current_)),
+        ahead_(std::move(other.ahead_)),
+        parent_(other.parent_) {}
+
+    constexpr const std::ranges::iterator_t<Base>& base() const& noexcept {
+      return current_;
+    }
+    constexpr std::ranges::iterator_t<Base> base() && {
+      return std::move(current_);
+    }
+
+    constexpr std::ranges::range_reference_t<Base> operator*() const {
+      return *current_;
+    }
+
+    constexpr iterator& operator++() {
+      ++current_;
+      if (parent_->distance_ != 0)
+        advance_ahead();
+      return *this;
+    }
+    constexpr iterator operator++(int) {
+      auto tmp = *this;
+      ++*this;
+      return tmp;
+    }
+
+    friend constexpr bool operator==(const iterator& x, const iterator& y) {
+      return x.current_ == y.current_;
+    }
+
+    friend constexpr std::ranges::range_rvalue_reference_t<Base>
+    iter_move(const iterator& x) noexcept(
+      noexcept(std::ranges::iter_move(x.current_))) {
+      return std::ranges::iter_move(x.current_);
+    }
+  };
+
+  template <std::ranges::forward_range View, class Proj>
+    requires std::ranges::view<View> and std::is_object_v<Proj> and
+             std::regular_invocable<
+               const Proj&,
+               std::ranges::range_reference_t<View>> and
+             std::convertible_to<
+               std::invoke_result_t<
+                 const Proj&,
+                 std::ranges::range_reference_t<View>>,
+               const void*>
+  template <bool Const>
+  struct prefetch_view<View, Proj>::sentinel {
+  private:
+    using Base = std::conditional_t<Const, const View, View>;
+    template <bool>
+    friend struct sentinel;
+
+    //! 元となる view の番兵イテレータ
+    std::ranges::sentinel_t<Base> end_ = std::ranges::sentinel_t<Base>();
+
+  public:
+    sentinel() = default;
+    constexpr explicit sentinel(std::ranges::sentinel_t<Base> end)
+      : end_(std::move(end)) {}
+    constexpr /* implicit */ sentinel(sentinel<not Const> other)
+      requires Const and std::convertible_to<
+                           std::ranges::sentinel_t<View>,
+                           std::ranges::sentinel_t<Base>>
+      : end_(std::move(other.end_)) {}
+
+    friend constexpr bool
+    operator==(const iterator<Const>& x, const sentinel& y) {
+      return x.base() == y.end_;
+    }
+  };
+} // namespace ns
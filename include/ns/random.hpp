@@ -0,0 +1,206 @@
+/// @file random.hpp
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <utility>
+
+namespace ns::random {
+  // splitmix64
+
+  /// @brief state を進め、次の値を返す
+  /// @details 64 ビットの種から xoshiro256** の状態を作るために用いる。
+  /// https://prng.di.unimi.it/splitmix64.c
+  constexpr auto splitmix64(std::uint64_t& state) noexcept -> std::uint64_t {
+    std::uint64_t z = (state += 0x9e3779b97f4a7c15);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+    return z ^ (z >> 31);
+  }
+
+  constexpr auto rotl(std::uint64_t x, int k) noexcept -> std::uint64_t {
+    return (x << k) | (x >> (64 - k));
+  }
+
+  // xoshiro256ss
+
+  /// @brief xoshiro256** 疑似乱数生成器
+  /// @details 周期は 2^256 - 1。constexpr で使え、
+  /// std::uniform_random_bit_generator を満たす。
+  /// https://prng.di.unimi.it/xoshiro256starstar.c
+  struct xoshiro256ss {
+    using result_type = std::uint64_t;
+    using state_type = std::array<std::uint64_t, 4>;
+
+  private:
+    state_type s_{};
+
+  public:
+    /// @brief seed から splitmix64 で状態を作る
+    constexpr explicit xoshiro256ss(std::uint64_t seed = 0) noexcept {
+      for (auto& s : s_)
+        s = splitmix64(seed);
+    }
+    /// @brief 状態を直接与える (すべてが 0 であってはならない)
+    constexpr explicit xoshiro256ss(const state_type& s) noexcept : s_(s) {}
+
+    static constexpr result_type min() noexcept {
+      return 0;
+    }
+    static constexpr result_type max() noexcept {
+      return std::numeric_limits<result_type>::max();
+    }
+
+    constexpr result_type operator()() noexcept {
+      const std::uint64_t result = rotl(s_[1] * 5, 7) * 9;
+      const std::uint64_t t = s_[1] << 17;
+      s_[2] ^= s_[0];
+      s_[3] ^= s_[1];
+      s_[1] ^= s_[2];
+      s_[0] ^= s_[3];
+      s_[2] ^= t;
+      s_[3] = rotl(s_[3], 45);
+      return result;
+    }
+
+    /// @brief 2^128 回 operator() を呼んだのと同じだけ状態を進める
+    /// @details 重ならない 2^128 個の部分列を並列に使うために用いる。
+    constexpr void jump() noexcept {
+      constexpr state_type table{
+        0x180ec6d33cfd0aba,
+        0xd5a61266f0c9392c,
+        0xa9582618e03fc9aa,
+        0x39abdc4529b1661c,
+      };
+      state_type s{};
+      for (auto word : table) {
+        for (int b = 0; b < 64; ++b) {
+          if (word & (std::uint64_t(1) << b))
+            for (std::size_t i = 0; i < s.size(); ++i)
+              s[i] ^= s_[i];
+          (*this)();
+        }
+      }
+      s_ = s;
+    }
+
+    constexpr const state_type& state() const noexcept {
+      return s_;
+    }
+
+    friend constexpr bool
+    operator==(const xoshiro256ss&, const xoshiro256ss&) = default;
+  };
+
+  // xoshiro256ss_batch
+
+  /// @brief Lanes 個の独立した xoshiro256** をまとめて進める生成器
+  /// @details 各レーンの状態を要素ごとの配列に持つため、fill の内側のループ
+  /// はレーン方向にベクトル化される。レーン k は種から作った xoshiro256** を
+  /// k 回 jump した部分列であり、レーン同士は重ならない。
+  /// @tparam Lanes レーン数 (AVX2 では 4 レーンが 1 命令に収まる)
+  template <std::size_t Lanes = 4>
+  struct xoshiro256ss_batch {
+    static_assert(Lanes > 0);
+
+  private:
+    alignas(64) std::array<std::uint64_t, Lanes> s0_{};
+    alignas(64) std::array<std::uint64_t, Lanes> s1_{};
+    alignas(64) std::array<std::uint64_t, Lanes> s2_{};
+    alignas(64) std::array<std::uint64_t, Lanes> s3_{};
+
+    /// @brief 全レーンを 1 段進め、各レーンの値を out[0, Lanes) に書き込む
+    constexpr void step(std::uint64_t* out) noexcept {
+      for (std::size_t k = 0; k < Lanes; ++k) {
+        // 64 ビットの乗算を持たない SIMD 命令セットでもベクトル化されるよう、
+        // 定数倍をシフトと加算で書く
+        const std::uint64_t x = (s1_[k] << 2) + s1_[k];
+        const std::uint64_t r = rotl(x, 7);
+        out[k] = (r << 3) + r;
+        const std::uint64_t t = s1_[k] << 17;
+        s2_[k] ^= s0_[k];
+        s3_[k] ^= s1_[k];
+        s1_[k] ^= s2_[k];
+        s0_[k] ^= s3_[k];
+        s2_[k] ^= t;
+        s3_[k] = rotl(s3_[k], 45);
+      }
+    }
+
+  public:
+    constexpr explicit xoshiro256ss_batch(std::uint64_t seed = 0) noexcept {
+      xoshiro256ss g(seed);
+      for (std::size_t k = 0; k < Lanes; ++k) {
+        const auto& s = g.state();
+        s0_[k] = s[0];
+        s1_[k] = s[1];
+        s2_[k] = s[2];
+        s3_[k] = s[3];
+        g.jump();
+      }
+    }
+
+    static constexpr std::size_t lanes() noexcept {
+      return Lanes;
+    }
+
+    /// @brief out を乱数で埋める
+    /// @details out[i] はレーン i % Lanes の値である。out.size() が Lanes の
+    /// 倍数でないとき、最後の段の余った値は捨てる。
+    constexpr void fill(std::span<std::uint64_t> out) noexcept {
+      std::size_t i = 0;
+      for (; i + Lanes <= out.size(); i += Lanes)
+        step(out.data() + i);
+      if (i != out.size()) {
+        std::array<std::uint64_t, Lanes> tail{};
+        step(tail.data());
+        for (std::size_t k = 0; i < out.size(); ++i, ++k)
+          out[i] = tail[k];
+      }
+    }
+  };
+
+  // mul_wide
+
+  /// @brief 64 ビット同士の積を {上位 64 ビット, 下位 64 ビット} で返す
+  constexpr auto mul_wide(std::uint64_t a, std::uint64_t b) noexcept
+    -> std::pair<std::uint64_t, std::uint64_t> {
+#if defined(__SIZEOF_INT128__)
+    __extension__ using uint128 = unsigned __int128;
+    const uint128 m = uint128(a) * b;
+    return {static_cast<std::uint64_t>(m >> 64), static_cast<std::uint64_t>(m)};
+#else
+    const std::uint64_t a_lo = a & 0xffffffff, a_hi = a >> 32;
+    const std::uint64_t b_lo = b & 0xffffffff, b_hi = b >> 32;
+    const std::uint64_t ll = a_lo * b_lo, lh = a_lo * b_hi;
+    const std::uint64_t hl = a_hi * b_lo, hh = a_hi * b_hi;
+    const std::uint64_t mid = (ll >> 32) + (lh & 0xffffffff) + (hl & 0xffffffff);
+    return {
+      hh + (lh >> 32) + (hl >> 32) + (mid >> 32),
+      (mid << 32) | (ll & 0xffffffff)};
+#endif
+  }
+
+  // uniform_below
+
+  /// @brief [0, bound) の一様な整数を返す (bound > 0)
+  /// @details Lemire の手法 (https://arxiv.org/abs/1805.10941) により、剰余に
+  /// よる偏りがなく、除算は棄却が起こりうるまれな場合にしか行わない。
+  template <class URBG>
+  constexpr auto uniform_below(URBG& g, std::uint64_t bound) -> std::uint64_t {
+    static_assert(
+      URBG::min() == 0
+        and URBG::max() == std::numeric_limits<std::uint64_t>::max(),
+      "uniform_below requires a full 64-bit generator");
+    // m.first が結果、m.second が棄却の判定に用いる端数
+    auto m = mul_wide(g(), bound);
+    if (m.second < bound) {
+      const std::uint64_t threshold = (0 - bound) % bound;
+      while (m.second < threshold)
+        m = mul_wide(g(), bound);
+    }
+    return m.first;
+  }
+} // namespace ns::random
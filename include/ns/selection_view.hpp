@@ -0,0 +1,499 @@
+/// @file selection_view.hpp
+#pragma once
+#include <ns/enumerate_view.hpp>
+#include <ns/index_search.hpp>
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__GNUC__) and defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+namespace ns::simd {
+  // compress
+
+  //! compress が out の末尾を越えて書き込みうる要素数
+  inline constexpr std::size_t compress_slack = 8;
+
+  /// @brief compare<Op>(p[i], value) が真となる i について first_index + i を
+  /// out に詰めて書き込み、その個数を返す (分岐を用いない)
+  /// @pre out には n + compress_slack 個の領域がある
+  template <compare_op Op, vectorizable T, std::integral O>
+  std::size_t compress_scalar(
+    const T* p,
+    std::size_t n,
+    T value,
+    O first_index,
+    O* out) noexcept {
+    std::size_t count = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+      out[count] = static_cast<O>(first_index + static_cast<O>(i));
+      count += static_cast<std::size_t>(compare<Op>(p[i], value));
+    }
+    return count;
+  }
+
+#if defined(__GNUC__) and defined(__x86_64__)
+  /// @brief 比較結果のマスク m[k] が真となるレーン番号 k を小さい順に並べた表
+  /// @details compress_table<E, Lanes>[bits] の先頭 popcount(bits) 個が有効
+  /// で、残りは 0 である。要素型 E をレーンと同じ幅にし、読み込んだ行を
+  /// 変換せずに添字のベクトルとして使えるようにする (8 レーンで 8 KiB)。
+  template <class E, std::size_t Lanes>
+  inline constexpr auto compress_table = [] {
+    std::array<std::array<E, Lanes>, std::size_t(1) << Lanes> t{};
+    for (std::size_t bits = 0; bits < t.size(); ++bits) {
+      std::size_t j = 0;
+      for (std::size_t k = 0; k < Lanes; ++k)
+        if (bits >> k & 1)
+          t[bits][j++] = static_cast<E>(k);
+    }
+    return t;
+  }();
+
+  /// @brief compress_table の各行の有効な要素数 (popcount(bits))
+  /// @details SSE2 は popcnt 命令を持たないため表を引く
+  template <std::size_t Lanes>
+  inline constexpr auto compress_count = [] {
+    std::array<std::uint8_t, std::size_t(1) << Lanes> t{};
+    for (std::size_t bits = 0; bits < t.size(); ++bits)
+      t[bits] = static_cast<std::uint8_t>(std::popcount(bits));
+    return t;
+  }();
+
+  /// @brief 各レーンの最上位ビットを集めた整数を返す
+  template <class MV>
+  [[gnu::always_inline]] inline unsigned movemask_sse2(const MV& m) noexcept {
+    static_assert(sizeof(MV) == 16);
+    if constexpr (sizeof(m[0]) == 4) {
+      __m128 x;
+      std::memcpy(&x, &m, sizeof(x));
+      return static_cast<unsigned>(_mm_movemask_ps(x));
+    } else {
+      __m128d x;
+      std::memcpy(&x, &m, sizeof(x));
+      return static_cast<unsigned>(_mm_movemask_pd(x));
+    }
+  }
+  /// @details compress_avx2 の flatten により呼び出し元に展開される
+  template <class MV>
+  [[gnu::target("avx2")]] inline unsigned
+  movemask_avx2(const MV& m) noexcept {
+    static_assert(sizeof(MV) == 32);
+    if constexpr (sizeof(m[0]) == 4) {
+      __m256 x;
+      std::memcpy(&x, &m, sizeof(x));
+      return static_cast<unsigned>(_mm256_movemask_ps(x));
+    } else {
+      __m256d x;
+      std::memcpy(&x, &m, sizeof(x));
+      return static_cast<unsigned>(_mm256_movemask_pd(x));
+    }
+  }
+
+  /// @brief compress_scalar と同じ結果を書き込む
+  /// @details レーンごとの比較結果をビット列にし、compress_table で真となる
+  /// レーン番号を先頭に詰めたベクトルを作って、添字に直して丸ごと書き込む。
+  /// 書き込み位置は真となったレーンの数だけ進める。
+  template <std::size_t Bytes, compare_op Op, vectorizable T, std::integral O>
+  [[gnu::always_inline]] inline std::size_t compress_kernel(
+    const T* p,
+    std::size_t n,
+    T value,
+    O first_index,
+    O* out) noexcept {
+    using M = mask_element_t<T>;
+    using V = vector_t<T, Bytes>;
+    using MV = vector_t<M, Bytes>;
+    using OV = vector_t<O, Bytes / sizeof(T) * sizeof(O)>;
+    constexpr std::size_t lanes = Bytes / sizeof(T);
+    static_assert(lanes <= compress_slack);
+
+    const V v = V{} + value;
+    std::size_t count = 0;
+    std::size_t i = 0;
+    for (; i + lanes <= n; i += lanes) {
+      V x;
+      MV m;
+      load(x, p + i);
+      compare_lanes<Op>(x, v, m);
+      unsigned bits;
+      if constexpr (Bytes == 32)
+        bits = movemask_avx2(m);
+      else
+        bits = movemask_sse2(m);
+      MV lane;
+      load(lane, compress_table<M, lanes>[bits].data());
+      const OV idx = __builtin_convertvector(lane, OV)
+                     + static_cast<O>(first_index + static_cast<O>(i));
+      std::memcpy(out + count, &idx, sizeof(idx));
+      count += compress_count<lanes>[bits];
+    }
+    return count + compress_scalar<Op>(
+                     p + i,
+                     n - i,
+                     value,
+                     static_cast<O>(first_index + static_cast<O>(i)),
+                     out + count);
+  }
+
+  template <compare_op Op, vectorizable T, std::integral O>
+  std::size_t compress_sse2(
+    const T* p,
+    std::size_t n,
+    T value,
+    O first_index,
+    O* out) noexcept {
+    return compress_kernel<16, Op>(p, n, value, first_index, out);
+  }
+  template <compare_op Op, vectorizable T, std::integral O>
+  [[gnu::target("avx2"), gnu::flatten]] std::size_t compress_avx2(
+    const T* p,
+    std::size_t n,
+    T value,
+    O first_index,
+    O* out) noexcept {
+    return compress_kernel<32, Op>(p, n, value, first_index, out);
+  }
+#endif
+
+  /// @brief compress_scalar を l の命令で行う
+  /// @pre l <= detected_level()
+  /// @pre out には n + compress_slack 個の領域がある
+  template <compare_op Op, vectorizable T, std::integral O>
+  std::size_t compress(
+    level l,
+    const T* p,
+    std::size_t n,
+    T value,
+    O first_index,
+    O* out) noexcept {
+    switch (l) {
+#if defined(__GNUC__) and defined(__x86_64__)
+    case level::avx2:
+      return compress_avx2<Op>(p, n, value, first_index, out);
+    case level::sse2:
+      return compress_sse2<Op>(p, n, value, first_index, out);
+#endif
+    default:
+      return compress_scalar<Op>(p, n, value, first_index, out);
+    }
+  }
+} // namespace ns::simd
+
+namespace ns {
+  // indices_where
+
+  /// @brief pred を満たす要素の添字を昇順に並べた選択ベクトルを返す
+  /// @details 添字は元の範囲での位置 (r が enumerate_view ならその添字であり、
+  /// start() から数える) であり、r | views::filter(pred) の後に番号を振った
+  /// ものとは異なる。selection_view には同じ r とともに渡す。pred の
+  /// 扱いは find_index と同じで、less_than などの compare_to を要素型が
+  /// simd::vectorizable な連続した範囲に用いるとベクトル命令で選別する。
+  /// それ以外の連続した範囲でも分岐を用いずに書き込む。
+  template <class R, class Pred>
+    requires std::ranges::input_range<enumerated_base_t<R>> and
+             std::indirect_unary_predicate<
+               const Pred&,
+               std::ranges::iterator_t<enumerated_base_t<R>>>
+  auto indices_where(R&& r, Pred pred)
+    -> std::vector<enumerated_index_t<R>> {
+    using Index = enumerated_index_t<R>;
+    return index_search_impl(
+      std::forward<R>(r),
+      [&](const auto* p, std::size_t n, Index start) {
+        using T = std::remove_cvref_t<decltype(*p)>;
+        if (n != 0)
+          (void)advance_index(start, n - 1);
+        // 一定数ずつ作業領域に書き込んでから結果に追記する。作業領域は L1
+        // キャッシュに収まり、結果は選ばれた要素数だけ確保すればよい。
+        constexpr std::size_t block = 1024;
+        std::array<Index, block + simd::compress_slack> buffer;
+        std::vector<Index> out;
+        [[maybe_unused]] const auto l = simd::detected_level();
+        if constexpr (is_simd_predicate_v<Pred, T>) {
+          // 数えるだけの走査は選別より十分に速いため、先に数えて結果の再確保
+          // を省く
+          constexpr auto op = *compare_op_of<typename Pred::op_type>;
+          out.reserve(simd::count<op>(l, p, n, static_cast<T>(pred.value)));
+        }
+        for (std::size_t first = 0; first < n; first += block) {
+          const std::size_t len = std::min(block, n - first);
+          const Index first_index = advance_index(start, first);
+          std::size_t count = 0;
+          if constexpr (is_simd_predicate_v<Pred, T>) {
+            constexpr auto op = *compare_op_of<typename Pred::op_type>;
+            count = simd::compress<op>(
+              l,
+              p + first,
+              len,
+              static_cast<T>(pred.value),
+              first_index,
+              buffer.data());
+          } else {
+            for (std::size_t i = 0; i < len; ++i) {
+              buffer[count] = advance_index(first_index, i);
+              count += static_cast<std::size_t>(
+                static_cast<bool>(std::invoke(pred, p[first + i])));
+            }
+          }
+          out.insert(out.end(), buffer.begin(), buffer.begin() + count);
+        }
+        return out;
+      },
+      [&](auto& e) {
+        std::vector<Index> out;
+        for (auto&& [i, x] : e)
+          if (std::invoke(pred, x))
+            out.push_back(i);
+        return out;
+      });
+  }
+
+  // selection_view
+
+  /// @brief 選択ベクトルが指す要素を順に走査する view
+  /// @details i 番目の要素は元の範囲の selection[i] 番目である。View が
+  /// enumerate_view のときは、選択ベクトルの値をその添字 (start() から数える)
+  /// とみなすため、indices_where(ev, pred) の結果をそのまま
+  /// selection_view(ev, ...) に渡せる。
+  /// selection_view(enumerate_view(r), indices_where(r, pred)) とすると、
+  /// 元の添字と要素の組を走査できる。
+  /// @tparam View 元となる view の型
+  /// @tparam Selection 元の範囲での位置 (View が enumerate_view ならその添字)
+  /// を並べた view の型
+  template <std::ranges::random_access_range View, class Selection>
+    requires std::ranges::view<View> and std::ranges::view<Selection> and
+             std::ranges::random_access_range<Selection> and
+             std::ranges::sized_range<Selection> and
+             std::integral<std::ranges::range_value_t<Selection>>
+  struct selection_view
+    : std::ranges::view_interface<selection_view<View, Selection>> {
+  private:
+    //! 元となる view
+    View base_ = View();
+    //! 元の範囲での位置の列
+    Selection selection_ = Selection();
+
+    template <bool Const>
+    struct iterator;
+
+    //! 選択ベクトルの値が View (enumerate_view) の添字であるか
+    static constexpr bool by_index = is_enumerate_view_v<View>;
+    struct no_origin {};
+    //! 元となる view の先頭に対応する選択ベクトルの値の型
+    using origin_type = std::conditional_t<
+      by_index,
+      enumerated_index_t<View>,
+      no_origin>;
+
+    constexpr origin_type origin() const noexcept {
+      if constexpr (by_index)
+        return base_.start();
+      else
+        return {};
+    }
+
+  public:
+    selection_view()
+      requires std::default_initializable<View> and
+               std::default_initializable<Selection>
+    = default;
+    /// @pre selection の各値 s は 0 <= s < size(base) (View が enumerate_view
+    /// のときは start() <= s < start() + size(base)) を満たす
+    constexpr selection_view(View base, Selection selection)
+      : base_(std::move(base)), selection_(std::move(selection)) {}
+
+    constexpr View base() const&
+      requires std::copy_constructible<View>
+    {
+      return base_;
+    }
+    constexpr View base() && {
+      return std::move(base_);
+    }
+
+    constexpr const Selection& selection() const noexcept {
+      return selection_;
+    }
+
+    constexpr iterator<false> begin() {
+      return {
+        std::ranges::begin(base_), std::ranges::begin(selection_), origin()};
+    }
+    constexpr iterator<true> begin() const
+      requires std::ranges::random_access_range<const View> and
+               std::ranges::random_access_range<const Selection>
+    {
+      return {
+        std::ranges::begin(base_), std::ranges::begin(selection_), origin()};
+    }
+
+    constexpr iterator<false> end() {
+      return {
+        std::ranges::begin(base_),
+        std::ranges::next(
+          std::ranges::begin(selection_), std::ranges::end(selection_)),
+        origin()};
+    }
+    constexpr iterator<true> end() const
+      requires std::ranges::random_access_range<const View> and
+               std::ranges::random_access_range<const Selection>
+    {
+      return {
+        std::ranges::begin(base_),
+        std::ranges::next(
+          std::ranges::begin(selection_), std::ranges::end(selection_)),
+        origin()};
+    }
+
+    constexpr auto size() const
+      requires std::ranges::sized_range<const Selection>
+    {
+      return std::ranges::size(selection_);
+    }
+    constexpr auto size() {
+      return std::ranges::size(selection_);
+    }
+  };
+
+  template <class Range, class Selection>
+  selection_view(Range&&, Selection&&)
+    -> selection_view<std::views::all_t<Range>, std::views::all_t<Selection>>;
+
+  template <std::ranges::random_access_range View, class Selection>
+    requires std::ranges::view<View> and std::ranges::view<Selection> and
+             std::ranges::random_access_range<Selection> and
+             std::ranges::sized_range<Selection> and
+             std::integral<std::ranges::range_value_t<Selection>>
+  template <bool Const>
+  struct selection_view<View, Selection>::iterator
+    : deduce_iterator_category<std::conditional_t<Const, const View, View>> {
+  private:
+    using Base = std::conditional_t<Const, const View, View>;
+    using Sel = std::conditional_t<Const, const Selection, Selection>;
+    template <bool>
+    friend struct iterator;
+
+    //! 元となる view の先頭
+    std::ranges::iterator_t<Base> begin_ = std::ranges::iterator_t<Base>();
+    //! 選択ベクトルでの現在位置
+    std::ranges::iterator_t<Sel> pos_ = std::ranges::iterator_t<Sel>();
+    //! 元となる view の先頭に対応する選択ベクトルの値 (by_index のときのみ)
+    [[no_unique_address]] origin_type origin_ = origin_type();
+
+    //! 現在の要素を指す元となるイテレータ
+    constexpr std::ranges::iterator_t<Base> current() const {
+      using D = std::ranges::range_difference_t<Base>;
+      if constexpr (by_index)
+        return begin_ + (static_cast<D>(*pos_) - static_cast<D>(origin_));
+      else
+        return begin_ + static_cast<D>(*pos_);
+    }
+
+  public:
+    using difference_type = std::ranges::range_difference_t<Sel>;
+    using value_type = std::ranges::range_value_t<Base>;
+    using iterator_concept = std::random_access_iterator_tag;
+
+    iterator()
+      requires std::default_initializable<std::ranges::iterator_t<Base>> and
+                 std::default_initializable<std::ranges::iterator_t<Sel>>
+    = default;
+    constexpr iterator(
+      std::ranges::iterator_t<Base> begin,
+      std::ranges::iterator_t<Sel> pos,
+      origin_type origin)
+      : begin_(std::move(begin)), pos_(std::move(pos)), origin_(origin) {}
+    constexpr /* implicit */ iterator(iterator<not Const> other)
+      requires Const and
+                 std::convertible_to<
+                   std::ranges::iterator_t<View>,
+                   std::ranges::iterator_t<Base>> and
+                 std::convertible_to<
+                   std::ranges::iterator_t<Selection>,
+                   std::ranges::iterator_t<Sel>>
+      : begin_(std::move(other.begin_)),
+        pos_(std::move(other.pos_)),
+        origin_(other.origin_) {}
+
+    constexpr std::ranges::range_reference_t<Base> operator*() const {
+      return *current();
+    }
+    constexpr std::ranges::range_reference_t<Base>
+    operator[](difference_type n) const {
+      return *(*this + n);
+    }
+
+    /// @brief 現在の要素の元の範囲での位置
+    constexpr std::ranges::range_value_t<Sel> index() const {
+      return *pos_;
+    }
+
+    constexpr iterator& operator++() {
+      ++pos_;
+      return *this;
+    }
+    constexpr iterator operator++(int) {
+      auto tmp = *this;
+      ++*this;
+      return tmp;
+    }
+    constexpr iterator& operator--() {
+      --pos_;
+      return *this;
+    }
+    constexpr iterator operator--(int) {
+      auto tmp = *this;
+      --*this;
+      return tmp;
+    }
+    constexpr iterator& operator+=(difference_type n) {
+      pos_ += n;
+      return *this;
+    }
+    constexpr iterator& operator-=(difference_type n) {
+      pos_ -= n;
+      return *this;
+    }
+
+    friend constexpr bool operator==(const iterator& x, const iterator& y) {
+      return x.pos_ == y.pos_;
+    }
+    friend constexpr auto operator<=>(const iterator& x, const iterator& y) {
+      return x.pos_ <=> y.pos_;
+    }
+
+    friend constexpr iterator operator+(iterator x, difference_type n) {
+      x += n;
+      return x;
+    }
+    friend constexpr iterator operator+(difference_type n, iterator x) {
+      x += n;
+      return x;
+    }
+    friend constexpr iterator operator-(iterator x, difference_type n) {
+      x -= n;
+      return x;
+    }
+    friend constexpr difference_type
+    operator-(const iterator& x, const iterator& y) {
+      return x.pos_ - y.pos_;
+    }
+
+    friend constexpr std::ranges::range_rvalue_reference_t<Base>
+    iter_move(const iterator& x) noexcept(
+      noexcept(std::ranges::iter_move(x.current()))) {
+      return std::ranges::iter_move(x.current());
+    }
+  };
+} // namespace ns
@@ -0,0 +1,239 @@
+/// @file set_bits_view.hpp
+#pragma once
+#include <array>
+#include <bit>
+#include <bitset>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+
+namespace ns {
+  // bitset_words
+
+  /// @brief std::bitset の内容を 64 ビットの語の列に詰めて返す
+  /// @details i ビット目は語 i / 64 のビット i % 64 となる。libstdc++ では
+  /// 立っているビットのみを拡張の _Find_first, _Find_next で辿る。
+  template <std::size_t N>
+  auto bitset_words(const std::bitset<N>& bits)
+    -> std::array<std::uint64_t, (N + 63) / 64> {
+    std::array<std::uint64_t, (N + 63) / 64> words{};
+#if defined(__GLIBCXX__)
+    for (std::size_t i = bits._Find_first(); i < N; i = bits._Find_next(i))
+      words[i / 64] |= std::uint64_t(1) << (i % 64);
+#else
+    for (std::size_t i = 0; i < N; ++i)
+      words[i / 64] |= std::uint64_t(bits[i]) << (i % 64);
+#endif
+    return words;
+  }
+
+  // set_bits_view
+
+  /// @brief set_bits_view に立っているビットの数を構築時に数えさせるタグ
+  struct with_count_t {
+    explicit with_count_t() = default;
+  };
+  inline constexpr with_count_t with_count{};
+
+  /// @brief 語の列をビット列とみなし、立っているビットの位置を昇順に走査する
+  /// view
+  /// @details 語 k のビット b (最下位が 0) の位置は k * (語のビット数) + b で
+  /// ある。各語の最下位の立っているビットを std::countr_zero (tzcnt) で求め、
+  /// x & (x - 1) (blsr) で消して進む。0 の語は読み飛ばす。
+  /// enumerate_view(set_bits_view(words)) とすると (何番目か, 位置) の組を
+  /// 走査できる。
+  /// 立っているビットの数は語数に比例する時間をかけなければ分からないため、
+  /// 既定では size() をもたない (sized_range でない)。
+  /// set_bits_view(words, with_count) とすると構築時に一度だけ数えて保持し、
+  /// size() を定数時間で返す。
+  /// @tparam View 符号なし整数の語の view の型
+  /// @tparam Counted 立っているビットの数を保持するか
+  template <std::ranges::forward_range View, bool Counted = false>
+    requires std::ranges::view<View> and
+             std::unsigned_integral<std::ranges::range_value_t<View>>
+  struct set_bits_view
+    : std::ranges::view_interface<set_bits_view<View, Counted>> {
+  private:
+    struct no_count {};
+
+    //! 元となる view
+    View base_ = View();
+    //! 立っているビットの数 (Counted のときのみ保持する)
+    [[no_unique_address]] std::
+      conditional_t<Counted, std::size_t, no_count> count_ = {};
+
+    template <bool Const>
+    struct iterator;
+
+    /// @brief 各語の std::popcount の和を返す
+    static constexpr std::size_t count_bits(View& base) {
+      std::size_t count = 0;
+      for (auto&& w : base)
+        count += static_cast<std::size_t>(
+          std::popcount(static_cast<std::ranges::range_value_t<View>>(w)));
+      return count;
+    }
+
+  public:
+    using word_type = std::ranges::range_value_t<View>;
+    //! 1 語のビット数
+    static constexpr std::size_t word_bits =
+      std::numeric_limits<word_type>::digits;
+
+    set_bits_view()
+      requires std::default_initializable<View>
+    = default;
+    constexpr explicit set_bits_view(View base)
+      requires(not Counted)
+      : base_(std::move(base)) {}
+    /// @details 立っているビットの数を数えるため、語数に比例する時間が
+    /// かかる。
+    constexpr set_bits_view(View base, with_count_t)
+      requires Counted
+      : base_(std::move(base)), count_(count_bits(base_)) {}
+
+    constexpr View base() const&
+      requires std::copy_constructible<View>
+    {
+      return base_;
+    }
+    constexpr View base() && {
+      return std::move(base_);
+    }
+
+    /// @details 最初の 0 でない語まで読み進めるため、先頭の 0 の語の数に
+    /// 比例する時間がかかる。
+    constexpr iterator<false> begin() {
+      return {std::ranges::begin(base_), std::ranges::end(base_)};
+    }
+    constexpr iterator<true> begin() const
+      requires std::ranges::forward_range<const View>
+    {
+      return {std::ranges::begin(base_), std::ranges::end(base_)};
+    }
+
+    constexpr auto end() {
+      if constexpr (std::ranges::common_range<View>)
+        return iterator<false>(
+          std::ranges::end(base_), std::ranges::end(base_));
+      else
+        return std::default_sentinel;
+    }
+    constexpr auto end() const
+      requires std::ranges::forward_range<const View>
+    {
+      if constexpr (std::ranges::common_range<const View>)
+        return iterator<true>(
+          std::ranges::end(base_), std::ranges::end(base_));
+      else
+        return std::default_sentinel;
+    }
+
+    /// @brief 立っているビットの数を返す (with_count で構築したときのみ)
+    constexpr std::size_t size() const noexcept
+      requires Counted
+    {
+      return count_;
+    }
+  };
+
+  template <class Range>
+  set_bits_view(Range&&) -> set_bits_view<std::views::all_t<Range>>;
+  template <class Range>
+  set_bits_view(Range&&, with_count_t)
+    -> set_bits_view<std::views::all_t<Range>, true>;
+
+  template <std::ranges::forward_range View, bool Counted>
+    requires std::ranges::view<View> and
+             std::unsigned_integral<std::ranges::range_value_t<View>>
+  template <bool Const>
+  struct set_bits_view<View, Counted>::iterator {
+  private:
+    using Base = std::conditional_t<Const, const View, View>;
+    template <bool>
+    friend struct iterator;
+
+    //! 現在の語
+    std::ranges::iterator_t<Base> current_ = std::ranges::iterator_t<Base>();
+    //! 元となる view の末尾
+    std::ranges::sentinel_t<Base> end_ = std::ranges::sentinel_t<Base>();
+    //! 現在の語のうち、まだ走査していないビット (末尾では 0)
+    word_type word_ = 0;
+    //! 現在の語の最下位ビットの位置
+    std::size_t offset_ = 0;
+
+    /// @brief 走査していないビットが残る語まで進める
+    constexpr void skip_empty_words() {
+      while (word_ == 0) {
+        if (++current_ == end_)
+          return;
+        offset_ += word_bits;
+        word_ = *current_;
+      }
+    }
+
+  public:
+    using difference_type = std::ptrdiff_t;
+    using value_type = std::size_t;
+    using iterator_concept = std::forward_iterator_tag;
+    using iterator_category = std::input_iterator_tag;
+
+    iterator()
+      requires std::default_initializable<std::ranges::iterator_t<Base>>
+    = default;
+    constexpr iterator(
+      std::ranges::iterator_t<Base> current,
+      std::ranges::sentinel_t<Base> end)
+      : current_(std::move(current)), end_(std::move(end)) {
+      if (current_ != end_) {
+        word_ = *current_;
+        skip_empty_words();
+      }
+    }
+    constexpr /* implicit */ iterator(iterator<not Const> other)
+      requires Const and
+                 std::convertible_to<
+                   std::ranges::iterator_t<View>,
+                   std::ranges::iterator_t<Base>> and
+                 std::convertible_to<
+                   std::ranges::sentinel_t<View>,
+                   std::ranges::sentinel_t<Base>>
+      : current_(std::move(other.current_)),
+        end_(std::move(other.end_)),
+        word_(other.word_),
+        offset_(other.offset_) {}
+
+    /// @brief 現在の語を指す元となるイテレータ
+    constexpr const std::ranges::iterator_t<Base>& base() const& noexcept {
+      return current_;
+    }
+
+    constexpr std::size_t operator*() const {
+      return offset_ + static_cast<std::size_t>(std::countr_zero(word_));
+    }
+
+    constexpr iterator& operator++() {
+      word_ &= static_cast<word_type>(word_ - 1);
+      skip_empty_words();
+      return *this;
+    }
+    constexpr iterator operator++(int) {
+      auto tmp = *this;
+      ++*this;
+      return tmp;
+    }
+
+    friend constexpr bool operator==(const iterator& x, const iterator& y) {
+      return x.current_ == y.current_ and x.word_ == y.word_;
+    }
+    friend constexpr bool
+    operator==(const iterator& x, std::default_sentinel_t) {
+      return x.current_ == x.end_;
+    }
+  };
+} // namespace ns
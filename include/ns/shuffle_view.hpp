@@ -0,0 +1,276 @@
+/// @file shuffle_view.hpp
+#pragma once
+#include <ns/enumerate_view.hpp>
+#include <ns/random.hpp>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+
+namespace ns {
+  // feistel_permutation
+
+  /// @brief [0, n) 上の、鍵で決まる全単射
+  /// @details [0, 4^h) 上の Feistel ネットワークを、値が [0, n) に入るまで
+  /// 繰り返し適用する (cycle walking)。4^h < 4n となるよう h を選ぶため、適用
+  /// 回数の期待値は 4 回未満である。状態は定数個の整数のみで、添字の配列を
+  /// 持たない。
+  struct feistel_permutation {
+  private:
+    static constexpr std::size_t rounds = 4;
+
+    //! 定義域の大きさ
+    std::uint64_t n_ = 0;
+    //! Feistel ネットワークの片側のビット数
+    int half_bits_ = 1;
+    std::uint64_t half_mask_ = 1;
+    std::array<std::uint64_t, rounds> keys_{};
+
+    /// @brief ラウンド関数
+    /// @details 乗算ハッシュの上位ビットを用いる。全単射性は Feistel 構造が
+    /// 保証するため、ラウンド関数は軽いものでよい。
+    constexpr auto round(std::uint64_t r, std::uint64_t key) const noexcept
+      -> std::uint64_t {
+      const std::uint64_t x = (r ^ key) * 0x9e3779b97f4a7c15;
+      return (x ^ (x >> 32)) >> (64 - 2 * half_bits_) & half_mask_;
+    }
+
+    constexpr auto encrypt(std::uint64_t x) const noexcept -> std::uint64_t {
+      std::uint64_t l = x >> half_bits_, r = x & half_mask_;
+      for (auto key : keys_)
+        l = std::exchange(r, l ^ round(r, key));
+      return (l << half_bits_) | r;
+    }
+
+    constexpr auto decrypt(std::uint64_t x) const noexcept -> std::uint64_t {
+      std::uint64_t l = x >> half_bits_, r = x & half_mask_;
+      for (auto it = keys_.rbegin(); it != keys_.rend(); ++it)
+        r = std::exchange(l, r ^ round(l, *it));
+      return (l << half_bits_) | r;
+    }
+
+  public:
+    feistel_permutation() = default;
+    constexpr feistel_permutation(std::uint64_t n, std::uint64_t seed) noexcept
+      : n_(n) {
+      // 定義域 [0, 2^(2h)) が n を含む最小の h (h >= 1)
+      const int bits =
+        n <= 1 ? 2 : static_cast<int>(std::bit_width(n - 1));
+      half_bits_ = (bits + 1) / 2;
+      half_mask_ = (std::uint64_t(1) << half_bits_) - 1;
+      random::xoshiro256ss gen(seed);
+      for (auto& key : keys_)
+        key = gen();
+    }
+
+    constexpr std::uint64_t size() const noexcept {
+      return n_;
+    }
+
+    /// @brief i の写る先を返す
+    /// @pre i < size()
+    constexpr std::uint64_t operator()(std::uint64_t i) const noexcept {
+      assert(i < n_);
+      do
+        i = encrypt(i);
+      while (i >= n_);
+      return i;
+    }
+
+    /// @brief operator() の逆写像
+    /// @pre x < size()
+    constexpr std::uint64_t inverse(std::uint64_t x) const noexcept {
+      assert(x < n_);
+      do
+        x = decrypt(x);
+      while (x >= n_);
+      return x;
+    }
+  };
+
+  // shuffle_view
+
+  /// @brief random_access_range を擬似ランダムな順に走査する view
+  /// @details i 番目の要素は元の範囲の feistel_permutation(i) 番目である。
+  /// 置換を配列として持たないため、追加のメモリは要素数によらない。
+  /// 元の添字が必要なときは shuffle_view(enumerate_view(r), seed) とする。
+  /// @tparam View 元となる view の型
+  template <std::ranges::random_access_range View>
+    requires std::ranges::view<View> and std::ranges::sized_range<View>
+  struct shuffle_view : std::ranges::view_interface<shuffle_view<View>> {
+  private:
+    //! 元となる view
+    View base_ = View();
+    //! 走査順を決める置換
+    feistel_permutation perm_{};
+
+    template <bool Const>
+    struct iterator;
+
+  public:
+    shuffle_view()
+      requires std::default_initializable<View>
+    = default;
+    /// @param seed 走査順を決める種 (make_permutation と同様)
+    constexpr shuffle_view(View base, std::uint64_t seed)
+      : base_(std::move(base)),
+        perm_(static_cast<std::uint64_t>(std::ranges::size(base_)), seed) {}
+
+    constexpr View base() const&
+      requires std::copy_constructible<View>
+    {
+      return base_;
+    }
+    constexpr View base() && {
+      return std::move(base_);
+    }
+
+    constexpr const feistel_permutation& permutation() const noexcept {
+      return perm_;
+    }
+
+    constexpr iterator<false> begin() {
+      return {std::ranges::begin(base_), perm_, 0};
+    }
+    constexpr iterator<true> begin() const
+      requires std::ranges::random_access_range<const View> and
+               std::ranges::sized_range<const View>
+    {
+      return {std::ranges::begin(base_), perm_, 0};
+    }
+
+    constexpr iterator<false> end() {
+      return {std::ranges::begin(base_), perm_, size()};
+    }
+    constexpr iterator<true> end() const
+      requires std::ranges::random_access_range<const View> and
+               std::ranges::sized_range<const View>
+    {
+      return {std::ranges::begin(base_), perm_, size()};
+    }
+
+    constexpr std::size_t size() const noexcept {
+      return static_cast<std::size_t>(perm_.size());
+    }
+  };
+
+  template <class Range>
+  shuffle_view(Range&&, std::uint64_t)
+    -> shuffle_view<std::views::all_t<Range>>;
+
+  template <std::ranges::random_access_range View>
+    requires std::ranges::view<View> and std::ranges::sized_range<View>
+  template <bool Const>
+  struct shuffle_view<View>::iterator
+    : deduce_iterator_category<std::conditional_t<Const, const View, View>> {
+  private:
+    using Base = std::conditional_t<Const, const View, View>;
+    template <bool>
+    friend struct iterator;
+
+    //! 元となる view の先頭
+    std::ranges::iterator_t<Base> begin_ = std::ranges::iterator_t<Base>();
+    //! 走査順を決める置換 (shuffle_view が保持する)
+    const feistel_permutation* perm_ = nullptr;
+    //! 走査順での位置
+    std::size_t pos_ = 0;
+
+    //! 現在の要素を指す元となるイテレータ
+    constexpr std::ranges::iterator_t<Base> current() const {
+      return begin_ + static_cast<std::ranges::range_difference_t<Base>>(
+                        (*perm_)(pos_));
+    }
+
+  public:
+    using difference_type = std::ranges::range_difference_t<Base>;
+    using value_type = std::ranges::range_value_t<Base>;
+    using iterator_concept = std::random_access_iterator_tag;
+
+    iterator()
+      requires std::default_initializable<std::ranges::iterator_t<Base>>
+    = default;
+    constexpr iterator(
+      std::ranges::iterator_t<Base> begin,
+      const feistel_permutation& perm,
+      std::size_t pos)
+      : begin_(std::move(begin)), perm_(&perm), pos_(pos) {}
+    constexpr /* implicit */ iterator(iterator<not Const> other)
+      requires Const and std::convertible_to<
+                           std::ranges::iterator_t<View>,
+                           std::ranges::iterator_t<Base>>
+      : begin_(std::move(other.begin_)),
+        perm_(other.perm_),
+        pos_(other.pos_) {}
+
+    constexpr std::ranges::range_reference_t<Base> operator*() const {
+      return *current();
+    }
+    constexpr std::ranges::range_reference_t<Base>
+    operator[](difference_type n) const {
+      return *(*this + n);
+    }
+
+    constexpr iterator& operator++() {
+      ++pos_;
+      return *this;
+    }
+    constexpr iterator operator++(int) {
+      auto tmp = *this;
+      ++*this;
+      return tmp;
+    }
+    constexpr iterator& operator--() {
+      --pos_;
+      return *this;
+    }
+    constexpr iterator operator--(int) {
+      auto tmp = *this;
+      --*this;
+      return tmp;
+    }
+    constexpr iterator& operator+=(difference_type n) {
+      pos_ = static_cast<std::size_t>(static_cast<difference_type>(pos_) + n);
+      return *this;
+    }
+    constexpr iterator& operator-=(difference_type n) {
+      return *this += -n;
+    }
+
+    friend constexpr bool operator==(const iterator& x, const iterator& y) {
+      return x.pos_ == y.pos_;
+    }
+    friend constexpr auto operator<=>(const iterator& x, const iterator& y) {
+      return x.pos_ <=> y.pos_;
+    }
+
+    friend constexpr iterator operator+(iterator x, difference_type n) {
+      x += n;
+      return x;
+    }
+    friend constexpr iterator operator+(difference_type n, iterator x) {
+      x += n;
+      return x;
+    }
+    friend constexpr iterator operator-(iterator x, difference_type n) {
+      x -= n;
+      return x;
+    }
+    friend constexpr difference_type
+    operator-(const iterator& x, const iterator& y) {
+      return static_cast<difference_type>(x.pos_)
+             - static_cast<difference_type>(y.pos_);
+    }
+
+    friend constexpr std::ranges::range_rvalue_reference_t<Base>
+    iter_move(const iterator& x) noexcept(
+      noexcept(std::ranges::iter_move(x.current()))) {
+      return std::ranges::iter_move(x.current());
+    }
+  };
+} // namespace ns
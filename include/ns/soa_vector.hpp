@@ -0,0 +1,336 @@
+/// @file soa_vector.hpp
+#pragma once
+#include <ns/tuple_arrange.hpp>
+#include <concepts>
+#include <cstddef>
+#include <iterator>
+#include <ranges>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace ns {
+  // soa_span
+
+  /// @brief 要素型ごとの連続した配列を、行ごとの tuple の範囲として見る view
+  /// @details 逆参照すると各配列の要素への参照からなる tuple (プロキシ参照) を
+  /// 返す。列ごとのループは各配列を連続に読むため、ベクトル化されやすい。
+  /// @tparam Ts 各列の要素型 (const 修飾してもよい)
+  template <class... Ts>
+  struct soa_span : std::ranges::view_interface<soa_span<Ts...>> {
+  private:
+    //! 各列の先頭
+    std::tuple<Ts*...> data_{};
+    //! 行数
+    std::size_t size_ = 0;
+
+    struct iterator;
+
+  public:
+    soa_span() = default;
+    constexpr soa_span(std::size_t size, Ts*... data)
+      : data_(data...), size_(size) {}
+
+    constexpr iterator begin() const {
+      return {data_, 0};
+    }
+    constexpr iterator end() const {
+      return {data_, static_cast<std::ptrdiff_t>(size_)};
+    }
+    constexpr std::size_t size() const noexcept {
+      return size_;
+    }
+
+    constexpr std::tuple<Ts&...> operator[](std::size_t i) const {
+      return std::apply(
+        [i](Ts*... data) { return std::tuple<Ts&...>(data[i]...); }, data_);
+    }
+
+    /// @brief I 番目の列を返す
+    template <std::size_t I>
+    constexpr auto column() const {
+      return std::span(std::get<I>(data_), size_);
+    }
+    /// @brief 要素型が T である列を返す
+    template <class T>
+    constexpr auto column() const {
+      return column<
+        tuple_element_index_v<T, std::tuple<std::remove_cv_t<Ts>...>>>();
+    }
+  };
+
+  template <class... Ts>
+  struct soa_span<Ts...>::iterator {
+  private:
+    //! 各列の先頭
+    std::tuple<Ts*...> data_{};
+    //! 現在の行
+    std::ptrdiff_t index_ = 0;
+
+  public:
+    using difference_type = std::ptrdiff_t;
+#if defined(__cpp_lib_ranges_zip)
+    using value_type = std::tuple<std::remove_cv_t<Ts>...>;
+#else
+    // C++23 より前の std::tuple では tuple<const T&> と tuple<T> の共通参照型
+    // が定まらないため、const な列を含むときは参照の tuple を value_type とする
+    using value_type = std::conditional_t<
+      (std::is_const_v<Ts> or ...),
+      std::tuple<Ts&...>,
+      std::tuple<Ts...>>;
+#endif
+    using iterator_concept = std::random_access_iterator_tag;
+    // プロキシ参照を返すが、enumerate_view と同様に並列アルゴリズムが作業を
+    // 分割できるよう random_access_iterator_tag を公開する
+    using iterator_category = std::random_access_iterator_tag;
+
+    iterator() = default;
+    constexpr iterator(std::tuple<Ts*...> data, std::ptrdiff_t index)
+      : data_(data), index_(index) {}
+
+    constexpr std::tuple<Ts&...> operator*() const {
+      return std::apply(
+        [i = index_](Ts*... data) { return std::tuple<Ts&...>(data[i]...); },
+        data_);
+    }
+    constexpr std::tuple<Ts&...> operator[](difference_type n) const {
+      return *(*this + n);
+    }
+
+    constexpr iterator& operator++() {
+      ++index_;
+      return *this;
+    }
+    constexpr iterator operator++(int) {
+      auto tmp = *this;
+      ++*this;
+      return tmp;
+    }
+    constexpr iterator& operator--() {
+      --index_;
+      return *this;
+    }
+    constexpr iterator operator--(int) {
+      auto tmp = *this;
+      --*this;
+      return tmp;
+    }
+    constexpr iterator& operator+=(difference_type n) {
+      index_ += n;
+      return *this;
+    }
+    constexpr iterator& operator-=(difference_type n) {
+      index_ -= n;
+      return *this;
+    }
+
+    friend constexpr bool operator==(const iterator& x, const iterator& y) {
+      return x.index_ == y.index_;
+    }
+    friend constexpr auto operator<=>(const iterator& x, const iterator& y) {
+      return x.index_ <=> y.index_;
+    }
+
+    friend constexpr iterator operator+(iterator x, difference_type n) {
+      x += n;
+      return x;
+    }
+    friend constexpr iterator operator+(difference_type n, iterator x) {
+      x += n;
+      return x;
+    }
+    friend constexpr iterator operator-(iterator x, difference_type n) {
+      x -= n;
+      return x;
+    }
+    friend constexpr difference_type
+    operator-(const iterator& x, const iterator& y) {
+      return x.index_ - y.index_;
+    }
+
+    friend constexpr std::tuple<Ts&&...> iter_move(const iterator& x) {
+      return std::apply(
+        [i = x.index_](Ts*... data) {
+          return std::tuple<Ts&&...>(std::move(data[i])...);
+        },
+        x.data_);
+    }
+  };
+
+  // soa_vector
+
+  /// @brief 要素型ごとに別々の連続した配列に格納する tuple の列
+  /// @details 行は std::tuple<Ts&...> (プロキシ参照) として読み書きする。
+  /// tuple_select<Is...> や tuple_select_by_type<Us...> で射影すると、選んだ
+  /// 列の配列だけを参照する soa_span が得られる。
+  /// @tparam Ts 各列の要素型
+  template <class... Ts>
+  struct soa_vector {
+    static_assert(sizeof...(Ts) > 0);
+    static_assert(
+      (not std::is_same_v<Ts, bool> and ...),
+      "std::vector<bool> is not contiguous; use char or std::uint8_t");
+
+  private:
+    //! 各列の配列
+    std::tuple<std::vector<Ts>...> columns_{};
+
+  public:
+    using value_type = std::tuple<Ts...>;
+    using reference = std::tuple<Ts&...>;
+    using const_reference = std::tuple<const Ts&...>;
+    using size_type = std::size_t;
+
+    soa_vector() = default;
+    constexpr explicit soa_vector(size_type n)
+      : columns_(std::vector<Ts>(n)...) {}
+
+    constexpr size_type size() const noexcept {
+      return std::get<0>(columns_).size();
+    }
+    constexpr bool empty() const noexcept {
+      return size() == 0;
+    }
+    constexpr void reserve(size_type n) {
+      std::apply([n](auto&... cols) { (cols.reserve(n), ...); }, columns_);
+    }
+    constexpr void resize(size_type n) {
+      std::apply([n](auto&... cols) { (cols.resize(n), ...); }, columns_);
+    }
+    constexpr void clear() noexcept {
+      std::apply([](auto&... cols) { (cols.clear(), ...); }, columns_);
+    }
+
+    /// @details いずれかの列で例外が送出されたときは、それまでに伸ばした列を
+    /// 元の長さに戻してから再送出する (強い例外保証)。
+    template <class... Args>
+      requires(sizeof...(Args) == sizeof...(Ts))
+    constexpr reference emplace_back(Args&&... args) {
+      const size_type n = size();
+      try {
+        std::apply(
+          [&](auto&... cols) {
+            (cols.emplace_back(std::forward<Args>(args)), ...);
+          },
+          columns_);
+      } catch (...) {
+        std::apply(
+          [n](auto&... cols) {
+            ((cols.size() > n ? cols.pop_back() : void()), ...);
+          },
+          columns_);
+        throw;
+      }
+      return back();
+    }
+    constexpr void push_back(const value_type& row) {
+      std::apply([this](const Ts&... xs) { emplace_back(xs...); }, row);
+    }
+    constexpr void push_back(value_type&& row) {
+      std::apply([this](Ts&... xs) { emplace_back(std::move(xs)...); }, row);
+    }
+    constexpr void pop_back() {
+      std::apply([](auto&... cols) { (cols.pop_back(), ...); }, columns_);
+    }
+
+    constexpr reference operator[](size_type i) {
+      return std::apply(
+        [i](auto&... cols) { return reference(cols[i]...); }, columns_);
+    }
+    constexpr const_reference operator[](size_type i) const {
+      return std::apply(
+        [i](const auto&... cols) { return const_reference(cols[i]...); },
+        columns_);
+    }
+    constexpr reference back() {
+      return (*this)[size() - 1];
+    }
+    constexpr const_reference back() const {
+      return (*this)[size() - 1];
+    }
+
+    /// @brief すべての列を参照する soa_span を返す
+    constexpr soa_span<Ts...> rows() {
+      return std::apply(
+        [this](auto&... cols) {
+          return soa_span<Ts...>(size(), cols.data()...);
+        },
+        columns_);
+    }
+    constexpr soa_span<const Ts...> rows() const {
+      return std::apply(
+        [this](const auto&... cols) {
+          return soa_span<const Ts...>(size(), cols.data()...);
+        },
+        columns_);
+    }
+
+    constexpr auto begin() {
+      return rows().begin();
+    }
+    constexpr auto begin() const {
+      return rows().begin();
+    }
+    constexpr auto end() {
+      return rows().end();
+    }
+    constexpr auto end() const {
+      return rows().end();
+    }
+
+    /// @brief I 番目の列を返す
+    template <std::size_t I>
+    constexpr auto column() {
+      return std::span(std::get<I>(columns_));
+    }
+    template <std::size_t I>
+    constexpr auto column() const {
+      return std::span(std::get<I>(columns_));
+    }
+    /// @brief 要素型が T である列を返す
+    template <class T>
+    constexpr auto column() {
+      return column<tuple_element_index_v<T, value_type>>();
+    }
+    template <class T>
+    constexpr auto column() const {
+      return column<tuple_element_index_v<T, value_type>>();
+    }
+  };
+
+  // tuple_select, tuple_select_by_type
+
+  /// @brief Is... 番目の列だけを参照する soa_span を返す
+  template <std::size_t... Is, class... Ts>
+  constexpr auto tuple_select(soa_span<Ts...> s) {
+    return soa_span(s.size(), s.template column<Is>().data()...);
+  }
+  template <std::size_t... Is, class... Ts>
+  constexpr auto tuple_select(soa_vector<Ts...>& v) {
+    return tuple_select<Is...>(v.rows());
+  }
+  template <std::size_t... Is, class... Ts>
+  constexpr auto tuple_select(const soa_vector<Ts...>& v) {
+    return tuple_select<Is...>(v.rows());
+  }
+
+  /// @brief 要素型が Us... である列だけを参照する soa_span を返す
+  template <class... Us, class... Ts>
+  constexpr auto tuple_select_by_type(soa_span<Ts...> s) {
+    return soa_span(s.size(), s.template column<Us>().data()...);
+  }
+  template <class... Us, class... Ts>
+  constexpr auto tuple_select_by_type(soa_vector<Ts...>& v) {
+    return tuple_select_by_type<Us...>(v.rows());
+  }
+  template <class... Us, class... Ts>
+  constexpr auto tuple_select_by_type(const soa_vector<Ts...>& v) {
+    return tuple_select_by_type<Us...>(v.rows());
+  }
+} // namespace ns
+
+template <class... Ts>
+inline constexpr bool std::ranges::enable_borrowed_range<ns::soa_span<Ts...>> =
+  true;
@@ -0,0 +1,306 @@
+/// @file thread_pool.hpp
+#pragma once
+#include <ns/enumerate_view.hpp>
+#include <algorithm>
+#include <atomic>
+#include <concepts>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <ranges>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace ns {
+  // thread_pool
+
+  /// @brief ワーカーごとの両端キューと仕事の奪取 (work stealing) を用いる
+  /// スレッドプール
+  /// @details concurrency() 本のスレッドで仕事を実行する。そのうち 1 本は
+  /// for_each_chunk を呼んだスレッドで、完了を待つ間も仕事を実行する。
+  /// 各スレッドは自身のキューの末尾から仕事を取り出し (LIFO)、空であれば
+  /// 他のキューの先頭 (最も古く、大きい範囲) から奪う。
+  ///
+  /// 範囲は必要に応じて二分して分割する。最初は concurrency() の 4 倍程度の
+  /// 個数に分け、奪われた範囲はさらに細かく分けられるようにする。そのため
+  /// 負荷が偏ったときのみ細かく分割し、分割の手間を抑える。
+  struct thread_pool {
+  private:
+    struct job;
+
+    //! 仕事の単位 (job の [first, last) の範囲)
+    struct task {
+      job* owner;
+      std::size_t first;
+      std::size_t last;
+      //! この範囲を最大でいくつに分割するか
+      std::size_t pieces;
+    };
+
+    /// @brief 共通の範囲を処理する仕事の集まり
+    struct job {
+      //! [first, last) を処理する関数
+      void (*run)(job&, std::size_t, std::size_t);
+      //! 未処理の要素数
+      std::atomic<std::size_t> remaining;
+      //! これ以上分割しない範囲の大きさ
+      std::size_t grain;
+      //! 最初に投げられた例外
+      std::exception_ptr error{};
+      std::atomic<bool> failed{false};
+    };
+
+    template <class F>
+    struct chunk_job : job {
+      F* f;
+    };
+
+    /// @brief 1 本のスレッドが所有する両端キュー
+    struct alignas(64) queue {
+      std::mutex mutex;
+      std::deque<task> tasks;
+    };
+
+    //! キューの数 (= concurrency()、最後は外部のスレッドが共有する)
+    std::size_t size_;
+    std::unique_ptr<queue[]> queues_;
+    std::vector<std::thread> workers_;
+    //! キューに積まれている仕事の数 (実際の数以上となる)
+    std::atomic<std::ptrdiff_t> pending_{0};
+    //! 待機しているワーカーの数
+    std::atomic<std::size_t> sleeping_{0};
+    std::mutex mutex_;
+    //! 仕事が積まれたか、停止を求められたことを知らせる
+    std::condition_variable wake_;
+    //! いずれかの job が完了したことを知らせる
+    std::condition_variable done_;
+    bool stop_ = false;
+
+    /// @brief 現在のスレッドが属するプールとキューの番号
+    static std::pair<const thread_pool*, std::size_t>& current() noexcept {
+      static thread_local std::pair<const thread_pool*, std::size_t> c{
+        nullptr, 0};
+      return c;
+    }
+
+    /// @brief 現在のスレッドが用いるキューの番号
+    std::size_t self() const noexcept {
+      const auto& [pool, index] = current();
+      return pool == this ? index : size_ - 1;
+    }
+
+    void push(std::size_t self, const task& t) {
+      pending_.fetch_add(1);
+      {
+        std::lock_guard lock(queues_[self].mutex);
+        queues_[self].tasks.push_back(t);
+      }
+      if (sleeping_.load() > 0) {
+        { std::lock_guard lock(mutex_); }
+        wake_.notify_one();
+      }
+    }
+
+    std::optional<task> pop(std::size_t self) {
+      std::lock_guard lock(queues_[self].mutex);
+      auto& tasks = queues_[self].tasks;
+      if (tasks.empty())
+        return std::nullopt;
+      const task t = tasks.back();
+      tasks.pop_back();
+      pending_.fetch_sub(1);
+      return t;
+    }
+
+    std::optional<task> steal(std::size_t self) {
+      for (std::size_t k = 1; k < size_; ++k) {
+        auto& q = queues_[(self + k) % size_];
+        std::lock_guard lock(q.mutex);
+        if (q.tasks.empty())
+          continue;
+        const task t = q.tasks.front();
+        q.tasks.pop_front();
+        pending_.fetch_sub(1);
+        return t;
+      }
+      return std::nullopt;
+    }
+
+    /// @brief 範囲を分割しながら実行する
+    /// @param stolen 他のスレッドのキューから奪った仕事か
+    void execute(std::size_t self, task t, bool stolen) {
+      job& j = *t.owner;
+      if (stolen)
+        t.pieces *= 2;
+      while (t.last - t.first > j.grain and t.pieces > 1) {
+        const std::size_t mid = t.first + (t.last - t.first) / 2;
+        push(self, {&j, mid, t.last, t.pieces / 2});
+        t.last = mid;
+        t.pieces -= t.pieces / 2;
+      }
+      if (not j.failed.load(std::memory_order_relaxed)) {
+        try {
+          j.run(j, t.first, t.last);
+        } catch (...) {
+          if (not j.failed.exchange(true))
+            j.error = std::current_exception();
+        }
+      }
+      const std::size_t count = t.last - t.first;
+      if (j.remaining.fetch_sub(count) == count) {
+        // 完了を待つスレッドは mutex_ の下で remaining を確かめる
+        { std::lock_guard lock(mutex_); }
+        done_.notify_all();
+      }
+    }
+
+    /// @brief キューから仕事を 1 つ取り出して実行する
+    /// @return 実行したか
+    bool run_one(std::size_t self) {
+      if (auto t = pop(self)) {
+        execute(self, *t, false);
+        return true;
+      }
+      if (auto t = steal(self)) {
+        execute(self, *t, true);
+        return true;
+      }
+      return false;
+    }
+
+    void worker_loop(std::size_t index) {
+      current() = {this, index};
+      while (true) {
+        if (run_one(index))
+          continue;
+        std::unique_lock lock(mutex_);
+        sleeping_.fetch_add(1);
+        wake_.wait(lock, [&] { return stop_ or pending_.load() > 0; });
+        sleeping_.fetch_sub(1);
+        if (stop_)
+          return;
+      }
+    }
+
+  public:
+    /// @param threads 仕事を実行するスレッドの数 (呼び出したスレッドを含む、
+    /// 0 のときは 1 とみなす)
+    explicit thread_pool(
+      unsigned threads = std::thread::hardware_concurrency())
+      : size_(std::max(1u, threads)),
+        queues_(std::make_unique<queue[]>(size_)) {
+      workers_.reserve(size_ - 1);
+      for (std::size_t i = 0; i + 1 < size_; ++i)
+        workers_.emplace_back([this, i] { worker_loop(i); });
+    }
+    thread_pool(const thread_pool&) = delete;
+    thread_pool& operator=(const thread_pool&) = delete;
+    ~thread_pool() {
+      {
+        std::lock_guard lock(mutex_);
+        stop_ = true;
+      }
+      wake_.notify_all();
+      for (auto& w : workers_)
+        w.join();
+    }
+
+    /// @brief 仕事を実行するスレッドの数 (呼び出したスレッドを含む)
+    std::size_t concurrency() const noexcept {
+      return size_;
+    }
+
+    /// @brief [0, n) を重ならない範囲に分割し、各範囲 [first, last) について
+    /// f(first, last) をプール上で呼び、すべて完了するまで待つ
+    /// @details f は複数のスレッドから同時に呼ばれる。f が例外を投げたときは
+    /// 残りの範囲を処理せず、最初の例外を投げ直す。プールのスレッドから
+    /// 呼んでもよい (入れ子の呼び出し)。
+    /// @param grain これ以上分割しない範囲の大きさ
+    template <class F>
+      requires std::invocable<F&, std::size_t, std::size_t>
+    void for_each_chunk(std::size_t n, F f, std::size_t grain = 1) {
+      if (n == 0)
+        return;
+      chunk_job<F> j{};
+      j.run = [](job& base, std::size_t first, std::size_t last) {
+        std::invoke(*static_cast<chunk_job<F>&>(base).f, first, last);
+      };
+      j.remaining = n;
+      j.grain = std::max<std::size_t>(grain, 1);
+      j.f = &f;
+
+      const std::size_t s = self();
+      execute(s, {&j, 0, n, 4 * size_}, false);
+      while (j.remaining.load() != 0) {
+        if (run_one(s))
+          continue;
+        std::unique_lock lock(mutex_);
+        done_.wait(lock, [&] { return j.remaining.load() == 0; });
+      }
+      if (j.error)
+        std::rethrow_exception(j.error);
+    }
+  };
+
+  /// @brief parallel_for が既定で用いる、hardware_concurrency() 本の
+  /// スレッドのプール
+  inline thread_pool& default_thread_pool() {
+    static thread_pool pool;
+    return pool;
+  }
+
+  // parallel_for
+
+  //! parallel_for が既定で用いる、これ以上分割しない範囲の大きさ
+  inline constexpr std::size_t parallel_for_grain = 1 << 11;
+
+  /// @brief ev の各要素の (インデックス, 要素) について f をプール上で呼ぶ
+  /// @details 元となる範囲を for_each_chunk で分割する。要素数が 2 * grain
+  /// 未満のとき、またはプールのスレッドが 1 本のときは、呼び出したスレッドで
+  /// 順に呼ぶ。f は複数のスレッドから同時に呼ばれ、呼ぶ順は定まらない。
+  /// @param grain これ以上分割しない範囲の大きさ
+  template <class View, std::integral Index, class F>
+    requires std::ranges::random_access_range<View> and
+             std::ranges::sized_range<View> and
+             std::invocable<F&, Index, std::ranges::range_reference_t<View>>
+  void parallel_for(
+    thread_pool& pool,
+    enumerate_view<View, Index> ev,
+    F f,
+    std::size_t grain = parallel_for_grain) {
+    const Index start = ev.start();
+    View base = std::move(ev).base();
+    const auto first = std::ranges::begin(base);
+    const auto n = static_cast<std::size_t>(std::ranges::size(base));
+    auto run = [&](std::size_t i, std::size_t last) {
+      for (; i < last; ++i)
+        std::invoke(
+          f,
+          advance_index(start, i),
+          first[static_cast<std::ranges::range_difference_t<View>>(i)]);
+    };
+    if (n < 2 * grain or pool.concurrency() == 1)
+      run(0, n);
+    else
+      pool.for_each_chunk(n, run, grain);
+  }
+
+  /// @brief default_thread_pool() 上で parallel_for を呼ぶ
+  template <class View, std::integral Index, class F>
+    requires std::ranges::random_access_range<View> and
+             std::ranges::sized_range<View> and
+             std::invocable<F&, Index, std::ranges::range_reference_t<View>>
+  void parallel_for(
+    enumerate_view<View, Index> ev,
+    F f,
+    std::size_t grain = parallel_for_grain) {
+    parallel_for(default_thread_pool(), std::move(ev), std::move(f), grain);
+  }
+} // namespace ns
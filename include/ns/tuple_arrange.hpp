@@ -1,9 +1,14 @@
+#pragma once
+#include <ns/random.hpp>
 #include <array>
 #include <cassert>
 #include <concepts>
 #include <format>
 #include <functional>
+#include <iterator>
 #include <numeric>
+#include <string>
+#include <tuple>
 #include <type_traits>
 #include <utility>
 
@@ -44,6 +49,17 @@ namespace ns {
     return {std::get<Is>(std::forward<decltype(tpl)>(tpl))...};
   }
 
+  // tuple_select_ref
+
+  /// @brief tpl の Is... 番目の要素を参照する tuple を返す
+  /// @details 要素のコピーやムーブは行わない。tpl が左辺値であれば左辺値参照
+  /// を、右辺値であれば右辺値参照を保持する。
+  template <std::size_t... Is>
+  constexpr auto tuple_select_ref(valid_tuple auto&& tpl) noexcept
+    -> std::tuple<decltype(std::get<Is>(std::forward<decltype(tpl)>(tpl)))...> {
+    return {std::get<Is>(std::forward<decltype(tpl)>(tpl))...};
+  }
+
   // tuple_element_index_v
 
   // clang-format off
@@ -76,20 +92,55 @@ namespace ns {
       std::forward<decltype(tpl)>(tpl));
   }
 
-  // tuple_format
+  // tuple_select_ref_by_type
 
-  template <class Tuple, std::size_t... Is>
-  constexpr auto tuple_format(const Tuple& tpl, std::index_sequence<Is...>)
-    -> std::string {
-    std::string str{};
-    const char* dlm = "";
+  template <typename... Ts>
+  constexpr auto tuple_select_ref_by_type(valid_tuple auto&& tpl) noexcept {
+    return tuple_select_ref<
+      tuple_element_index_v<Ts, std::remove_reference_t<decltype(tpl)>>...>(
+      std::forward<decltype(tpl)>(tpl));
+  }
+
+  // tuple_format_to
+
+  /// @brief tpl を "(a, b, c)" の形式で out に書き込み、書き込んだ末尾を返す
+  /// @details 中間の std::string を作らずに std::format_to で直接書き込むため、
+  /// 任意の出力イテレータや呼び出し側が用意したバッファに出力できる。
+  template <class Out, class Tuple, std::size_t... Is>
+  constexpr auto
+  tuple_format_to(Out out, const Tuple& tpl, std::index_sequence<Is...>)
+    -> Out {
+    *out++ = '(';
+    [[maybe_unused]] const char* dlm = "";
     using swallow = std::initializer_list<int>;
     (void)swallow{
       (void(
-         str = std::format(
-           "{}{}{}", str, std::exchange(dlm, ", "), std::get<Is>(tpl))),
+         out = std::format_to(
+           std::move(out),
+           "{}{}",
+           std::exchange(dlm, ", "),
+           std::get<Is>(tpl))),
        0)...};
-    return std::format("({})", str);
+    *out++ = ')';
+    return out;
+  }
+
+  template <class Out, class Tuple>
+  constexpr auto tuple_format_to(Out out, const Tuple& tpl) -> Out {
+    return tuple_format_to(
+      std::move(out),
+      tpl,
+      std::make_index_sequence<std::tuple_size_v<Tuple>>{});
+  }
+
+  // tuple_format
+
+  template <class Tuple, std::size_t... Is>
+  constexpr auto tuple_format(const Tuple& tpl, std::index_sequence<Is...> seq)
+    -> std::string {
+    std::string str{};
+    tuple_format_to(std::back_inserter(str), tpl, seq);
+    return str;
   }
 
   template <class Tuple>
@@ -98,6 +149,21 @@ namespace ns {
       tpl, std::make_index_sequence<std::tuple_size_v<Tuple>>{});
   }
 
+  // tuple_fmt
+
+  /// @brief std::format の引数として tuple を "(a, b, c)" の形式で出力する
+  /// @details 標準ライブラリの型である std::tuple に対して std::formatter を
+  /// 特殊化することはできないため、このラッパーを介して書式化する。
+  template <class Tuple>
+  struct tuple_fmt_t {
+    const Tuple& tpl;
+  };
+
+  template <class Tuple>
+  constexpr auto tuple_fmt(const Tuple& tpl) -> tuple_fmt_t<Tuple> {
+    return {tpl};
+  }
+
   // function_result_type, function_args_type
 
   // https://github.com/llvm/llvm-project/blob/2f18b5ef030e37f3b229e767081a804b7c038a07/llvm/include/llvm/ADT/STLExtras.h#L86
@@ -140,14 +206,34 @@ namespace ns {
   struct unordered_fn_t {
     F f;
 
+    /// @brief 型 T の仮引数に対応する引数を refs から選んで返す
+    /// @details 仮引数が左辺値参照のとき、または右辺値参照で引数も右辺値の
+    /// ときは参照のまま転送する。値渡しの仮引数と、左辺値を受ける右辺値参照の
+    /// 仮引数には std::remove_cvref_t<T> の一時オブジェクトを作る。
+    template <class T, class... As>
+    static constexpr decltype(auto) select_arg(std::tuple<As...>& refs) {
+      constexpr std::size_t I = tuple_element_index_v<
+        std::remove_cvref_t<T>,
+        std::tuple<std::remove_cvref_t<As>...>>;
+      using A = std::tuple_element_t<I, std::tuple<As...>>;
+      if constexpr (
+        std::is_lvalue_reference_v<T> or
+        (std::is_rvalue_reference_v<T> and not std::is_lvalue_reference_v<A>))
+        return std::forward<A>(std::get<I>(refs));
+      else
+        return [&]() -> std::remove_cvref_t<T> {
+          return std::forward<A>(std::get<I>(refs));
+        }();
+    }
+
+    /// @details 引数は並べ替えて g に転送する。一時オブジェクトを作るのは、
+    /// 仮引数が値渡しのときと、右辺値参照の仮引数に左辺値を渡すときだけである。
     template <class G, class... Args>
     static constexpr auto call(G&& g, Args&&... args)
       -> function_result_type<std::remove_cvref_t<G>> {
       return [&]<class... Ts>(std::in_place_type_t<std::tuple<Ts...>>) {
-        auto tpl = std::make_tuple(std::forward<Args>(args)...);
-        auto reordered_tpl =
-          tuple_select_by_type<std::remove_cvref_t<Ts>...>(std::move(tpl));
-        return std::apply(std::forward<G>(g), std::move(reordered_tpl));
+        auto refs = std::forward_as_tuple(std::forward<Args>(args)...);
+        return std::invoke(std::forward<G>(g), select_arg<Ts>(refs)...);
       }(std::in_place_type<function_args_type<std::remove_cvref_t<G>>>);
     }
 
@@ -187,6 +273,8 @@ namespace ns {
 
   // make_permutation
 
+  /// @deprecated state % (max + 1) は偏りがあり、毎回除算を行う。
+  /// ns::random::uniform_below を用いる。
   constexpr auto xorshift64(std::uint64_t max, std::uint64_t state)
     -> std::pair<std::uint64_t, std::uint64_t> {
     state ^= state << 13;
@@ -203,8 +291,10 @@ namespace ns {
     } else {
       std::array<std::size_t, N> arr{};
       std::iota(arr.begin(), arr.end(), 0);
-      for (std::size_t i = N - 1, j; i > 0; --i) {
-        std::tie(j, state) = xorshift64(i, state);
+      random::xoshiro256ss gen(state);
+      for (std::size_t i = N - 1; i > 0; --i) {
+        const auto j =
+          static_cast<std::size_t>(random::uniform_below(gen, i + 1));
         std::swap(arr[i], arr[j]);
       }
       return arr;
@@ -222,3 +312,18 @@ namespace ns {
              std::tuple_size_v<std::remove_reference_t<decltype(tpl)>>>{});
   }
 } // namespace ns
+
+template <class Tuple>
+struct std::formatter<ns::tuple_fmt_t<Tuple>> {
+  constexpr auto parse(std::format_parse_context& ctx) {
+    auto it = ctx.begin();
+    if (it != ctx.end() and *it != '}')
+      throw std::format_error("tuple_fmt does not take a format spec");
+    return it;
+  }
+
+  template <class FormatContext>
+  auto format(const ns::tuple_fmt_t<Tuple>& t, FormatContext& ctx) const {
+    return ns::tuple_format_to(ctx.out(), t.tpl);
+  }
+};
@@ -0,0 +1,170 @@
+#include <catch2/catch_test_macros.hpp>
+#include <ns/argsort.hpp>
+#include <ns/random.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+
+inline constexpr std::uint64_t Seed = 0x01234567DEADC0DE;
+
+/// @brief (値, 添字) の組を std::stable_sort で整列して得た添字の列
+template <class T, class Comp = std::ranges::less>
+std::vector<std::size_t>
+reference_stable_argsort(const std::vector<T>& v, Comp comp = {}) {
+  std::vector<std::size_t> idx(v.size());
+  for (std::size_t i = 0; i < v.size(); ++i)
+    idx[i] = i;
+  std::ranges::stable_sort(
+    idx, [&](std::size_t a, std::size_t b) { return comp(v[a], v[b]); });
+  return idx;
+}
+
+template <class T>
+std::vector<T> random_values(std::size_t n, std::uint64_t bound) {
+  ns::random::xoshiro256ss gen(Seed);
+  std::vector<T> v(n);
+  for (auto& x : v)
+    x = static_cast<T>(ns::random::uniform_below(gen, bound));
+  return v;
+}
+
+TEST_CASE("radix_key", "[argsort][radix_key]") {
+  STATIC_CHECK(ns::radix_key(-1) < ns::radix_key(0));
+  STATIC_CHECK(ns::radix_key(std::numeric_limits<int>::min()) == 0);
+  STATIC_CHECK(ns::radix_key(-1.5) < ns::radix_key(-0.5));
+  STATIC_CHECK(ns::radix_key(-0.5f) < ns::radix_key(0.0f));
+  STATIC_CHECK(ns::radix_key(-0.0) == ns::radix_key(0.0));
+  STATIC_CHECK(ns::radix_key(0.0) < ns::radix_key(1e-300));
+  STATIC_CHECK(
+    ns::radix_key(std::numeric_limits<double>::max())
+    < ns::radix_key(std::numeric_limits<double>::infinity()));
+}
+
+TEST_CASE("argsort", "[argsort]") {
+  {
+    const std::vector<int> v{30, 10, 20};
+    CHECK(ns::argsort(v) == std::vector<std::size_t>{1, 2, 0});
+    CHECK(
+      ns::argsort(v, std::ranges::greater{})
+      == std::vector<std::size_t>{0, 2, 1});
+    STATIC_CHECK(std::is_same_v<
+                 decltype(ns::argsort<std::uint32_t>(v)),
+                 std::vector<std::uint32_t>>);
+  }
+  {
+    // 射影
+    const std::vector<std::pair<std::string, int>> v{
+      {"b", 2}, {"a", 3}, {"c", 1}};
+    CHECK(
+      ns::argsort(v, {}, &std::pair<std::string, int>::first)
+      == std::vector<std::size_t>{1, 0, 2});
+    CHECK(
+      ns::stable_argsort(v, {}, &std::pair<std::string, int>::second)
+      == std::vector<std::size_t>{2, 0, 1});
+  }
+  {
+    const std::vector<int> empty;
+    CHECK(ns::argsort(empty).empty());
+  }
+}
+
+TEST_CASE("argsort", "[argsort][radix]") {
+  // 基数ソートの経路 (等しいキーが多い)
+  constexpr std::size_t N = 5000;
+  {
+    auto v = random_values<int>(N, 100);
+    for (std::size_t i = 0; i < N; i += 2)
+      v[i] = -v[i];
+    const auto expected = reference_stable_argsort(v);
+    CHECK(ns::stable_argsort(v) == expected);
+    CHECK(ns::argsort(v) == expected);
+    CHECK(
+      ns::stable_argsort(v, std::ranges::greater{})
+      == reference_stable_argsort(v, std::ranges::greater{}));
+  }
+  {
+    auto v = random_values<double>(N, 1000);
+    for (std::size_t i = 0; i < N; ++i)
+      v[i] = (v[i] - 500.0) / 7.0;
+    v[0] = -0.0;
+    v[1] = 0.0;
+    CHECK(ns::stable_argsort(v) == reference_stable_argsort(v));
+  }
+  {
+    const auto v = random_values<std::uint8_t>(N, 256);
+    CHECK(
+      ns::stable_argsort<std::uint32_t>(v, std::greater<>{})
+      == [&] {
+           auto idx = reference_stable_argsort(v, std::greater<>{});
+           return std::vector<std::uint32_t>(idx.begin(), idx.end());
+         }());
+  }
+}
+
+TEST_CASE("parallel_sort", "[argsort][parallel_sort]") {
+  constexpr std::size_t N = 10007;
+  const auto v = random_values<std::uint64_t>(N, 50);
+  {
+    auto w = v;
+    ns::parallel_sort(w.begin(), w.end(), std::ranges::less{}, 3);
+    CHECK(std::ranges::is_sorted(w));
+    auto expected = v;
+    std::ranges::sort(expected);
+    CHECK(w == expected);
+  }
+  {
+    // 安定性は値の上位、元の位置を下位に詰めて確かめる
+    std::vector<std::uint64_t> w(N);
+    for (std::size_t i = 0; i < N; ++i)
+      w[i] = v[i] << 32 | i;
+    auto by_value = [](std::uint64_t a, std::uint64_t b) {
+      return (a >> 32) < (b >> 32);
+    };
+    for (unsigned threads : {1u, 2u, 5u, 8u}) {
+      auto x = w;
+      ns::parallel_stable_sort(x.begin(), x.end(), by_value, threads);
+      CHECK(std::ranges::is_sorted(x));
+    }
+  }  {
+    // 空の範囲と要素が 1 つの範囲
+    for (unsigned threads : {1u, 4u}) {
+      std::vector<int> empty;
+      ns::parallel_sort(
+        empty.begin(), empty.end(), std::ranges::less{}, threads);
+      ns::parallel_stable_sort(
+        empty.begin(), empty.end(), std::ranges::less{}, threads);
+      CHECK(empty.empty());
+      std::vector<int> one{7};
+      ns::parallel_sort(one.begin(), one.end(), std::ranges::less{}, threads);
+      ns::parallel_stable_sort(
+        one.begin(), one.end(), std::ranges::less{}, threads);
+      CHECK(one == std::vector<int>{7});
+    }
+    const std::vector<int> empty;
+    CHECK(ns::stable_argsort(empty).empty());
+    CHECK(ns::argsort(std::vector<double>{}).empty());
+  }
+}
+
+TEST_CASE("argpartition", "[argsort][argpartition]") {
+  const auto v = random_values<int>(1000, 1000);
+  const std::vector<std::size_t> ks{0, 1, 500, 999, 1000};
+  for (std::size_t k : ks) {
+    const auto idx = ns::argpartition(v, k);
+    REQUIRE(idx.size() == v.size());
+    if (k == v.size())
+      continue;
+    const int kth = v[idx[k]];
+    auto sorted = v;
+    std::ranges::sort(sorted);
+    CHECK(kth == sorted[k]);
+    for (std::size_t i = 0; i < k; ++i)
+      CHECK(v[idx[i]] <= kth);
+    for (std::size_t i = k + 1; i < v.size(); ++i)
+      CHECK(v[idx[i]] >= kth);
+  }
+}
@@ -0,0 +1,91 @@
+#include <catch2/catch_test_macros.hpp>
+#include <ns/concurrent_enumerate.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ranges>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/// @brief 0, 1, ..., n - 1 を空白区切りで並べた文字列
+std::string numbers(std::size_t n) {
+  std::string s;
+  for (std::size_t i = 0; i < n; ++i)
+    s += std::to_string(i) + ' ';
+  return s;
+}
+
+TEST_CASE("concurrent_enumerate pull", "[concurrent_enumerate]") {
+  std::istringstream is("10 11 12 13 14");
+  ns::concurrent_enumerate source(std::views::istream<int>(is), 100u);
+  decltype(source)::batch b;
+
+  REQUIRE(source.pull(b, 2));
+  CHECK(b.start == 100);
+  CHECK(b.values == std::vector<int>{10, 11});
+  std::vector<std::pair<unsigned, int>> pairs;
+  for (auto [i, x] : b.pairs())
+    pairs.emplace_back(i, x);
+  CHECK(pairs == std::vector<std::pair<unsigned, int>>{{100, 10}, {101, 11}});
+
+  CHECK(not source.pull(b, 0));
+  CHECK(b.empty());
+  REQUIRE(source.pull(b, 10));
+  CHECK(b.start == 102);
+  CHECK(b.values == std::vector<int>{12, 13, 14});
+  CHECK(not source.pull(b, 10));
+  CHECK(b.empty());
+
+  // 空の範囲
+  std::istringstream empty;
+  ns::concurrent_enumerate none(std::views::istream<int>(empty));
+  decltype(none)::batch e;
+  CHECK(not none.pull(e, 4));
+}
+
+TEST_CASE("concurrent_enumerate move-only", "[concurrent_enumerate]") {
+  std::istringstream is("a bb ccc");
+  ns::concurrent_enumerate source(std::views::istream<std::string>(is));
+  std::vector<std::pair<std::size_t, std::string>> got;
+  source.for_each(
+    [&](std::size_t i, std::string& s) { got.emplace_back(i, std::move(s)); },
+    2);
+  CHECK(
+    got
+    == std::vector<std::pair<std::size_t, std::string>>{
+      {0, "a"}, {1, "bb"}, {2, "ccc"}});
+}
+
+TEST_CASE("concurrent_enumerate threads", "[concurrent_enumerate]") {
+  constexpr std::size_t n = 20000;
+  std::istringstream is(numbers(n));
+  ns::concurrent_enumerate source(std::views::istream<std::size_t>(is));
+
+  // Catch2 のマクロはスレッド安全でないため、結果は最後に調べる
+  std::vector<std::atomic<int>> visited(n);
+  std::atomic<int> mismatches = 0;
+  std::atomic<int> non_contiguous = 0;
+  std::vector<std::thread> workers;
+  for (int t = 0; t < 4; ++t)
+    workers.emplace_back([&] {
+      decltype(source)::batch b;
+      while (source.pull(b, 37)) {
+        for (auto [i, x] : b.pairs()) {
+          visited[i].fetch_add(1);
+          if (x != i)
+            mismatches.fetch_add(1);
+        }
+        if (b.values.back() - b.values.front() + 1 != b.size())
+          non_contiguous.fetch_add(1);
+      }
+    });
+  for (auto& w : workers)
+    w.join();
+  CHECK(mismatches.load() == 0);
+  CHECK(non_contiguous.load() == 0);
+  CHECK(std::ranges::all_of(visited, [](auto& v) { return v == 1; }));
+}
@@ -0,0 +1,128 @@
+#include <catch2/catch_test_macros.hpp>
+#include <ns/enumerate_nd.hpp>
+#include <array>
+#include <cstddef>
+#include <numeric>
+#include <ranges>
+#include <set>
+#include <utility>
+#include <vector>
+
+namespace {
+  using index2 = std::array<std::size_t, 2>;
+  using index3 = std::array<std::size_t, 3>;
+
+  /// @brief 走査した添字の列
+  template <class View>
+  auto indices(View&& v) {
+    std::vector<typename std::remove_cvref_t<View>::index_type> result;
+    for (auto&& [index, x] : v)
+      result.push_back(index);
+    return result;
+  }
+
+  /// @brief 各要素がちょうど 1 回ずつ、正しい添字とともに走査されるか
+  template <std::size_t R, class Order>
+  bool covers_once(const std::array<std::size_t, R>& extents, Order order) {
+    std::size_t n = 1;
+    for (auto e : extents)
+      n *= e;
+    std::vector<std::size_t> v(n);
+    std::iota(v.begin(), v.end(), std::size_t(0));
+    std::vector<int> seen(n, 0);
+    std::size_t count = 0;
+    for (auto&& [index, x] : ns::enumerate_nd(v, extents, order)) {
+      std::size_t flat = 0;
+      for (std::size_t d = 0; d < R; ++d) {
+        if (index[d] >= extents[d])
+          return false;
+        flat = flat * extents[d] + index[d];
+      }
+      if (flat != x)
+        return false;
+      ++seen[x];
+      ++count;
+    }
+    return count == n and
+           std::ranges::all_of(seen, [](int s) { return s == 1; });
+  }
+} // namespace
+
+TEST_CASE("enumerate_nd", "[enumerate_nd]") {
+  std::vector<int> v(6);
+  std::iota(v.begin(), v.end(), 0);
+  auto e = ns::enumerate_nd(v, index2{2, 3});
+  STATIC_CHECK(std::ranges::forward_range<decltype(e)>);
+  STATIC_CHECK(std::ranges::sized_range<decltype(e)>);
+  STATIC_CHECK(std::same_as<
+               std::ranges::range_reference_t<decltype(e)>,
+               std::pair<index2, int&>>);
+  CHECK(e.size() == 6);
+  CHECK(
+    indices(e)
+    == std::vector<index2>{{0, 0}, {0, 1}, {0, 2}, {1, 0}, {1, 1}, {1, 2}});
+  // 要素は元の範囲の参照となる
+  for (auto [index, x] : e)
+    x = static_cast<int>(10 * index[0] + index[1]);
+  CHECK(v == std::vector<int>{0, 1, 2, 10, 11, 12});
+
+  // 1 次元
+  CHECK(
+    indices(ns::enumerate_nd(v, std::array<std::size_t, 1>{4}))
+    == std::vector<std::array<std::size_t, 1>>{{0}, {1}, {2}, {3}});
+  // 大きさ 0 の次元を含む
+  CHECK(ns::enumerate_nd(v, index2{0, 3}).empty());
+  CHECK(ns::enumerate_nd(v, index2{3, 0}, ns::nd_morton{1, 1}).empty());
+}
+
+TEST_CASE("enumerate_nd tiled", "[enumerate_nd]") {
+  std::vector<int> v(12);
+  CHECK(
+    indices(ns::enumerate_nd(v, index2{3, 4}, ns::nd_tiled{2, 3}))
+    == std::vector<index2>{
+      {0, 0}, {0, 1}, {0, 2}, {1, 0}, {1, 1}, {1, 2}, // タイル (0, 0)
+      {0, 3}, {1, 3},                                 // タイル (0, 1)
+      {2, 0}, {2, 1}, {2, 2},                         // タイル (1, 0)
+      {2, 3}});                                       // タイル (1, 1)
+  CHECK(covers_once(index3{5, 7, 3}, ns::nd_tiled{2, 3, 2}));
+  CHECK(covers_once(index3{4, 4, 4}, ns::nd_tiled{8, 8, 8}));
+  CHECK(covers_once(index2{9, 1}, ns::nd_tiled{4, 4}));
+}
+
+TEST_CASE("enumerate_nd morton", "[enumerate_nd]") {
+  std::vector<int> v(16);
+  // Z 順
+  CHECK(
+    indices(ns::enumerate_nd(v, index2{4, 4}, ns::nd_morton{1, 1}))
+    == std::vector<index2>{
+      {0, 0}, {0, 1}, {1, 0}, {1, 1}, {0, 2}, {0, 3}, {1, 2}, {1, 3},
+      {2, 0}, {2, 1}, {3, 0}, {3, 1}, {2, 2}, {2, 3}, {3, 2}, {3, 3}});
+  // 格子の外の符号は読み飛ばす
+  CHECK(
+    indices(ns::enumerate_nd(v, index2{3, 2}, ns::nd_morton{1, 1}))
+    == std::vector<index2>{{0, 0}, {0, 1}, {1, 0}, {1, 1}, {2, 0}, {2, 1}});
+  CHECK(covers_once(index2{13, 5}, ns::nd_morton{1, 1}));
+  CHECK(covers_once(index2{1, 100}, ns::nd_morton{1, 1}));
+  CHECK(covers_once(index3{6, 5, 9}, ns::nd_morton{2, 2, 4}));
+  // タイルの中は行優先
+  std::set<index2> first_tile;
+  auto m = ns::enumerate_nd(v, index2{4, 4}, ns::nd_morton{2, 2});
+  for (auto it = m.begin(); first_tile.size() < 4; ++it)
+    first_tile.insert((*it).first);
+  CHECK(first_tile == std::set<index2>{{0, 0}, {0, 1}, {1, 0}, {1, 1}});
+}
+
+TEST_CASE("enumerate_nd strides", "[enumerate_nd]") {
+  // 列優先で格納された 2 × 3 の格子
+  const std::vector<int> v{0, 10, 1, 11, 2, 12};
+  const ns::enumerate_nd_view e(
+    std::views::all(v), index2{2, 3}, index2{1, 2}, ns::nd_row_major{});
+  std::vector<int> values;
+  for (auto [index, x] : e) {
+    CHECK(x == static_cast<int>(10 * index[0] + index[1]));
+    values.push_back(x);
+  }
+  CHECK(values == std::vector<int>{0, 1, 2, 10, 11, 12});
+  CHECK(e.begin().offset() == 0);
+  CHECK(std::ranges::next(e.begin(), 4).offset() == 3);
+}
@@ -1,7 +1,17 @@
 #include <catch2/catch_test_macros.hpp>
 #include <ns/enumerate_view.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <execution>
 #include <forward_list>
+#include <functional>
 #include <list>
+#include <mutex>
+#include <numeric>
+#include <set>
+#include <span>
+#include <thread>
 #include <vector>
 
 // begin テスト用の view
@@ -98,11 +108,11 @@ TEST_CASE("enumerate_view", "[enumerate_view]") {
     static_assert(
       std::derived_from<
         typename std::iterator_traits<decltype(it)>::iterator_category,
-        std::input_iterator_tag>);
+        std::forward_iterator_tag>);
     static_assert(
       not std::derived_from<
         typename std::iterator_traits<decltype(it)>::iterator_category,
-        std::forward_iterator_tag>);
+        std::bidirectional_iterator_tag>);
 
     CHECK(std::get<0>(*it) == 0);
     CHECK(std::get<1>(*it++) == 'a');
@@ -123,11 +133,11 @@ TEST_CASE("enumerate_view", "[enumerate_view]") {
     static_assert(
       std::derived_from<
         typename std::iterator_traits<decltype(it)>::iterator_category,
-        std::input_iterator_tag>);
+        std::bidirectional_iterator_tag>);
     static_assert(
       not std::derived_from<
         typename std::iterator_traits<decltype(it)>::iterator_category,
-        std::forward_iterator_tag>);
+        std::random_access_iterator_tag>);
 
     CHECK(std::get<0>(*it) == 0);
     CHECK(std::get<1>(*it++) == 'a');
@@ -144,14 +154,12 @@ TEST_CASE("enumerate_view", "[enumerate_view]") {
     static_assert(std::ranges::common_range<decltype(ev)>);
 
     std::random_access_iterator auto it = std::ranges::begin(ev);
+    static_assert(std::same_as<
+                  typename std::iterator_traits<decltype(it)>::iterator_category,
+                  std::random_access_iterator_tag>);
+    // 元となるイテレータと親の view へのポインタのみを保持する
     static_assert(
-      std::derived_from<
-        typename std::iterator_traits<decltype(it)>::iterator_category,
-        std::input_iterator_tag>);
-    static_assert(
-      not std::derived_from<
-        typename std::iterator_traits<decltype(it)>::iterator_category,
-        std::forward_iterator_tag>);
+      sizeof(it) == sizeof(std::vector<char>::iterator) + sizeof(void*));
 
     CHECK(std::get<0>(*it) == 0);
     CHECK(std::get<1>(*it++) == 'a');
@@ -191,11 +199,11 @@ TEST_CASE("enumerate_view", "[enumerate_view][common]") {
     static_assert(
       std::derived_from<
         typename std::iterator_traits<decltype(it)>::iterator_category,
-        std::input_iterator_tag>);
+        std::bidirectional_iterator_tag>);
     static_assert(
       not std::derived_from<
         typename std::iterator_traits<decltype(it)>::iterator_category,
-        std::forward_iterator_tag>);
+        std::random_access_iterator_tag>);
 
     CHECK(std::get<0>(*it) == 0);
     CHECK(std::get<1>(*it++) == 'a');
@@ -212,14 +220,9 @@ TEST_CASE("enumerate_view", "[enumerate_view][common]") {
     static_assert(not std::ranges::common_range<decltype(ev)>);
 
     std::random_access_iterator auto it = std::ranges::begin(ev);
-    static_assert(
-      std::derived_from<
-        typename std::iterator_traits<decltype(it)>::iterator_category,
-        std::input_iterator_tag>);
-    static_assert(
-      not std::derived_from<
-        typename std::iterator_traits<decltype(it)>::iterator_category,
-        std::forward_iterator_tag>);
+    static_assert(std::same_as<
+                  typename std::iterator_traits<decltype(it)>::iterator_category,
+                  std::random_access_iterator_tag>);
 
     CHECK(std::get<0>(*it) == 0);
     CHECK(std::get<1>(*it++) == 'a');
@@ -266,11 +269,11 @@ TEST_CASE("enumerate_view", "[enumerate_view][const]") {
     static_assert(
       std::derived_from<
         typename std::iterator_traits<decltype(it)>::iterator_category,
-        std::input_iterator_tag>);
+        std::forward_iterator_tag>);
     static_assert(
       not std::derived_from<
         typename std::iterator_traits<decltype(it)>::iterator_category,
-        std::forward_iterator_tag>);
+        std::bidirectional_iterator_tag>);
 
     CHECK(std::get<0>(*it) == 0);
     CHECK(std::get<1>(*it++) == 'a');
@@ -291,11 +294,11 @@ TEST_CASE("enumerate_view", "[enumerate_view][const]") {
     static_assert(
       std::derived_from<
         typename std::iterator_traits<decltype(it)>::iterator_category,
-        std::input_iterator_tag>);
+        std::bidirectional_iterator_tag>);
     static_assert(
       not std::derived_from<
         typename std::iterator_traits<decltype(it)>::iterator_category,
-        std::forward_iterator_tag>);
+        std::random_access_iterator_tag>);
 
     CHECK(std::get<0>(*it) == 0);
     CHECK(std::get<1>(*it++) == 'a');
@@ -312,14 +315,9 @@ TEST_CASE("enumerate_view", "[enumerate_view][const]") {
     static_assert(std::ranges::common_range<decltype(ev)>);
 
     std::random_access_iterator auto it = std::ranges::begin(ev);
-    static_assert(
-      std::derived_from<
-        typename std::iterator_traits<decltype(it)>::iterator_category,
-        std::input_iterator_tag>);
-    static_assert(
-      not std::derived_from<
-        typename std::iterator_traits<decltype(it)>::iterator_category,
-        std::forward_iterator_tag>);
+    static_assert(std::same_as<
+                  typename std::iterator_traits<decltype(it)>::iterator_category,
+                  std::random_access_iterator_tag>);
 
     CHECK(std::get<0>(*it) == 0);
     CHECK(std::get<1>(*it++) == 'a');
@@ -359,11 +357,11 @@ TEST_CASE("enumerate_view", "[enumerate_view][const][common]") {
     static_assert(
       std::derived_from<
         typename std::iterator_traits<decltype(it)>::iterator_category,
-        std::input_iterator_tag>);
+        std::bidirectional_iterator_tag>);
     static_assert(
       not std::derived_from<
         typename std::iterator_traits<decltype(it)>::iterator_category,
-        std::forward_iterator_tag>);
+        std::random_access_iterator_tag>);
 
     CHECK(std::get<0>(*it) == 0);
     CHECK(std::get<1>(*it++) == 'a');
@@ -380,14 +378,9 @@ TEST_CASE("enumerate_view", "[enumerate_view][const][common]") {
     static_assert(not std::ranges::common_range<decltype(ev)>);
 
     std::random_access_iterator auto it = std::ranges::begin(ev);
-    static_assert(
-      std::derived_from<
-        typename std::iterator_traits<decltype(it)>::iterator_category,
-        std::input_iterator_tag>);
-    static_assert(
-      not std::derived_from<
-        typename std::iterator_traits<decltype(it)>::iterator_category,
-        std::forward_iterator_tag>);
+    static_assert(std::same_as<
+                  typename std::iterator_traits<decltype(it)>::iterator_category,
+                  std::random_access_iterator_tag>);
 
     CHECK(std::get<0>(*it) == 0);
     CHECK(std::get<1>(*it++) == 'a');
@@ -396,3 +389,290 @@ TEST_CASE("enumerate_view", "[enumerate_view][const][common]") {
     CHECK(it == std::ranges::end(ev));
   }
 }
+
+TEST_CASE("enumerate_view", "[enumerate_view][parallel]") {
+  {
+    std::vector<int> v(1000, 0);
+    ns::enumerate_view ev(v);
+    std::for_each(
+      std::execution::par_unseq, ev.begin(), ev.end(), [](auto p) {
+        p.second = static_cast<int>(p.first);
+      });
+    CHECK(std::ranges::equal(v, std::views::iota(0, 1000)));
+
+    auto sum = std::transform_reduce(
+      std::execution::par,
+      ev.begin(),
+      ev.end(),
+      std::size_t(0),
+      std::plus<>{},
+      [](auto p) { return p.first; });
+    CHECK(sum == 999 * 1000 / 2);
+  }
+#if defined(_PSTL_PAR_BACKEND_TBB)
+  if (std::thread::hardware_concurrency() > 1) {
+    // 各スレッドは最初の要素を処理するときに、別のスレッドが加わるまで待つ。
+    // 作業が分割されなければ 1 つのスレッドがタイムアウトするまで待ち続ける。
+    std::mutex mtx;
+    std::set<std::thread::id> ids;
+    const auto deadline =
+      std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    std::vector<int> v(1 << 16, 0);
+    ns::enumerate_view ev(v);
+    std::for_each(std::execution::par, ev.begin(), ev.end(), [&](auto p) {
+      p.second = static_cast<int>(p.first);
+      {
+        std::lock_guard lock(mtx);
+        if (not ids.insert(std::this_thread::get_id()).second)
+          return;
+      }
+      while (std::chrono::steady_clock::now() < deadline) {
+        {
+          std::lock_guard lock(mtx);
+          if (ids.size() > 1)
+            return;
+        }
+        std::this_thread::yield();
+      }
+    });
+    CHECK(ids.size() > 1);
+    CHECK(std::ranges::equal(v, std::views::iota(0, 1 << 16)));
+  }
+#endif
+}
+
+TEST_CASE("enumerate_view", "[enumerate_view][filter]") {
+  {
+    std::vector<int> v{1, 2, 3, 4};
+    auto f = v | std::views::filter([](int x) { return x % 2 == 0; });
+    ns::enumerate_view ev(f);
+    static_assert(std::ranges::bidirectional_range<decltype(ev)>);
+    auto it = std::ranges::begin(ev);
+    CHECK(std::get<0>(*it) == 0);
+    CHECK(std::get<1>(*it++) == 2);
+    CHECK(std::get<0>(*it) == 1);
+    CHECK(std::get<1>(*it++) == 4);
+    CHECK(it == std::ranges::end(ev));
+  }
+}
+
+TEST_CASE("enumerate_view", "[enumerate_view][start]") {
+  {
+    std::vector<char> v{'a', 'b', 'c'};
+    ns::enumerate_view ev(v, 10);
+    auto it = std::ranges::begin(ev);
+    CHECK(std::get<0>(*it) == 10);
+    CHECK(std::get<1>(*it++) == 'a');
+    CHECK(std::get<0>(*it) == 11);
+    CHECK(std::get<1>(*it++) == 'b');
+    CHECK(std::get<0>(*it) == 12);
+    CHECK(std::get<1>(*it++) == 'c');
+    CHECK(it == std::ranges::end(ev));
+    CHECK(std::ranges::size(ev) == 3);
+  }
+  {
+    std::forward_list<char> fl{'a', 'b'};
+    ns::enumerate_view ev(fl, 5);
+    auto it = std::ranges::begin(ev);
+    CHECK(std::get<0>(*it++) == 5);
+    CHECK(std::get<0>(*it++) == 6);
+    CHECK(it == std::ranges::end(ev));
+  }
+}
+
+TEST_CASE("enumerate_view", "[enumerate_view][partition]") {
+  {
+    std::vector<int> v(10);
+    std::iota(v.begin(), v.end(), 0);
+    ns::enumerate_view ev(v);
+    auto pieces = ev.partition(3);
+    REQUIRE(pieces.size() == 3);
+    CHECK(std::ranges::size(pieces[0]) == 4);
+    CHECK(std::ranges::size(pieces[1]) == 3);
+    CHECK(std::ranges::size(pieces[2]) == 3);
+    for (auto& piece : pieces) {
+      static_assert(std::ranges::random_access_range<decltype(piece)>);
+      static_assert(std::ranges::sized_range<decltype(piece)>);
+      for (auto [i, x] : piece)
+        CHECK(static_cast<int>(i) == x);
+    }
+  }
+  {
+    std::vector<int> v(10);
+    std::iota(v.begin(), v.end(), 0);
+    const ns::enumerate_view ev(v, 100);
+    auto pieces = ev.chunk(4);
+    REQUIRE(pieces.size() == 3);
+    CHECK(std::ranges::size(pieces[0]) == 4);
+    CHECK(std::ranges::size(pieces[1]) == 4);
+    CHECK(std::ranges::size(pieces[2]) == 2);
+    for (auto& piece : pieces)
+      for (auto [i, x] : piece)
+        CHECK(static_cast<int>(i) == x + 100);
+  }
+  {
+    std::vector<int> v{0, 1};
+    ns::enumerate_view ev(v);
+    auto pieces = ev.partition(4);
+    REQUIRE(pieces.size() == 4);
+    CHECK(std::ranges::size(pieces[0]) == 1);
+    CHECK(std::ranges::size(pieces[1]) == 1);
+    CHECK(std::ranges::empty(pieces[2]));
+    CHECK(std::ranges::empty(pieces[3]));
+    CHECK(ev.chunk(3).size() == 1);
+  }
+  {
+    std::vector<std::size_t> v(1000, 0);
+    ns::enumerate_view ev(v);
+    auto pieces = ev.partition(7);
+    std::for_each(
+      std::execution::par, pieces.begin(), pieces.end(), [](auto& piece) {
+        for (auto [i, x] : piece)
+          x = i;
+      });
+    CHECK(std::ranges::equal(v, std::views::iota(std::size_t(0), v.size())));
+  }
+}
+
+TEST_CASE("enumerate_view", "[enumerate_view][random_access]") {
+  {
+    std::vector<char> v{'a', 'b', 'c', 'd'};
+    ns::enumerate_view ev(v, 10);
+    auto it = std::ranges::begin(ev);
+    it += 3;
+    CHECK(std::get<0>(*it) == 13);
+    CHECK(std::get<1>(*it) == 'd');
+    --it;
+    CHECK(std::get<0>(*it) == 12);
+    CHECK(std::get<0>(it[-2]) == 10);
+    CHECK(std::get<1>(it[-2]) == 'a');
+    CHECK(std::get<0>(*(it - 1)) == 11);
+    CHECK(std::ranges::end(ev) - it == 2);
+    CHECK(std::get<0>(*std::ranges::prev(std::ranges::end(ev))) == 13);
+  }
+  {
+    std::vector<char> v{'a', 'b', 'c'};
+    ns::enumerate_view ev(v);
+    decltype(std::as_const(ev).begin()) it = ev.begin();
+    ++it;
+    CHECK(std::get<0>(*it) == 1);
+    CHECK(std::get<1>(*it) == 'b');
+    CHECK(it + 2 == std::as_const(ev).end());
+  }
+  {
+    std::vector<int> v{3, 1, 2};
+    ns::enumerate_view ev(v, 5);
+    auto it = std::ranges::max_element(
+      ev, {}, [](const auto& p) { return std::get<1>(p); });
+    CHECK(std::get<0>(*it) == 5);
+  }
+}
+
+TEST_CASE("enumerate_view", "[enumerate_view][index]") {
+  {
+    std::vector<float> v{0.5f, 1.5f};
+    ns::enumerate_view ev(v, std::uint32_t{7});
+    static_assert(std::same_as<
+                  std::ranges::range_value_t<decltype(ev)>,
+                  std::pair<std::uint32_t, float>>);
+    static_assert(sizeof(std::ranges::range_value_t<decltype(ev)>) == 8);
+    std::vector<std::ranges::range_value_t<decltype(ev)>> pairs(
+      ev.begin(), ev.end());
+    REQUIRE(pairs.size() == 2);
+    CHECK(pairs[0].first == 7);
+    CHECK(pairs[1].first == 8);
+    CHECK(pairs[1].second == 1.5f);
+  }
+  {
+    std::list<char> l{'a', 'b', 'c'};
+    ns::enumerate_view ev(l, std::ptrdiff_t{-1});
+    static_assert(std::same_as<
+                  std::ranges::range_reference_t<decltype(ev)>,
+                  std::pair<std::ptrdiff_t, char&>>);
+    auto it = std::ranges::begin(ev);
+    CHECK(std::get<0>(*it++) == -1);
+    CHECK(std::get<0>(*it++) == 0);
+    CHECK(std::get<0>(*it--) == 1);
+    CHECK(std::get<0>(*it) == 0);
+    CHECK(std::get<0>(*std::ranges::prev(std::ranges::end(ev))) == 1);
+  }
+  {
+    std::vector<int> v(10);
+    ns::enumerate_view<std::views::all_t<std::vector<int>&>, std::uint16_t> ev(
+      v, 1000);
+    auto pieces = ev.partition(2);
+    static_assert(std::same_as<
+                  std::ranges::range_value_t<decltype(pieces[1])>,
+                  std::pair<std::uint16_t, int>>);
+    CHECK(std::get<0>(*pieces[1].begin()) == 1005);
+  }
+}
+
+TEST_CASE("enumerate_view", "[enumerate_view][batch]") {
+  {
+    std::vector<int> v(10);
+    std::iota(v.begin(), v.end(), 0);
+    const ns::enumerate_view ev(v, std::size_t(100));
+    std::vector<std::size_t> starts;
+    std::vector<std::size_t> sizes;
+    for (auto [i, s] : ev.batches(4)) {
+      static_assert(std::same_as<decltype(s), std::span<int>>);
+      starts.push_back(i);
+      sizes.push_back(s.size());
+      for (std::size_t k = 0; k < s.size(); ++k)
+        CHECK(s[k] + 100 == static_cast<int>(i + k));
+    }
+    CHECK(starts == std::vector<std::size_t>{100, 104, 108});
+    CHECK(sizes == std::vector<std::size_t>{4, 4, 2});
+    std::vector<int> empty;
+    CHECK(std::ranges::empty(ns::enumerate_view(empty).batches(4)));
+  }
+  {
+    // 連続した範囲はブロックを直接書き換える
+    std::vector<int> v(11, 1);
+    std::vector<std::size_t> batch_starts;
+    std::vector<std::size_t> tail;
+    ns::for_each_batch<4>(
+      ns::enumerate_view(v, std::size_t(1)),
+      [&](std::size_t i, std::span<int, 4> s) {
+        batch_starts.push_back(i);
+        for (std::size_t k = 0; k < 4; ++k)
+          s[k] *= static_cast<int>(i + k);
+      },
+      [&](std::size_t i, int& x) {
+        tail.push_back(i);
+        x *= -static_cast<int>(i);
+      });
+    CHECK(batch_starts == std::vector<std::size_t>{1, 5});
+    CHECK(tail == std::vector<std::size_t>{9, 10, 11});
+    CHECK(v == std::vector<int>{1, 2, 3, 4, 5, 6, 7, 8, -9, -10, -11});
+  }
+  {
+    // 連続していない範囲は作業領域を介して書き戻す
+    std::list<int> l(6, 1);
+    ns::for_each_batch<2>(
+      ns::enumerate_view(l),
+      [](std::size_t i, std::span<int, 2> s) {
+        s[0] = static_cast<int>(i);
+        s[1] = static_cast<int>(i + 1);
+      },
+      [](std::size_t, int&) { FAIL(); });
+    CHECK(std::ranges::equal(l, std::vector<int>{0, 1, 2, 3, 4, 5}));
+
+    // 書き込めない範囲には const な span を渡す
+    const std::forward_list<int> fl{1, 2, 3, 4, 5};
+    int sum = 0;
+    std::size_t tail_index = 0;
+    ns::for_each_batch<3>(
+      ns::enumerate_view(fl),
+      [&](std::size_t, std::span<const int, 3> s) {
+        sum += s[0] + s[1] + s[2];
+      },
+      [&](std::size_t i, const int& x) {
+        sum += x;
+        tail_index = i;
+      });
+    CHECK(sum == 15);
+    CHECK(tail_index == 4);
+  }
+}
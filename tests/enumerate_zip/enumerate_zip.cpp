@@ -0,0 +1,101 @@
+#include <catch2/catch_test_macros.hpp>
+#include <ns/enumerate_zip.hpp>
+#include <ns/tuple_arrange.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <iterator>
+#include <ranges>
+#include <string>
+#include <tuple>
+#include <vector>
+
+TEST_CASE("enumerate_zip", "[enumerate_zip]") {
+  std::vector<int> ids{3, 1, 4, 1};
+  const std::vector<double> weights{0.5, 1.5, 2.5};
+  std::deque<std::string> names{"a", "b", "c", "d", "e"};
+  auto z = ns::enumerate_zip(ids, weights, names);
+  using Z = decltype(z);
+  STATIC_CHECK(std::ranges::random_access_range<Z>);
+  STATIC_CHECK(std::ranges::sized_range<Z>);
+  STATIC_CHECK(std::ranges::common_range<Z>);
+  STATIC_CHECK(std::ranges::random_access_range<const Z>);
+  STATIC_CHECK(std::same_as<
+               std::ranges::range_reference_t<Z>,
+               std::tuple<std::size_t, int&, const double&, std::string&>>);
+  STATIC_CHECK(std::same_as<
+               std::ranges::range_value_t<Z>,
+               std::tuple<std::size_t, int, double, std::string>>);
+  // 最も短い列の要素数
+  CHECK(z.size() == 3);
+  CHECK(std::ranges::distance(z) == 3);
+
+  std::vector<std::tuple<std::size_t, int, double, std::string>> rows;
+  for (auto [i, id, w, name] : z) {
+    rows.emplace_back(i, id, w, name);
+    // 要素は各列の参照となる
+    id *= 10;
+    name += "!";
+  }
+  CHECK(
+    rows
+    == std::vector<std::tuple<std::size_t, int, double, std::string>>{
+      {0, 3, 0.5, "a"}, {1, 1, 1.5, "b"}, {2, 4, 2.5, "c"}});
+  CHECK(ids == std::vector<int>{30, 10, 40, 1});
+  CHECK(names[2] == "c!");
+
+  // ランダムアクセス
+  auto it = z.begin() + 2;
+  CHECK(it.index() == 2);
+  CHECK(std::get<1>(*it) == 40);
+  CHECK(std::get<1>(it[-1]) == 10);
+  CHECK(z.end() - z.begin() == 3);
+  CHECK(std::ranges::next(z.begin(), 3) == z.end());
+  CHECK((*--z.end()) == *it);
+
+  // インデックスの型
+  auto z32 = ns::enumerate_zip<std::uint32_t>(ids);
+  STATIC_CHECK(std::same_as<
+               std::ranges::range_reference_t<decltype(z32)>,
+               std::tuple<std::uint32_t, int&>>);
+  CHECK(std::get<0>(z32[3]) == 3u);
+}
+
+TEST_CASE("enumerate_zip tuple_arrange", "[enumerate_zip]") {
+  std::vector<int> ids{7, 8, 9};
+  std::vector<double> weights{0.5, 1.5, 2.5};
+  for (auto&& row : ns::enumerate_zip(ids, weights)) {
+    // 平坦な tuple をそのまま射影できる
+    auto [w, i] = ns::tuple_select<2, 0>(row);
+    CHECK(w == weights[i]);
+    auto [id] = ns::tuple_select_by_type<int&>(row);
+    CHECK(id == ids[i]);
+    auto [ref] = ns::tuple_select_ref_by_type<double&>(row);
+    ref *= 2;
+  }
+  CHECK(weights == std::vector<double>{1.0, 3.0, 5.0});
+}
+
+TEST_CASE("enumerate_zip algorithms", "[enumerate_zip]") {
+  std::vector<int> keys{5, 2, 8, 2};
+  std::vector<std::string> values{"e", "b", "h", "c"};
+  auto z = ns::enumerate_zip(keys, values);
+  // 条件を満たす最初の行
+  auto it = std::ranges::find_if(z, [](const auto& row) {
+    return std::get<1>(row) == 2;
+  });
+  REQUIRE(it != z.end());
+  CHECK(it.index() == 1);
+  CHECK(std::get<2>(*it) == "b");
+  // iter_move は各列の要素を右辺値参照として返す
+  STATIC_CHECK(std::same_as<
+               std::iter_rvalue_reference_t<decltype(it)>,
+               std::tuple<std::size_t, int&&, std::string&&>>);
+  std::string moved = std::get<2>(std::ranges::iter_move(it));
+  CHECK(moved == "b");
+  CHECK(values[1].empty());
+  // 空の列
+  std::vector<int> empty;
+  CHECK(ns::enumerate_zip(keys, empty).empty());
+}
@@ -0,0 +1,146 @@
+#include <catch2/catch_test_macros.hpp>
+#include <ns/enumerate_view.hpp>
+#include <ns/gather_view.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <iterator>
+#include <numeric>
+#include <ranges>
+#include <utility>
+#include <vector>
+
+namespace {
+  template <std::ranges::input_range R>
+  auto to_vector(R&& r) {
+    std::vector<std::ranges::range_value_t<R>> result;
+    for (auto&& x : r)
+      result.push_back(x);
+    return result;
+  }
+
+  /// @brief data[idx[i]] を順に並べた列
+  template <class T, class I>
+  std::vector<T> naive_gather(const std::vector<T>& data, std::vector<I> idx) {
+    std::vector<T> out;
+    for (auto i : idx)
+      out.push_back(data[static_cast<std::size_t>(i)]);
+    return out;
+  }
+
+  /// @brief 0 以上 n 未満の添字を count 個、無作為な順に並べる
+  template <class I>
+  std::vector<I> scattered_indices(std::size_t n, std::size_t count) {
+    std::vector<I> idx(count);
+    std::uint64_t x = 1;
+    for (auto& i : idx) {
+      x = x * 6364136223846793005 + 1442695040888963407;
+      i = static_cast<I>((x >> 33) % n);
+    }
+    return idx;
+  }
+
+  /// @brief 利用できる各水準の simd::gather が素朴な実装と一致するか
+  template <class T, class I>
+  bool gather_matches() {
+    std::vector<T> data(1000);
+    std::iota(data.begin(), data.end(), T(0));
+    for (std::size_t count : {0u, 1u, 3u, 4u, 7u, 8u, 9u, 16u, 17u, 100u}) {
+      const auto idx = scattered_indices<I>(data.size(), count);
+      const auto expected = naive_gather(data, idx);
+      for (auto l :
+           {ns::simd::level::scalar,
+            ns::simd::level::sse2,
+            ns::simd::level::avx2}) {
+        if (l > ns::simd::detected_level())
+          continue;
+        std::vector<T> out(count);
+        ns::simd::gather(l, data.data(), idx.data(), count, out.data());
+        if (out != expected)
+          return false;
+      }
+    }
+    return true;
+  }
+} // namespace
+
+TEST_CASE("gather_view", "[gather_view]") {
+  std::vector<int> v{10, 11, 12, 13, 14, 15};
+  const std::vector<std::size_t> idx{5, 0, 3, 3, 1};
+  auto g = ns::gather_view(v, idx);
+  using G = decltype(g);
+  STATIC_CHECK(std::ranges::random_access_range<G>);
+  STATIC_CHECK(std::ranges::random_access_range<const G>);
+  STATIC_CHECK(std::ranges::sized_range<G>);
+  STATIC_CHECK(std::ranges::common_range<G>);
+  STATIC_CHECK(std::same_as<std::ranges::range_reference_t<G>, int&>);
+  CHECK(g.size() == 5);
+  CHECK(g.distance() == ns::simd::gather_distance);
+  CHECK(to_vector(g) == std::vector<int>{15, 10, 13, 13, 11});
+  CHECK(g[2] == 13);
+  CHECK(*(g.end() - 1) == 11);
+  CHECK((g.begin() + 2).index() == 3);
+  CHECK(std::ranges::distance(g) == 5);
+  // 要素は元の範囲の参照となる
+  for (int& x : g)
+    x += 100;
+  CHECK(v == std::vector<int>{110, 111, 12, 213, 14, 115});
+
+  // 先読みしない場合、添字の列が先読みより短い場合
+  CHECK(to_vector(ns::gather_view(v, idx, 0)) == to_vector(g));
+  CHECK(to_vector(ns::gather_view(v, idx, 100)) == to_vector(g));
+  // 空の添字の列
+  CHECK(ns::gather_view(v, std::vector<int>{}).empty());
+}
+
+TEST_CASE("gather_view enumerate", "[gather_view]") {
+  const std::vector<int> v{10, 11, 12, 13};
+  const std::vector<std::uint32_t> order{2, 0, 3};
+  {
+    // 走査した順の番号
+    std::vector<std::pair<std::size_t, int>> pairs;
+    for (auto [i, x] : ns::enumerate_view(ns::gather_view(v, order)))
+      pairs.emplace_back(i, x);
+    CHECK(
+      pairs
+      == std::vector<std::pair<std::size_t, int>>{{0, 12}, {1, 10}, {2, 13}});
+  }
+  {
+    // 元の範囲での位置
+    std::vector<int> w(v);
+    std::vector<std::pair<std::size_t, int>> pairs;
+    for (auto [i, x] : ns::gather_view(ns::enumerate_view(w), order))
+      pairs.emplace_back(i, x);
+    CHECK(
+      pairs
+      == std::vector<std::pair<std::size_t, int>>{{2, 12}, {0, 10}, {3, 13}});
+  }
+}
+
+TEST_CASE("gather_view gather_into", "[gather_view]") {
+  CHECK(gather_matches<float, std::int32_t>());
+  CHECK(gather_matches<float, std::uint64_t>());
+  CHECK(gather_matches<double, std::uint32_t>());
+  CHECK(gather_matches<double, std::int64_t>());
+  CHECK(gather_matches<std::int32_t, std::size_t>());
+  CHECK(gather_matches<std::int64_t, std::int32_t>());
+
+  std::vector<double> data(300);
+  std::iota(data.begin(), data.end(), 0.5);
+  const auto idx = scattered_indices<std::uint32_t>(data.size(), 77);
+  const auto expected = naive_gather(data, idx);
+  {
+    // 連続した範囲 (ベクトル命令)
+    const auto g = ns::gather_view(data, idx);
+    std::vector<double> out(idx.size());
+    CHECK(g.gather_into(out.begin()) == out.end());
+    CHECK(out == expected);
+  }
+  {
+    // 連続していない範囲、出力イテレータ
+    const std::deque<double> d(data.begin(), data.end());
+    std::vector<double> out;
+    ns::gather_view(d, idx, 4).gather_into(std::back_inserter(out));
+    CHECK(out == expected);
+  }
+}
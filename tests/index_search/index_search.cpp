@@ -0,0 +1,181 @@
+#include <catch2/catch_test_macros.hpp>
+#include <ns/enumerate_view.hpp>
+#include <ns/index_search.hpp>
+#include <ns/random.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <list>
+#include <optional>
+#include <span>
+#include <vector>
+
+inline constexpr std::uint64_t Seed = 0x01234567DEADC0DE;
+
+/// @brief 実行中の CPU で使えるすべての水準
+std::vector<ns::simd::level> available_levels() {
+  std::vector<ns::simd::level> levels{ns::simd::level::scalar};
+  for (auto l : {ns::simd::level::sse2, ns::simd::level::avx2})
+    if (l <= ns::simd::detected_level())
+      levels.push_back(l);
+  return levels;
+}
+
+/// @brief 等しい値が多い [-bound, bound) の乱数列
+template <class T>
+std::vector<T> random_values(std::size_t n, std::uint64_t bound) {
+  ns::random::xoshiro256ss gen(Seed + n);
+  std::vector<T> v(n);
+  for (auto& x : v)
+    x = static_cast<T>(ns::random::uniform_below(gen, 2 * bound))
+        - static_cast<T>(bound);
+  return v;
+}
+
+/// @brief 各水準のカーネルの結果を std::ranges の結果と比べる
+template <class T>
+void check_kernels(const std::vector<T>& v) {
+  const T* p = v.data();
+  const std::size_t n = v.size();
+  const auto pos = [&](auto it) {
+    return static_cast<std::size_t>(it - v.begin());
+  };
+  const T value = n == 0 ? T(0) : v[n / 2];
+  using ns::simd::compare_op;
+  for (auto l : available_levels()) {
+    CHECK(
+      ns::simd::arg_extremum<false>(l, p, n)
+      == pos(std::ranges::min_element(v)));
+    CHECK(
+      ns::simd::arg_extremum<true>(l, p, n)
+      == pos(std::ranges::max_element(v)));
+    CHECK(
+      ns::simd::find<compare_op::eq>(l, p, n, value)
+      == pos(std::ranges::find(v, value)));
+    CHECK(
+      ns::simd::find<compare_op::gt>(l, p, n, value)
+      == pos(std::ranges::find_if(v, [&](T x) { return x > value; })));
+    CHECK(
+      ns::simd::count<compare_op::lt>(l, p, n, value)
+      == static_cast<std::size_t>(
+        std::ranges::count_if(v, [&](T x) { return x < value; })));
+    CHECK(
+      ns::simd::count<compare_op::ne>(l, p, n, value)
+      == static_cast<std::size_t>(
+        std::ranges::count_if(v, [&](T x) { return x != value; })));
+  }
+}
+
+TEST_CASE("simd kernels", "[index_search][simd]") {
+  // x86-64 では SSE2 が常に使える
+  if constexpr (ns::simd::x86_64)
+    CHECK(ns::simd::detected_level() != ns::simd::level::scalar);
+  // ベクトルの幅とアンロールの境界をまたぐ要素数
+  const std::vector<std::size_t> sizes{0, 1, 3, 7, 8, 15, 16, 17, 31, 32, 33,
+                                       63, 64, 65, 100, 1000, 4099};
+  for (std::size_t n : sizes) {
+    check_kernels(random_values<float>(n, 10));
+    check_kernels(random_values<double>(n, 10));
+    check_kernels(random_values<std::int32_t>(n, 10));
+    check_kernels(random_values<std::int64_t>(n, 10));
+    check_kernels(random_values<std::int32_t>(n, 1 << 30));
+  }
+}
+
+TEST_CASE("simd kernels special values", "[index_search][simd]") {
+  constexpr auto inf = std::numeric_limits<float>::infinity();
+  constexpr auto nan = std::numeric_limits<float>::quiet_NaN();
+  constexpr auto imax = std::numeric_limits<std::int32_t>::max();
+  constexpr auto imin = std::numeric_limits<std::int32_t>::min();
+  auto with = [](std::size_t n, auto fill, std::size_t i, auto x) {
+    std::vector<decltype(fill)> v(n, fill);
+    v[i] = x;
+    return v;
+  };
+  for (std::size_t n : std::vector<std::size_t>{1, 40, 100}) {
+    // 先頭が NaN のときは std::min_element と同じく先頭を選ぶ
+    check_kernels(with(n, 1.0f, 0, nan));
+    check_kernels(with(n, nan, n - 1, 1.0f));
+    check_kernels(with(n, 1.0f, n / 2, nan));
+    check_kernels(with(n, inf, n - 1, -inf));
+    check_kernels(with(n, -inf, n - 1, inf));
+    check_kernels(with(n, inf, 0, inf));
+    check_kernels(with(n, 0.0f, n - 1, -0.0f));
+    check_kernels(with(n, imax, n - 1, imin));
+    check_kernels(with(n, imin, n - 1, imax));
+  }
+}
+
+TEST_CASE("argmin", "[index_search][argmin]") {
+  const std::vector<int> v{3, 1, 4, 1, 5, 9, 2, 6};
+  CHECK(ns::argmin(v) == 1u);
+  CHECK(ns::argmax(v) == 5u);
+  CHECK(ns::argmin(std::vector<double>{}) == std::nullopt);
+  CHECK(ns::argmax(std::span<const int>(v).subspan(0, 0)) == std::nullopt);
+
+  // enumerate_view の添字を返す
+  CHECK(ns::argmin(ns::enumerate_view(v, 100u)) == 101u);
+  CHECK(
+    ns::argmax(ns::enumerate_view(std::span(v).subspan(6), 6u)) == 7u);
+  STATIC_CHECK(std::is_same_v<
+               decltype(ns::argmin(ns::enumerate_view(v, 0u))),
+               std::optional<unsigned>>);
+  // コピーできない owning_view を元とする enumerate_view
+  CHECK(
+    ns::argmin(ns::enumerate_view(std::vector<float>{3.f, 1.f, 2.f})) == 1u);
+  CHECK(ns::find_index(
+          ns::enumerate_view(std::vector<int>{3, 1, 4}, 10u),
+          ns::equal_to(4)) == 12u);
+
+  // 連続していない範囲
+  const std::list<double> l{2.0, -1.0, 7.0, -1.0};
+  CHECK(ns::argmin(l) == 1u);
+  CHECK(ns::argmax(ns::enumerate_view(l, 10u)) == 12u);
+  CHECK(ns::argmin(std::list<int>{}) == std::nullopt);
+
+  const auto w = random_values<float>(5000, 1000);
+  CHECK(
+    ns::argmin(w)
+    == static_cast<std::size_t>(std::ranges::min_element(w) - w.begin()));
+  CHECK(
+    ns::argmax(w)
+    == static_cast<std::size_t>(std::ranges::max_element(w) - w.begin()));
+}
+
+TEST_CASE("find_index", "[index_search][find_index]") {
+  const std::vector<float> v{0.5f, 2.0f, -1.0f, 2.0f, 8.0f};
+  CHECK(ns::find_index(v, ns::equal_to(2.0f)) == 1u);
+  CHECK(ns::find_index(v, ns::less_than(0)) == 2u);
+  CHECK(ns::find_index(v, ns::greater_equal(8.0)) == 4u);
+  CHECK(ns::find_index(v, ns::greater_than(8.0f)) == std::nullopt);
+  CHECK(ns::find_index(v, [](float x) { return x > 1.0f; }) == 1u);
+  CHECK(ns::find_index(ns::enumerate_view(v, 10u), ns::equal_to(8.0f)) == 14u);
+
+  const std::list<int> l{4, 5, 6};
+  CHECK(ns::find_index(l, ns::not_equal_to(4)) == 1u);
+  CHECK(ns::find_index(ns::enumerate_view(l, 3u), ns::less_equal(4)) == 3u);
+
+  // 比較を T 同士に揃えられない値 (int 列と 0.5) はスカラーで判定する
+  const std::vector<std::int32_t> w{0, 0, 1};
+  CHECK(ns::find_index(w, ns::greater_than(0.5)) == 2u);
+  STATIC_CHECK(
+    ns::is_simd_predicate_v<decltype(ns::less_than(0)), std::int32_t>);
+  STATIC_CHECK(
+    ns::is_simd_predicate_v<decltype(ns::less_than(0)), double>);
+  STATIC_CHECK(
+    not ns::is_simd_predicate_v<decltype(ns::less_than(0.5)), std::int32_t>);
+  STATIC_CHECK(
+    not ns::is_simd_predicate_v<decltype(ns::less_than(0u)), std::int32_t>);
+}
+
+TEST_CASE("count_if", "[index_search][count_if]") {
+  const auto v = random_values<std::int64_t>(3000, 50);
+  const auto expected = static_cast<std::size_t>(
+    std::ranges::count_if(v, [](std::int64_t x) { return x >= 7; }));
+  CHECK(ns::count_if(v, ns::greater_equal(7)) == expected);
+  CHECK(ns::count_if(v, [](std::int64_t x) { return x >= 7; }) == expected);
+  CHECK(ns::count_if(ns::enumerate_view(v), ns::greater_equal(7)) == expected);
+  CHECK(ns::count_if(std::list<int>{1, 2, 3}, ns::less_than(3)) == 2u);
+  CHECK(ns::count_if(std::vector<double>{}, ns::less_than(3.0)) == 0u);
+}
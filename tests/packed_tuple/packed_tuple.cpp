@@ -0,0 +1,122 @@
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <ns/packed_tuple.hpp>
+#include <compare>
+#include <cstdint>
+#include <string>
+#include <tuple>
+#include <type_traits>
+
+// 宣言順のままではパディングが入る組み合わせ
+static_assert(sizeof(ns::packed_tuple<char, double, int>) == 16);
+static_assert(sizeof(ns::packed_tuple<char, double, char, int, char>) == 16);
+static_assert(
+  sizeof(ns::packed_tuple<char, double, char, int, char>)
+  <= sizeof(std::tuple<char, double, char, int, char>));
+static_assert(
+  sizeof(ns::packed_tuple<std::uint16_t, double, char, std::uint16_t, char>)
+  == 16);
+static_assert(sizeof(ns::packed_tuple<int>) == sizeof(int));
+static_assert(sizeof(ns::packed_tuple<>) == 1);
+
+static_assert(
+  ns::packed_tuple<char, double, int>::order
+  == std::array<std::size_t, 3>{1, 2, 0});
+static_assert(
+  ns::packed_tuple<char, double, int>::position
+  == std::array<std::size_t, 3>{2, 0, 1});
+static_assert(std::tuple_size_v<ns::packed_tuple<char, double, int>> == 3);
+static_assert(std::is_same_v<
+              std::tuple_element_t<0, ns::packed_tuple<char, double, int>>,
+              char>);
+
+TEST_CASE("packed_tuple", "[packed_tuple]") {
+  ns::packed_tuple<char, double, int, std::string> t{'a', 3.14, 42, "Hello"};
+  {
+    CHECK(get<0>(t) == 'a');
+    CHECK(get<1>(t) == Catch::Approx(3.14));
+    CHECK(get<2>(t) == 42);
+    CHECK(get<3>(t) == "Hello");
+    STATIC_CHECK(std::is_same_v<decltype(get<0>(t)), char&>);
+    STATIC_CHECK(
+      std::is_same_v<decltype(get<0>(std::as_const(t))), const char&>);
+    STATIC_CHECK(std::is_same_v<decltype(get<0>(std::move(t))), char&&>);
+  }
+  {
+    get<int>(t) = 7;
+    CHECK(get<2>(t) == 7);
+    CHECK(get<double>(t) == Catch::Approx(3.14));
+  }
+  {
+    auto& [c, d, i, s] = t;
+    CHECK(c == 'a');
+    CHECK(d == Catch::Approx(3.14));
+    CHECK(i == 7);
+    CHECK(s == "Hello");
+    s = "World";
+    CHECK(get<std::string>(t) == "World");
+  }
+  {
+    auto tpl = t.tie();
+    STATIC_CHECK(std::is_same_v<
+                 decltype(tpl),
+                 std::tuple<char&, double&, int&, std::string&>>);
+    CHECK(&std::get<3>(tpl) == &get<3>(t));
+  }
+  {
+    auto s = get<3>(std::move(t));
+    CHECK(s == "World");
+  }
+}
+
+TEST_CASE("packed_tuple", "[packed_tuple][construct]") {
+  {
+    ns::packed_tuple t(std::tuple<char, double, int>{'b', 2.5, 3});
+    CHECK(get<0>(t) == 'b');
+    CHECK(get<1>(t) == Catch::Approx(2.5));
+    CHECK(get<2>(t) == 3);
+  }
+  {
+    ns::packed_tuple t{'c', 1.5, 2};
+    STATIC_CHECK(
+      std::is_same_v<decltype(t), ns::packed_tuple<char, double, int>>);
+  }
+  {
+    ns::packed_tuple<char, double, int> t{};
+    CHECK(get<0>(t) == '\0');
+    CHECK(get<1>(t) == 0.0);
+    CHECK(get<2>(t) == 0);
+  }
+  {
+    constexpr ns::packed_tuple<char, double, int> t{'d', 0.5, 1};
+    STATIC_CHECK(get<0>(t) == 'd');
+    STATIC_CHECK(get<2>(t) == 1);
+  }
+}
+
+TEST_CASE("packed_tuple", "[packed_tuple][compare]") {
+  using testing_tuple = ns::packed_tuple<char, double, int>;
+  // 格納順の先頭は double だが、比較は宣言順 (char が先) で行う
+  CHECK(testing_tuple{'a', 2.0, 0} < testing_tuple{'b', 1.0, 0});
+  CHECK(testing_tuple{'a', 1.0, 1} < testing_tuple{'a', 1.0, 2});
+  CHECK(testing_tuple{'a', 1.0, 1} == testing_tuple{'a', 1.0, 1});
+  CHECK(testing_tuple{'a', 1.0, 1} != testing_tuple{'a', 1.0, 2});
+}
+
+TEST_CASE("packed_tuple", "[packed_tuple][tuple_select]") {
+  ns::packed_tuple<char, double, int, std::string> t{'a', 3.14, 42, "Hello"};
+  {
+    auto [s, c] = ns::tuple_select<3, 0>(t);
+    CHECK(s == "Hello");
+    CHECK(c == 'a');
+  }
+  {
+    auto [i, d] = ns::tuple_select_by_type<int, double>(t);
+    CHECK(i == 42);
+    CHECK(d == Catch::Approx(3.14));
+  }
+  {
+    auto [s] = ns::tuple_select<3>(std::move(t));
+    CHECK(s == "Hello");
+  }
+}
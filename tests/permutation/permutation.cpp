@@ -0,0 +1,105 @@
+#include <catch2/catch_test_macros.hpp>
+#include <ns/permutation.hpp>
+#include <ns/soa_vector.hpp>
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <map>
+#include <numeric>
+#include <string>
+#include <vector>
+
+inline constexpr std::uint64_t Seed = 0x01234567DEADC0DE;
+
+template <class Index>
+bool is_permutation_of_iota(std::vector<Index> perm) {
+  std::ranges::sort(perm);
+  for (std::size_t i = 0; i < perm.size(); ++i)
+    if (perm[i] != i)
+      return false;
+  return true;
+}
+
+TEST_CASE("make_permutation", "[permutation][small]") {
+  CHECK(ns::make_permutation(0, Seed).empty());
+  CHECK(ns::make_permutation(1, Seed) == std::vector<std::size_t>{0});
+  {
+    auto perm = ns::make_permutation(1000, Seed);
+    CHECK(is_permutation_of_iota(perm));
+    CHECK(perm == ns::make_permutation(1000, Seed));
+    CHECK(perm != ns::make_permutation(1000, Seed + 1));
+  }
+  {
+    // 3 要素の置換 6 通りがおおよそ一様に出る
+    std::map<std::vector<std::size_t>, int> counts;
+    constexpr int Trials = 6000;
+    for (int i = 0; i < Trials; ++i)
+      ++counts[ns::make_permutation(3, Seed + static_cast<std::uint64_t>(i))];
+    CHECK(counts.size() == 6);
+    for (const auto& [perm, count] : counts) {
+      CHECK(count > 850);
+      CHECK(count < 1150);
+    }
+  }
+}
+
+TEST_CASE("make_permutation", "[permutation][parallel]") {
+  // 複数のチャンクとバケットに分かれる大きさ
+  constexpr std::size_t N = (std::size_t(1) << 20) + 12345;
+  const auto perm = ns::make_permutation<std::uint32_t>(N, Seed, 1);
+  STATIC_CHECK(std::is_same_v<decltype(perm), const std::vector<std::uint32_t>>);
+  REQUIRE(perm.size() == N);
+  CHECK(is_permutation_of_iota(perm));
+  // 結果はスレッド数によらない
+  CHECK(perm == ns::make_permutation<std::uint32_t>(N, Seed, 3));
+  CHECK(perm == ns::make_permutation<std::uint32_t>(N, Seed, 8));
+  CHECK(perm != ns::make_permutation<std::uint32_t>(N, Seed + 1, 1));
+  {
+    // 前半に置かれる要素は、元の前半と後半からおおよそ半分ずつ来る
+    std::size_t from_front = 0;
+    for (std::size_t i = 0; i < N / 2; ++i)
+      from_front += perm[i] < N / 2;
+    const double ratio =
+      static_cast<double>(from_front) / static_cast<double>(N / 2);
+    CHECK(ratio > 0.49);
+    CHECK(ratio < 0.51);
+  }
+}
+
+TEST_CASE("apply_permutation", "[permutation][apply_permutation]") {
+  {
+    std::vector<std::string> v{"a", "b", "c", "d", "e"};
+    // 2 つの巡回 (0 2 4) (1 3)
+    const std::vector<std::uint32_t> perm{2, 3, 4, 1, 0};
+    ns::apply_permutation(perm, v);
+    CHECK(v == std::vector<std::string>{"c", "d", "e", "b", "a"});
+  }
+  {
+    // 複数の範囲を同じ置換で並べ替える
+    std::vector<int> keys{3, 1, 2};
+    std::vector<std::string> values{"three", "one", "two"};
+    const std::vector<std::size_t> perm{1, 2, 0};
+    ns::apply_permutation(perm, keys, values);
+    CHECK(keys == std::vector<int>{1, 2, 3});
+    CHECK(values == std::vector<std::string>{"one", "two", "three"});
+  }
+  {
+    // プロキシ参照を返す範囲
+    ns::soa_vector<int, std::string> v;
+    v.push_back({0, "zero"});
+    v.push_back({1, "one"});
+    v.push_back({2, "two"});
+    const std::vector<std::size_t> perm{2, 0, 1};
+    ns::apply_permutation(perm, v);
+    CHECK(std::get<0>(v[0]) == 2);
+    CHECK(std::get<1>(v[0]) == "two");
+    CHECK(std::get<1>(v[2]) == "one");
+  }
+  {
+    const auto perm = ns::make_permutation(1000, Seed);
+    std::vector<std::size_t> v(1000);
+    std::iota(v.begin(), v.end(), std::size_t(0));
+    ns::apply_permutation(perm, v);
+    CHECK(v == perm);
+  }
+}
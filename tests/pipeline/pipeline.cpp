@@ -0,0 +1,132 @@
+#include <catch2/catch_test_macros.hpp>
+#include <ns/pipeline.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <numeric>
+#include <ranges>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+TEST_CASE("pipeline", "[pipeline]") {
+  // draft/enumerate_view/draft0-simple.cpp の例
+  auto squares = ns::pipeline(std::views::iota(0))
+                 | ns::pipe::filter([](int x) { return x % 2 == 0; })
+                 | ns::pipe::transform([](int x) { return x * x; })
+                 | ns::pipe::take(4);
+  STATIC_CHECK(std::same_as<decltype(squares)::reference, int>);
+  CHECK(squares.to_vector() == std::vector<int>{0, 4, 16, 36});
+  // 同じパイプラインを繰り返し実行できる
+  CHECK(squares.to_vector() == std::vector<int>{0, 4, 16, 36});
+
+  // 段のないパイプライン
+  const std::vector<int> v{3, 1, 4, 1, 5, 9, 2, 6};
+  CHECK(ns::pipeline(v).to_vector() == v);
+
+  // stride
+  CHECK(
+    (ns::pipeline(v) | ns::pipe::stride(3)).to_vector()
+    == std::vector<int>{3, 1, 2});
+  CHECK(
+    (ns::pipeline(v) | ns::pipe::stride(1) | ns::pipe::take(2)).to_vector()
+    == std::vector<int>{3, 1});
+
+  // take
+  CHECK((ns::pipeline(v) | ns::pipe::take(0)).to_vector().empty());
+  CHECK((ns::pipeline(v) | ns::pipe::take(100)).to_vector() == v);
+  CHECK(
+    (ns::pipeline(std::views::iota(0)) | ns::pipe::take(3)).to_vector()
+    == std::vector<int>{0, 1, 2});
+}
+
+TEST_CASE("pipeline enumerate", "[pipeline]") {
+  const std::vector<int> v{3, 1, 4, 1, 5, 9, 2, 6};
+  {
+    // 元の位置を保ったまま絞り込む
+    auto p = ns::pipeline(v) | ns::pipe::enumerate()
+             | ns::pipe::filter([](const auto& e) { return e.second > 3; })
+             | ns::pipe::transform([](const auto& e) { return e.first; });
+    CHECK(p.to_vector() == std::vector<std::size_t>{2, 4, 5, 7});
+  }
+  {
+    // 絞り込んだ後に番号を振る
+    auto p = ns::pipeline(v)
+             | ns::pipe::filter([](int x) { return x > 3; })
+             | ns::pipe::enumerate(std::uint32_t(10));
+    STATIC_CHECK(std::same_as<
+                 decltype(p)::reference,
+                 std::pair<std::uint32_t, const int&>>);
+    CHECK(
+      p.to_vector()
+      == std::vector<std::pair<std::uint32_t, int>>{
+        {10, 4}, {11, 5}, {12, 9}, {13, 6}});
+  }
+  {
+    // 組の要素は元の要素の参照となり、書き込める
+    std::vector<int> w(6, 0);
+    (ns::pipeline(w) | ns::pipe::enumerate() | ns::pipe::stride(2))
+      .for_each([](auto e) { e.second = static_cast<int>(e.first); });
+    CHECK(w == std::vector<int>{0, 0, 2, 0, 4, 0});
+  }
+}
+
+TEST_CASE("pipeline for_each", "[pipeline]") {
+  std::list<int> l{1, 2, 3, 4, 5};
+  {
+    // sink が false を返すと走査を終える
+    std::vector<int> seen;
+    ns::pipeline(l).for_each([&](int x) {
+      seen.push_back(x);
+      return x < 3;
+    });
+    CHECK(seen == std::vector<int>{1, 2, 3});
+  }
+  {
+    // 入力範囲 (1 回のみ走査できる)
+    std::istringstream is("a bb ccc dddd");
+    auto p = ns::pipeline(std::views::istream<std::string>(is))
+             | ns::pipe::transform([](const std::string& s) {
+                 return s.size();
+               })
+             | ns::pipe::take(3);
+    CHECK(p.to_vector() == std::vector<std::size_t>{1, 2, 3});
+  }
+}
+
+TEST_CASE("pipeline index prefix", "[pipeline]") {
+  // 先頭の take, stride を添字の計算に置き換える場合と、1 つずつ走査する場合
+  std::vector<int> v(23);
+  std::iota(v.begin(), v.end(), 0);
+  const std::list<int> l(v.begin(), v.end());
+  auto check = [&](auto... stages) {
+    const auto indexed = (ns::pipeline(v) | ... | stages).to_vector();
+    const auto scanned = (ns::pipeline(l) | ... | stages).to_vector();
+    CHECK(indexed == scanned);
+    return indexed;
+  };
+  CHECK(check(ns::pipe::stride(5)) == std::vector<int>{0, 5, 10, 15, 20});
+  CHECK(
+    check(ns::pipe::take(7), ns::pipe::stride(3))
+    == std::vector<int>{0, 3, 6});
+  CHECK(
+    check(ns::pipe::stride(3), ns::pipe::take(2)) == std::vector<int>{0, 3});
+  CHECK(
+    check(ns::pipe::stride(2), ns::pipe::stride(3), ns::pipe::take(100))
+    == std::vector<int>{0, 6, 12, 18});
+  CHECK(check(ns::pipe::stride(4), ns::pipe::take(0)).empty());
+  CHECK(
+    check(
+      ns::pipe::stride(4),
+      ns::pipe::enumerate(),
+      ns::pipe::transform([](auto e) {
+        return static_cast<int>(e.first) + e.second;
+      }),
+      ns::pipe::take(3))
+    == std::vector<int>{0, 5, 10});
+  CHECK(
+    check(
+      ns::pipe::filter([](int x) { return x % 2 == 1; }), ns::pipe::take(2))
+    == std::vector<int>{1, 3});
+}
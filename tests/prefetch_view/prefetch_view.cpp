@@ -0,0 +1,131 @@
+#include <catch2/catch_test_macros.hpp>
+#include <ns/enumerate_view.hpp>
+#include <ns/prefetch_view.hpp>
+#include <cstddef>
+#include <forward_list>
+#include <iterator>
+#include <list>
+#include <memory>
+#include <ranges>
+#include <utility>
+#include <vector>
+
+namespace {
+  template <std::ranges::input_range R>
+  auto to_vector(R&& r) {
+    std::vector<std::ranges::range_value_t<R>> result;
+    for (auto&& x : r)
+      result.push_back(x);
+    return result;
+  }
+
+  /// @brief プリフェッチした要素を記録する
+  struct recording_address {
+    std::vector<int>* seen;
+    const void* operator()(const int& x) const {
+      seen->push_back(x);
+      return &x;
+    }
+  };
+} // namespace
+
+TEST_CASE("prefetch_view", "[prefetch_view]") {
+  std::list<int> l{3, 1, 4, 1, 5, 9, 2, 6};
+  auto p = ns::prefetch_view(l, 3);
+  using P = decltype(p);
+  STATIC_CHECK(std::ranges::forward_range<P>);
+  STATIC_CHECK(std::ranges::forward_range<const P>);
+  STATIC_CHECK(std::ranges::common_range<P>);
+  STATIC_CHECK(std::ranges::sized_range<P>);
+  STATIC_CHECK(std::same_as<std::ranges::range_reference_t<P>, int&>);
+  STATIC_CHECK(std::same_as<
+               std::iterator_traits<
+                 std::ranges::iterator_t<P>>::iterator_category,
+               std::forward_iterator_tag>);
+  CHECK(p.distance() == 3);
+  CHECK(p.size() == 8);
+  CHECK(to_vector(p) == std::vector<int>(l.begin(), l.end()));
+  // 要素は元の範囲の参照となる
+  for (int& x : p)
+    x *= 2;
+  CHECK(to_vector(l) == std::vector<int>{6, 2, 8, 2, 10, 18, 4, 12});
+
+  // 先読みしない場合と、範囲より長く先読みする場合
+  CHECK(to_vector(ns::prefetch_view(l, 0)) == to_vector(l));
+  CHECK(to_vector(ns::prefetch_view(l, 100)) == to_vector(l));
+  // 空の範囲
+  std::forward_list<int> empty;
+  CHECK(ns::prefetch_view(empty).empty());
+
+  // common_range でない範囲、要素が prvalue の範囲
+  auto naturals = std::views::iota(0)
+                  | std::views::take_while([](int x) { return x < 5; });
+  auto q = ns::prefetch_view(naturals, 2);
+  STATIC_CHECK(not std::ranges::common_range<decltype(q)>);
+  STATIC_CHECK(std::same_as<
+               std::iterator_traits<
+                 std::ranges::iterator_t<decltype(q)>>::iterator_category,
+               std::input_iterator_tag>);
+  CHECK(to_vector(q) == std::vector<int>{0, 1, 2, 3, 4});
+}
+
+TEST_CASE("prefetch_view lookahead", "[prefetch_view]") {
+  const std::forward_list<int> l{0, 1, 2, 3, 4, 5, 6};
+  std::vector<int> seen;
+  auto p = ns::prefetch_view(l, 3, recording_address{&seen});
+  auto it = p.begin();
+  // 先読みは distance 個先まで進む
+  CHECK(seen == std::vector<int>{0, 1, 2});
+  ++it;
+  CHECK(*it == 1);
+  CHECK(seen == std::vector<int>{0, 1, 2, 3});
+  // 各要素はちょうど 1 回ずつプリフェッチされる
+  while (it != p.end())
+    ++it;
+  CHECK(seen == std::vector<int>{0, 1, 2, 3, 4, 5, 6});
+}
+
+TEST_CASE("prefetch_view prvalue", "[prefetch_view]") {
+  // 既定の射影では、要素が prvalue のとき先読みで要素を読み出さない
+  const std::vector<int> v{0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+  int calls = 0;
+  auto f = [&calls](int x) {
+    ++calls;
+    return x * 2;
+  };
+  int sum = 0;
+  for (int x : ns::prefetch_view(v | std::views::transform(f), 4))
+    sum += x;
+  CHECK(sum == 90);
+  CHECK(calls == 10);
+  // 射影を渡すと、先読みでも要素を読み出す
+  calls = 0;
+  for (int x : ns::prefetch_view(
+         v | std::views::transform(f), 4, [](int) -> const void* {
+           return nullptr;
+         }))
+    static_cast<void>(x);
+  CHECK(calls == 20);
+}
+
+TEST_CASE("prefetch_view projection", "[prefetch_view]") {
+  // 要素が指す先をプリフェッチする
+  std::vector<std::unique_ptr<int>> owners;
+  std::list<int*> l;
+  for (int i = 0; i < 10; ++i) {
+    owners.push_back(std::make_unique<int>(i * i));
+    l.push_back(owners.back().get());
+  }
+  auto p = ns::prefetch_view(l, 4, [](int* x) -> const void* { return x; });
+  int sum = 0;
+  for (int* x : p)
+    sum += *x;
+  CHECK(sum == 285);
+
+  // enumerate_view と組み合わせる
+  std::vector<std::pair<std::size_t, int>> pairs;
+  for (auto [i, x] : ns::enumerate_view(p))
+    pairs.emplace_back(i, *x);
+  REQUIRE(pairs.size() == 10);
+  CHECK(pairs[3] == std::pair<std::size_t, int>{3, 9});
+}
@@ -0,0 +1,119 @@
+#include <catch2/catch_test_macros.hpp>
+#include <ns/random.hpp>
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+static_assert(std::uniform_random_bit_generator<ns::random::xoshiro256ss>);
+
+inline constexpr std::uint64_t Seed = 0x01234567DEADC0DE;
+
+TEST_CASE("splitmix64", "[random][splitmix64]") {
+  std::uint64_t state = 0;
+  CHECK(ns::random::splitmix64(state) == 0xe220a8397b1dcdaf);
+  CHECK(state == 0x9e3779b97f4a7c15);
+}
+
+TEST_CASE("xoshiro256ss", "[random][xoshiro256ss]") {
+  {
+    // https://prng.di.unimi.it/xoshiro256starstar.c の出力と一致する
+    ns::random::xoshiro256ss g({1, 2, 3, 4});
+    CHECK(g() == 11520);
+    CHECK(g() == 0);
+    CHECK(g() == 1509978240);
+    CHECK(g() == 1215971899390074240);
+    g.jump();
+    CHECK(g() == 10982751773866918481u);
+  }
+  {
+    constexpr auto value = [] {
+      ns::random::xoshiro256ss g(Seed);
+      g();
+      return g();
+    }();
+    ns::random::xoshiro256ss g(Seed);
+    g();
+    CHECK(g() == value);
+  }
+  {
+    ns::random::xoshiro256ss g1(Seed), g2(Seed), g3(Seed + 1);
+    CHECK(g1 == g2);
+    CHECK(g1 != g3);
+  }
+  {
+    std::vector<int> v(100);
+    for (int i = 0; i < 100; ++i)
+      v[static_cast<std::size_t>(i)] = i;
+    std::shuffle(v.begin(), v.end(), ns::random::xoshiro256ss(Seed));
+    std::ranges::sort(v);
+    for (int i = 0; i < 100; ++i)
+      CHECK(v[static_cast<std::size_t>(i)] == i);
+  }
+}
+
+TEST_CASE("xoshiro256ss_batch", "[random][xoshiro256ss_batch]") {
+  constexpr std::size_t Lanes = 4;
+  ns::random::xoshiro256ss_batch<Lanes> batch(Seed);
+  std::array<std::uint64_t, 4 * Lanes + 3> out{};
+  batch.fill(out);
+  // レーン k は種から作った生成器を k 回 jump したもの
+  for (std::size_t k = 0; k < Lanes; ++k) {
+    ns::random::xoshiro256ss g(Seed);
+    for (std::size_t j = 0; j < k; ++j)
+      g.jump();
+    for (std::size_t i = k; i < out.size(); i += Lanes)
+      CHECK(out[i] == g());
+  }
+  {
+    constexpr auto first = [] {
+      ns::random::xoshiro256ss_batch<2> b(Seed);
+      std::array<std::uint64_t, 2> a{};
+      b.fill(a);
+      return a[0];
+    }();
+    CHECK(first == ns::random::xoshiro256ss(Seed)());
+  }
+}
+
+TEST_CASE("mul_wide", "[random][mul_wide]") {
+  using ns::random::mul_wide;
+  STATIC_CHECK(mul_wide(0, 5) == std::pair<std::uint64_t, std::uint64_t>{0, 0});
+  STATIC_CHECK(
+    mul_wide(~std::uint64_t(0), ~std::uint64_t(0))
+    == std::pair<std::uint64_t, std::uint64_t>{~std::uint64_t(0) - 1, 1});
+  STATIC_CHECK(
+    mul_wide(std::uint64_t(1) << 63, 4)
+    == std::pair<std::uint64_t, std::uint64_t>{2, 0});
+}
+
+TEST_CASE("uniform_below", "[random][uniform_below]") {
+  ns::random::xoshiro256ss g(Seed);
+  {
+    for (int i = 0; i < 100; ++i)
+      CHECK(ns::random::uniform_below(g, 1) == 0);
+  }
+  {
+    // 各値がおおよそ一様に出る
+    constexpr std::uint64_t Bound = 6;
+    constexpr int Draws = 60000;
+    std::array<int, Bound> counts{};
+    for (int i = 0; i < Draws; ++i) {
+      const auto x = ns::random::uniform_below(g, Bound);
+      REQUIRE(x < Bound);
+      ++counts[x];
+    }
+    for (auto c : counts) {
+      CHECK(c > 9000);
+      CHECK(c < 11000);
+    }
+  }
+  {
+    constexpr auto x = [] {
+      ns::random::xoshiro256ss gen(Seed);
+      return ns::random::uniform_below(gen, 1000);
+    }();
+    STATIC_CHECK(x < 1000);
+  }
+}
@@ -0,0 +1,179 @@
+#include <catch2/catch_test_macros.hpp>
+#include <ns/enumerate_view.hpp>
+#include <ns/random.hpp>
+#include <ns/selection_view.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <list>
+#include <ranges>
+#include <vector>
+
+inline constexpr std::uint64_t Seed = 0x01234567DEADC0DE;
+
+using testing_view = ns::selection_view<
+  std::views::all_t<std::vector<int>&>,
+  std::views::all_t<const std::vector<std::size_t>&>>;
+static_assert(std::ranges::random_access_range<testing_view>);
+static_assert(std::ranges::sized_range<testing_view>);
+static_assert(std::ranges::common_range<testing_view>);
+static_assert(std::ranges::random_access_range<const testing_view>);
+static_assert(std::ranges::output_range<testing_view, int>);
+
+/// @brief 実行中の CPU で使えるすべての水準
+std::vector<ns::simd::level> available_levels() {
+  std::vector<ns::simd::level> levels{ns::simd::level::scalar};
+  for (auto l : {ns::simd::level::sse2, ns::simd::level::avx2})
+    if (l <= ns::simd::detected_level())
+      levels.push_back(l);
+  return levels;
+}
+
+template <class T>
+std::vector<T> random_values(std::size_t n, std::uint64_t bound) {
+  ns::random::xoshiro256ss gen(Seed + n);
+  std::vector<T> v(n);
+  for (auto& x : v)
+    x = static_cast<T>(ns::random::uniform_below(gen, bound));
+  return v;
+}
+
+/// @brief 各水準の compress の結果を 1 つずつ調べた結果と比べる
+template <class Index, class T>
+void check_compress(const std::vector<T>& v, T value) {
+  using ns::simd::compare_op;
+  std::vector<Index> expected;
+  for (std::size_t i = 0; i < v.size(); ++i)
+    if (v[i] < value)
+      expected.push_back(static_cast<Index>(i + 5));
+  for (auto l : available_levels()) {
+    std::vector<Index> out(v.size() + ns::simd::compress_slack);
+    const std::size_t count = ns::simd::compress<compare_op::lt>(
+      l, v.data(), v.size(), value, Index(5), out.data());
+    out.resize(count);
+    CHECK(out == expected);
+  }
+}
+
+TEST_CASE("simd compress", "[selection_view][simd]") {
+  const std::vector<std::size_t> sizes{0, 1, 3, 4, 7, 8, 9, 31, 100, 1000};
+  for (std::size_t n : sizes) {
+    // 選ばれる割合を変える
+    for (std::int32_t value : {0, 1, 50, 99, 100}) {
+      check_compress<std::uint32_t>(
+        random_values<float>(n, 100), static_cast<float>(value));
+      check_compress<std::size_t>(
+        random_values<double>(n, 100), static_cast<double>(value));
+      check_compress<std::int32_t>(random_values<std::int32_t>(n, 100), value);
+      check_compress<std::uint64_t>(
+        random_values<std::int64_t>(n, 100), std::int64_t(value));
+    }
+  }
+}
+
+TEST_CASE("indices_where", "[selection_view][indices_where]") {
+  const std::vector<float> v{0.5f, 2.0f, -1.0f, 2.0f, 8.0f};
+  CHECK(
+    ns::indices_where(v, ns::greater_than(1.0f))
+    == std::vector<std::size_t>{1, 3, 4});
+  CHECK(
+    ns::indices_where(v, [](float x) { return x > 1.0f; })
+    == std::vector<std::size_t>{1, 3, 4});
+  CHECK(ns::indices_where(v, ns::equal_to(3)).empty());
+  CHECK(ns::indices_where(std::vector<int>{}, ns::less_than(1)).empty());
+
+  // enumerate_view の添字を返す
+  CHECK(
+    ns::indices_where(ns::enumerate_view(v, 10u), ns::equal_to(2.0f))
+    == std::vector<unsigned>{11, 13});
+  // 符号付きの添字
+  CHECK(
+    ns::indices_where(ns::enumerate_view(v, 10), ns::less_than(3.0f))
+    == std::vector<int>{10, 11, 12, 13});
+  CHECK(
+    ns::indices_where(
+      ns::enumerate_view(v, -2), [](float x) { return x > 1.0f; })
+    == std::vector<int>{-1, 1, 2});
+  {
+    // 作業領域の大きさをまたぐ場合
+    const std::vector<float> u(3000, 1.0f);
+    const auto sel = ns::indices_where(
+      ns::enumerate_view(u, std::int64_t{-1500}), ns::greater_than(0.0f));
+    REQUIRE(sel.size() == u.size());
+    CHECK(sel.front() == -1500);
+    CHECK(sel.back() == 1499);
+    CHECK(std::ranges::is_sorted(sel));
+  }
+
+  // 連続していない範囲
+  const std::list<int> l{4, 5, 6, 5};
+  CHECK(
+    ns::indices_where(l, ns::equal_to(5)) == std::vector<std::size_t>{1, 3});
+  CHECK(
+    ns::indices_where(ns::enumerate_view(l, 2u), ns::greater_equal(5))
+    == std::vector<unsigned>{3, 4, 5});
+
+  // 作業領域の大きさをまたぐ要素数
+  const auto w = random_values<std::int32_t>(5000, 10);
+  std::vector<std::size_t> expected;
+  for (std::size_t i = 0; i < w.size(); ++i)
+    if (w[i] != 3)
+      expected.push_back(i);
+  CHECK(ns::indices_where(w, ns::not_equal_to(3)) == expected);
+  CHECK(
+    ns::indices_where(w, [](std::int32_t x) { return x != 3; }) == expected);
+}
+
+TEST_CASE("selection_view", "[selection_view]") {
+  std::vector<int> v{10, 11, 12, 13, 14, 15};
+  const auto sel = ns::indices_where(v, [](int x) { return x % 2 == 1; });
+  {
+    ns::selection_view sv(v, sel);
+    STATIC_CHECK(std::same_as<decltype(sv), testing_view>);
+    REQUIRE(sv.size() == 3);
+    CHECK(std::ranges::equal(sv, std::vector<int>{11, 13, 15}));
+    CHECK(sv[1] == 13);
+    CHECK((sv.begin() + 2).index() == 5);
+    CHECK(sv.end() - sv.begin() == 3);
+    // 要素への書き込みは元の範囲に反映される
+    for (auto& x : sv)
+      x = 0;
+    CHECK(v == std::vector<int>{10, 0, 12, 0, 14, 0});
+  }
+  {
+    // 元の添字と要素の組を走査する
+    std::vector<double> w{0.5, 2.5, 1.5};
+    std::vector<std::size_t> indices;
+    std::vector<double> values;
+    for (auto [i, x] : ns::selection_view(
+           ns::enumerate_view(w),
+           ns::indices_where(w, ns::greater_than(1.0)))) {
+      indices.push_back(i);
+      values.push_back(x);
+    }
+    CHECK(indices == std::vector<std::size_t>{1, 2});
+    CHECK(values == std::vector<double>{2.5, 1.5});
+  }
+  {
+    // enumerate_view の start() から数えた添字を選択ベクトルとして渡す
+    std::vector<double> w{0.5, 2.5, 1.5, 3.5};
+    ns::enumerate_view ev(w, 100u);
+    const auto sel2 = ns::indices_where(ev, ns::greater_than(1.0));
+    CHECK(sel2 == std::vector<unsigned>{101, 102, 103});
+    ns::selection_view sv(ev, sel2);
+    std::vector<unsigned> indices;
+    std::vector<double> values;
+    for (auto [i, x] : sv) {
+      indices.push_back(i);
+      values.push_back(x);
+    }
+    CHECK(indices == sel2);
+    CHECK(values == std::vector<double>{2.5, 1.5, 3.5});
+    CHECK((sv.begin() + 2).index() == 103u);
+  }
+  {
+    const std::vector<std::size_t> empty;
+    CHECK(ns::selection_view(v, empty).empty());
+  }
+}
@@ -0,0 +1,121 @@
+#include <catch2/catch_test_macros.hpp>
+#include <ns/enumerate_view.hpp>
+#include <ns/random.hpp>
+#include <ns/set_bits_view.hpp>
+#include <algorithm>
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <forward_list>
+#include <limits>
+#include <ranges>
+#include <utility>
+#include <vector>
+
+inline constexpr std::uint64_t Seed = 0x01234567DEADC0DE;
+
+using testing_view =
+  ns::set_bits_view<std::views::all_t<const std::vector<std::uint64_t>&>>;
+static_assert(std::ranges::forward_range<testing_view>);
+static_assert(not std::ranges::sized_range<testing_view>);
+static_assert(std::ranges::sized_range<ns::set_bits_view<
+                std::views::all_t<const std::vector<std::uint64_t>&>,
+                true>>);
+static_assert(std::ranges::common_range<testing_view>);
+static_assert(std::ranges::forward_range<const testing_view>);
+static_assert(
+  std::same_as<std::ranges::range_value_t<testing_view>, std::size_t>);
+
+/// @brief 1 ビットずつ調べた立っているビットの位置
+template <class Word>
+std::vector<std::size_t> naive_set_bits(const std::vector<Word>& words) {
+  constexpr std::size_t bits = std::numeric_limits<Word>::digits;
+  std::vector<std::size_t> result;
+  for (std::size_t i = 0; i < words.size() * bits; ++i)
+    if ((words[i / bits] >> (i % bits)) & 1)
+      result.push_back(i);
+  return result;
+}
+
+template <class Word>
+void check_set_bits(const std::vector<Word>& words) {
+  const auto expected = naive_set_bits(words);
+  ns::set_bits_view sv(words);
+  CHECK(std::ranges::equal(sv, expected));
+  CHECK(sv.empty() == expected.empty());
+  ns::set_bits_view counted(words, ns::with_count);
+  CHECK(std::ranges::equal(counted, expected));
+  CHECK(counted.size() == expected.size());
+}
+
+TEST_CASE("set_bits_view", "[set_bits_view]") {
+  {
+    const std::vector<std::uint64_t> words{0b1011, 0, 0, 1ull << 63, 0};
+    ns::set_bits_view sv(words);
+    STATIC_CHECK(std::same_as<decltype(sv), testing_view>);
+    CHECK(std::ranges::equal(sv, std::vector<std::size_t>{0, 1, 3, 255}));
+    CHECK(std::ranges::distance(sv) == 4);
+    CHECK(ns::set_bits_view(words, ns::with_count).size() == 4);
+    CHECK(*std::ranges::next(sv.begin(), 3) == 255);
+    CHECK(std::ranges::next(sv.begin(), 4) == sv.end());
+  }
+  // 空の範囲とすべて 0 の範囲
+  check_set_bits(std::vector<std::uint64_t>{});
+  check_set_bits(std::vector<std::uint64_t>(10));
+  check_set_bits(std::vector<std::uint64_t>(3, ~std::uint64_t(0)));
+  check_set_bits(std::vector<std::uint8_t>{0x80, 0, 0x01, 0xFF});
+  check_set_bits(std::vector<std::uint32_t>{0, 0x80000001u, 0});
+
+  // 疎なものから密なものまで
+  ns::random::xoshiro256ss gen(Seed);
+  for (std::uint64_t percent : {0u, 1u, 10u, 50u, 90u, 100u}) {
+    std::vector<std::uint64_t> words(37);
+    for (std::size_t i = 0; i < words.size() * 64; ++i)
+      if (ns::random::uniform_below(gen, 100) < percent)
+        words[i / 64] |= std::uint64_t(1) << (i % 64);
+    check_set_bits(words);
+  }
+}
+
+TEST_CASE("set_bits_view non-common", "[set_bits_view]") {
+  // 番兵が異なる型の範囲
+  const std::vector<std::uint16_t> words{0, 0x0101, 0, 0x8000};
+  auto taken = std::views::take_while(words, [](auto) { return true; });
+  ns::set_bits_view sv(taken);
+  STATIC_CHECK(not std::ranges::common_range<decltype(sv)>);
+  CHECK(std::ranges::equal(sv, std::vector<std::size_t>{16, 24, 63}));
+
+  // 前方向のみのイテレータ
+  const std::forward_list<std::uint8_t> l{0x02, 0x00, 0x81};
+  CHECK(std::ranges::equal(
+    ns::set_bits_view(l), std::vector<std::size_t>{1, 16, 23}));
+}
+
+TEST_CASE("bitset_words", "[set_bits_view]") {
+  std::bitset<130> bs;
+  for (std::size_t i : {0u, 5u, 63u, 64u, 127u, 129u})
+    bs.set(i);
+  const auto words = ns::bitset_words(bs);
+  STATIC_CHECK(words.size() == 3);
+  CHECK(std::ranges::equal(
+    ns::set_bits_view(words),
+    std::vector<std::size_t>{0, 5, 63, 64, 127, 129}));
+  CHECK(ns::set_bits_view(words, ns::with_count).size() == bs.count());
+  CHECK(ns::set_bits_view(ns::bitset_words(std::bitset<7>())).empty());
+}
+
+TEST_CASE("set_bits_view with enumerate_view", "[set_bits_view]") {
+  const std::vector<std::uint64_t> words{0b1010, 0, 0b1};
+  std::vector<std::pair<std::size_t, std::size_t>> pairs;
+  for (auto [rank, bit] : ns::enumerate_view(ns::set_bits_view(words)))
+    pairs.emplace_back(rank, bit);
+  CHECK(
+    pairs
+    == std::vector<std::pair<std::size_t, std::size_t>>{
+      {0, 1}, {1, 3}, {2, 128}});
+  // 数を保持する view は sized_range となり、enumerate_view も大きさを返す
+  CHECK(
+    std::ranges::size(
+      ns::enumerate_view(ns::set_bits_view(words, ns::with_count)))
+    == 3);
+}
@@ -0,0 +1,99 @@
+#include <catch2/catch_test_macros.hpp>
+#include <ns/enumerate_view.hpp>
+#include <ns/shuffle_view.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <ranges>
+#include <vector>
+
+inline constexpr std::uint64_t Seed = 0x01234567DEADC0DE;
+
+using testing_view = ns::shuffle_view<std::views::all_t<std::vector<int>&>>;
+static_assert(std::ranges::random_access_range<testing_view>);
+static_assert(std::ranges::sized_range<testing_view>);
+static_assert(std::ranges::common_range<testing_view>);
+static_assert(std::ranges::random_access_range<const testing_view>);
+static_assert(std::ranges::output_range<testing_view, int>);
+static_assert(std::same_as<
+              std::iterator_traits<std::ranges::iterator_t<testing_view>>::
+                iterator_category,
+              std::random_access_iterator_tag>);
+
+TEST_CASE("feistel_permutation", "[shuffle_view][feistel_permutation]") {
+  const std::vector<std::uint64_t> sizes{1, 2, 3, 17, 1000, 4097};
+  for (std::uint64_t n : sizes) {
+    ns::feistel_permutation perm(n, Seed);
+    REQUIRE(perm.size() == n);
+    std::vector<bool> seen(n);
+    for (std::uint64_t i = 0; i < n; ++i) {
+      const auto x = perm(i);
+      REQUIRE(x < n);
+      CHECK(not seen[x]);
+      seen[x] = true;
+      CHECK(perm.inverse(x) == i);
+    }
+  }
+  {
+    constexpr ns::feistel_permutation perm(100, Seed);
+    STATIC_CHECK(perm.inverse(perm(42)) == 42);
+  }
+  {
+    // 種が異なれば置換も異なる
+    ns::feistel_permutation p1(1000, Seed), p2(1000, Seed + 1);
+    std::size_t same = 0;
+    for (std::uint64_t i = 0; i < 1000; ++i)
+      same += p1(i) == p2(i);
+    CHECK(same < 20);
+  }
+}
+
+TEST_CASE("shuffle_view", "[shuffle_view]") {
+  std::vector<int> v(1000);
+  std::iota(v.begin(), v.end(), 0);
+  {
+    ns::shuffle_view sv(v, Seed);
+    STATIC_CHECK(std::same_as<decltype(sv), testing_view>);
+    REQUIRE(sv.size() == v.size());
+    std::vector<int> w(sv.begin(), sv.end());
+    CHECK(w != v);
+    CHECK(std::ranges::equal(w, ns::shuffle_view(v, Seed)));
+    CHECK(not std::ranges::equal(w, ns::shuffle_view(v, Seed + 1)));
+    std::ranges::sort(w);
+    CHECK(w == v);
+  }
+  {
+    ns::shuffle_view sv(v, Seed);
+    auto it = sv.begin() + 10;
+    CHECK(*it == sv[10]);
+    CHECK(it - sv.begin() == 10);
+    CHECK(&*it == &v[sv.permutation()(10)]);
+    // 要素への書き込みは元の範囲に反映される
+    *it = -1;
+    CHECK(v[sv.permutation()(10)] == -1);
+  }
+  {
+    std::vector<int> empty;
+    CHECK(ns::shuffle_view(empty, Seed).empty());
+  }
+}
+
+TEST_CASE("shuffle_view", "[shuffle_view][enumerate_view]") {
+  std::vector<int> v(100);
+  std::iota(v.begin(), v.end(), 100);
+  {
+    // 元の添字とともに擬似ランダムな順に走査する
+    std::vector<bool> seen(v.size());
+    for (auto [i, x] : ns::shuffle_view(ns::enumerate_view(v), Seed)) {
+      CHECK(x == static_cast<int>(i) + 100);
+      seen[i] = true;
+    }
+    CHECK(std::ranges::all_of(seen, [](bool b) { return b; }));
+  }
+  {
+    // 走査順での位置を添字とする
+    ns::shuffle_view sv(v, Seed);
+    for (auto [i, x] : ns::enumerate_view(sv))
+      CHECK(x == v[sv.permutation()(i)]);
+  }
+}
@@ -0,0 +1,131 @@
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <ns/enumerate_view.hpp>
+#include <ns/soa_vector.hpp>
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+
+using testing_vector = ns::soa_vector<int, double, std::string>;
+static_assert(std::ranges::random_access_range<testing_vector>);
+static_assert(std::ranges::sized_range<testing_vector>);
+static_assert(std::ranges::view<ns::soa_span<int, double>>);
+static_assert(std::ranges::borrowed_range<ns::soa_span<int, double>>);
+static_assert(std::ranges::random_access_range<ns::soa_span<const int>>);
+
+TEST_CASE("soa_vector", "[soa_vector]") {
+  testing_vector v;
+  CHECK(v.empty());
+  v.push_back({0, 3.14, "Hello"});
+  v.emplace_back(1, 2.71, "World");
+  REQUIRE(v.size() == 2);
+  {
+    auto [i, d, s] = v[1];
+    CHECK(i == 1);
+    CHECK(d == Catch::Approx(2.71));
+    CHECK(s == "World");
+    STATIC_CHECK(std::is_same_v<
+                 decltype(v[1]),
+                 std::tuple<int&, double&, std::string&>>);
+  }
+  {
+    // 行のプロキシ参照を通して書き込む
+    std::get<0>(v[0]) = 42;
+    CHECK(v.column<0>()[0] == 42);
+    for (auto [i, d, s] : v)
+      d += 1.0;
+    CHECK(v.column<double>()[0] == Catch::Approx(4.14));
+    CHECK(v.column<double>()[1] == Catch::Approx(3.71));
+  }
+  {
+    const auto& cv = v;
+    STATIC_CHECK(std::is_same_v<
+                 decltype(cv[0]),
+                 std::tuple<const int&, const double&, const std::string&>>);
+    STATIC_CHECK(std::is_same_v<
+                 decltype(cv.column<std::string>()),
+                 std::span<const std::string>>);
+    CHECK(std::get<2>(*std::ranges::begin(cv)) == "Hello");
+  }
+  {
+    std::tuple<int, double, std::string> row = *std::ranges::begin(v);
+    CHECK(std::get<0>(row) == 42);
+    v.pop_back();
+    CHECK(v.size() == 1);
+    v.clear();
+    CHECK(v.empty());
+  }
+}
+
+TEST_CASE("soa_vector", "[soa_vector][columns]") {
+  ns::soa_vector<int, float> v(100);
+  auto ints = v.column<0>();
+  auto floats = v.column<float>();
+  std::iota(ints.begin(), ints.end(), 0);
+  std::ranges::fill(floats, 0.5f);
+  CHECK(std::accumulate(ints.begin(), ints.end(), 0) == 4950);
+  CHECK(std::get<0>(v[99]) == 99);
+  CHECK(std::get<1>(v[99]) == 0.5f);
+}
+
+TEST_CASE("soa_vector", "[soa_vector][tuple_select]") {
+  testing_vector v;
+  v.push_back({0, 3.14, "Hello"});
+  v.push_back({1, 2.71, "World"});
+  {
+    auto sel = ns::tuple_select<2, 0>(v);
+    STATIC_CHECK(std::is_same_v<decltype(sel), ns::soa_span<std::string, int>>);
+    REQUIRE(std::ranges::size(sel) == 2);
+    auto [s, i] = sel[1];
+    CHECK(s == "World");
+    CHECK(i == 1);
+    CHECK(sel.column<1>().data() == v.column<0>().data());
+  }
+  {
+    const auto& cv = v;
+    auto sel = ns::tuple_select_by_type<double>(cv);
+    STATIC_CHECK(std::is_same_v<decltype(sel), ns::soa_span<const double>>);
+    double sum = 0.0;
+    for (auto [d] : sel)
+      sum += d;
+    CHECK(sum == Catch::Approx(5.85));
+  }
+  {
+    // 行のプロキシ参照にも tuple_arrange の関数を使える
+    auto [s, i] = ns::tuple_select<2, 0>(v[0]);
+    CHECK(s == "Hello");
+    CHECK(i == 0);
+  }
+  {
+    auto sel = ns::tuple_select<0>(v);
+    for (auto [n, row] : ns::enumerate_view(sel))
+      CHECK(static_cast<int>(n) == std::get<0>(row));
+  }
+}
+
+struct throwing {
+  int value = 0;
+  throwing() = default;
+  explicit throwing(int x) : value(x) {
+    if (x < 0)
+      throw std::invalid_argument("negative");
+  }
+};
+
+TEST_CASE("soa_vector", "[soa_vector][exception]") {
+  ns::soa_vector<std::string, throwing, int> v;
+  v.emplace_back("a", 1, 1);
+  CHECK_THROWS_AS(v.emplace_back("b", -1, 2), std::invalid_argument);
+  // 先に伸ばした std::string の列も元の長さに戻る
+  REQUIRE(v.size() == 1);
+  CHECK(v.column<0>().size() == 1);
+  CHECK(v.column<1>().size() == 1);
+  CHECK(v.column<2>().size() == 1);
+  auto [s, t, i] = v[0];
+  CHECK(s == "a");
+  CHECK(t.value == 1);
+  CHECK(i == 1);
+}
@@ -0,0 +1,123 @@
+#include <catch2/catch_test_macros.hpp>
+#include <ns/enumerate_view.hpp>
+#include <ns/thread_pool.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+/// @brief 空でない範囲で [0, n) をちょうど 1 回ずつ覆うかを返す
+/// @details Catch2 のマクロはスレッド安全でないため、結果を返して呼び出し側で
+/// 調べる。
+bool covers_once(ns::thread_pool& pool, std::size_t n, std::size_t grain) {
+  std::vector<std::atomic<int>> visited(n);
+  std::atomic<bool> empty_chunk = false;
+  pool.for_each_chunk(
+    n,
+    [&](std::size_t first, std::size_t last) {
+      if (first >= last)
+        empty_chunk = true;
+      for (std::size_t i = first; i < last; ++i)
+        visited[i].fetch_add(1);
+    },
+    grain);
+  return not empty_chunk.load()
+         and std::ranges::all_of(visited, [](auto& v) { return v == 1; });
+}
+
+TEST_CASE("thread_pool for_each_chunk", "[thread_pool]") {
+  for (unsigned threads : {0u, 1u, 2u, 4u}) {
+    ns::thread_pool pool(threads);
+    CHECK(pool.concurrency() == std::max(1u, threads));
+    for (std::size_t n : {0u, 1u, 2u, 7u, 1000u, 100000u})
+      for (std::size_t grain : {0u, 1u, 64u})
+        CHECK(covers_once(pool, n, grain));
+  }
+}
+
+TEST_CASE("thread_pool nested", "[thread_pool]") {
+  ns::thread_pool pool(4);
+  std::atomic<std::size_t> sum = 0;
+  pool.for_each_chunk(
+    64,
+    [&](std::size_t first, std::size_t last) {
+      for (std::size_t i = first; i < last; ++i)
+        pool.for_each_chunk(
+          100,
+          [&](std::size_t a, std::size_t b) { sum.fetch_add(b - a); },
+          8);
+    },
+    1);
+  CHECK(sum.load() == 6400);
+}
+
+TEST_CASE("thread_pool exception", "[thread_pool]") {
+  ns::thread_pool pool(4);
+  CHECK_THROWS_AS(
+    pool.for_each_chunk(
+      10000,
+      [](std::size_t first, std::size_t last) {
+        if (first <= 5000 and 5000 < last)
+          throw std::runtime_error("error");
+      },
+      16),
+    std::runtime_error);
+  // 例外の後も使える
+  CHECK(covers_once(pool, 1000, 16));
+}
+
+TEST_CASE("thread_pool from multiple threads", "[thread_pool]") {
+  ns::thread_pool pool(3);
+  std::atomic<int> failures = 0;
+  std::vector<std::thread> callers;
+  for (int k = 0; k < 4; ++k)
+    callers.emplace_back([&] {
+      for (int r = 0; r < 10; ++r)
+        if (not covers_once(pool, 5000, 32))
+          failures.fetch_add(1);
+    });
+  for (auto& c : callers)
+    c.join();
+  CHECK(failures.load() == 0);
+}
+
+TEST_CASE("parallel_for", "[thread_pool][parallel_for]") {
+  ns::thread_pool pool(4);
+  for (std::size_t n : {0u, 1u, 100u, 5000u, 100000u}) {
+    std::vector<std::uint32_t> v(n);
+    // (インデックス, 要素) を受け取り、要素に書き込む
+    ns::parallel_for(
+      pool,
+      ns::enumerate_view(v, std::uint32_t(3)),
+      [](std::uint32_t i, std::uint32_t& x) { x = i * 2; },
+      64);
+    std::vector<std::uint32_t> expected(n);
+    for (std::size_t i = 0; i < n; ++i)
+      expected[i] = static_cast<std::uint32_t>((i + 3) * 2);
+    CHECK(v == expected);
+  }
+
+  // 既定のプールと既定の grain
+  std::vector<int> w(100000, 1);
+  std::atomic<long> sum = 0;
+  ns::parallel_for(ns::enumerate_view(w), [&](std::size_t i, int x) {
+    sum.fetch_add(static_cast<long>(i) * x);
+  });
+  CHECK(sum.load() == 100000L * 99999 / 2);
+
+  // 連続していない範囲
+  std::deque<int> d(10000);
+  ns::parallel_for(
+    pool,
+    ns::enumerate_view(d),
+    [](std::size_t i, int& x) { x = static_cast<int>(i); },
+    16);
+  std::vector<int> iota(10000);
+  std::iota(iota.begin(), iota.end(), 0);
+  CHECK(std::ranges::equal(d, iota));
+}
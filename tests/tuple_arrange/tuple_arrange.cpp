@@ -4,7 +4,9 @@
 #include <algorithm>
 #include <chrono>
 #include <format>
+#include <iterator>
 #include <string>
+#include <string_view>
 
 TEST_CASE("valid_tuple", "[tuple_arrange][valid_tuple]") {
   STATIC_CHECK(ns::valid_tuple<std::tuple<int, double, std::string>>);
@@ -37,6 +39,40 @@ TEST_CASE("tuple_select", "[tuple_arrange][tuple_select]") {
   }
 }
 
+TEST_CASE("tuple_select_ref", "[tuple_arrange][tuple_select_ref]") {
+  {
+    std::tuple tpl{0, 3.14, std::string("Hello")};
+    {
+      auto ref = ns::tuple_select_ref<2, 0>(tpl);
+      STATIC_CHECK(
+        std::is_same_v<decltype(ref), std::tuple<std::string&, int&>>);
+      CHECK(&std::get<0>(ref) == &std::get<2>(tpl));
+      CHECK(&std::get<1>(ref) == &std::get<0>(tpl));
+      std::get<1>(ref) = 42;
+      CHECK(std::get<0>(tpl) == 42);
+    }
+    {
+      const auto& ctpl = tpl;
+      auto ref = ns::tuple_select_ref<1>(ctpl);
+      STATIC_CHECK(std::is_same_v<decltype(ref), std::tuple<const double&>>);
+      CHECK(&std::get<0>(ref) == &std::get<1>(tpl));
+    }
+    {
+      auto ref = ns::tuple_select_ref<2>(std::move(tpl));
+      STATIC_CHECK(std::is_same_v<decltype(ref), std::tuple<std::string&&>>);
+      std::string s = std::get<0>(std::move(ref));
+      CHECK(s == "Hello");
+    }
+  }
+  {
+    int i = 0;
+    std::tuple<int&, double> tpl{i, 3.14};
+    auto ref = ns::tuple_select_ref<0>(tpl);
+    STATIC_CHECK(std::is_same_v<decltype(ref), std::tuple<int&>>);
+    CHECK(&std::get<0>(ref) == &i);
+  }
+}
+
 TEST_CASE("tuple_element_index_v", "[tuple_arrange][tuple_element_index_v]") {
   using Tuple = std::tuple<int, double, std::string>;
   STATIC_CHECK(ns::tuple_element_index_v<int, Tuple> == 0);
@@ -65,9 +101,45 @@ TEST_CASE("tuple_select_by_type", "[tuple_arrange][tuple_select_by_type]") {
   }
 }
 
+TEST_CASE(
+  "tuple_select_ref_by_type", "[tuple_arrange][tuple_select_ref_by_type]") {
+  {
+    std::tuple tpl{0, 3.14, std::string("Hello")};
+    auto [s, x] = ns::tuple_select_ref_by_type<std::string, double>(tpl);
+    CHECK(&s == &std::get<2>(tpl));
+    CHECK(&x == &std::get<1>(tpl));
+    x = 2.71;
+    CHECK(std::get<1>(tpl) == Catch::Approx(2.71));
+  }
+}
+
 TEST_CASE("tuple_format", "[tuple_arrange][tuple_format]") {
   std::tuple tpl{0, 3.14, std::string("Hello")};
   CHECK(ns::tuple_format(tpl) == "(0, 3.14, Hello)");
+  CHECK(ns::tuple_format(std::tuple<>{}) == "()");
+  CHECK(ns::tuple_format(std::tuple{'a'}) == "(a)");
+}
+
+TEST_CASE("tuple_format_to", "[tuple_arrange][tuple_format_to]") {
+  std::tuple tpl{0, 3.14, std::string("Hello")};
+  {
+    std::string str("tpl = ");
+    ns::tuple_format_to(std::back_inserter(str), tpl);
+    CHECK(str == "tpl = (0, 3.14, Hello)");
+  }
+  {
+    char buf[32] = {};
+    char* last = ns::tuple_format_to(buf, tpl);
+    CHECK(std::string_view(buf, last) == "(0, 3.14, Hello)");
+  }
+}
+
+TEST_CASE("tuple_fmt", "[tuple_arrange][tuple_fmt]") {
+  std::tuple tpl{0, 3.14, std::string("Hello")};
+  CHECK(
+    std::format("tpl = {}!", ns::tuple_fmt(tpl)) == "tpl = (0, 3.14, Hello)!");
+  std::tuple nested{1, ns::tuple_fmt(tpl)};
+  CHECK(std::format("{}", ns::tuple_fmt(nested)) == "(1, (0, 3.14, Hello))");
 }
 
 std::string test_fn(int, const double&, std::string&&);
@@ -125,6 +197,64 @@ TEST_CASE("unordered_fn", "[tuple_arrange][unordered_fn]") {
   }
 }
 
+struct copy_counter {
+  int* copies;
+  copy_counter(int* c) : copies(c) {}
+  copy_counter(const copy_counter& other) : copies(other.copies) {
+    ++*copies;
+  }
+  copy_counter(copy_counter&&) = default;
+  copy_counter& operator=(const copy_counter&) = default;
+  copy_counter& operator=(copy_counter&&) = default;
+};
+
+int take_moved(std::string&& str, int n) {
+  std::string taken = std::move(str);
+  return static_cast<int>(taken.size()) + n;
+}
+
+TEST_CASE("unordered_fn forwarding", "[tuple_arrange][unordered_fn]") {
+  {
+    // Check that references are passed through without copies
+    std::string s("Hello");
+    const std::string* seen = nullptr;
+    auto fn = ns::unordered_fn([&](int, const std::string& str) {
+      seen = &str;
+      return str.size();
+    });
+    CHECK(fn(s, 0) == 5);
+    CHECK(seen == &s);
+  }
+  {
+    // Check that values are materialized only for by-value parameters
+    int copies = 0;
+    copy_counter c(&copies);
+    auto by_ref = ns::unordered_fn([](const copy_counter&, int i) { return i; });
+    CHECK(by_ref(0, c) == 0);
+    CHECK(copies == 0);
+    auto by_value = ns::unordered_fn([](copy_counter, int i) { return i; });
+    CHECK(by_value(1, c) == 1);
+    CHECK(copies == 1);
+    CHECK(by_value(2, std::move(c)) == 2);
+    CHECK(copies == 1);
+  }
+  {
+    // Check that rvalue reference parameters bind to the original argument
+    std::string s("Hello");
+    auto fn = ns::unordered_fn(
+      [p = &s](std::string&& str, int) { return &str == p; });
+    CHECK(fn(0, std::move(s)));
+  }
+  {
+    // Check that an lvalue passed to an rvalue reference parameter is copied
+    std::string s("Hello");
+    auto fn = ns::unordered_fn(&take_moved);
+    CHECK(fn(1, s) == 6);
+    CHECK(s == "Hello");
+    CHECK(fn(2, std::string("Hi")) == 4);
+  }
+}
+
 TEST_CASE("unordered_to_digit", "[tuple_arrange][unordered_to_digit]") {
   namespace chrono = std::chrono;
   constexpr auto to_digit =